@@ -0,0 +1,473 @@
+/* Copyright(c) 2018 Steven Hoving
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+// a fixed set of conversions that is timed and compared against a stored baseline, so a kernel
+// change that loses throughput fails the build instead of going unnoticed.
+//
+//   benchmark_regression <baseline.json> [--update] [--repetitions <n>] [--tolerance <fraction>]
+//       [--machine <name>] [google benchmark flags]
+//
+// Every benchmark runs repetitions times, the median pixels per second is compared against the
+// baseline of this machine. A benchmark fails when its median is slower than the baseline by more
+// than max(tolerance, 3 * cv), the coefficient of variation of the repetitions widens the threshold
+// on a noisy machine. --update stores the medians of this run as the baseline of this machine.
+//
+// exit codes: 0 passed, 1 slower than the baseline, 2 usage or file error, 77 no baseline for this
+// machine (reported as skipped by ctest).
+
+#include <benchmark/benchmark.h>
+#include <yuvconvert.h>
+#include <yuvconvert/yuvconvert_converter.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#ifdef __linux__
+#include <sched.h>
+#endif
+
+namespace
+{
+
+constexpr auto exit_passed = 0;
+constexpr auto exit_slower = 1;
+constexpr auto exit_error = 2;
+constexpr auto exit_skipped = 77;
+
+struct settings
+{
+    std::string baseline_path;
+    std::string machine;
+    bool update{false};
+    int repetitions{10};
+    double min_time{0.05};
+    double tolerance{0.05};
+};
+
+struct frame
+{
+    frame(const int width, const int height)
+        : width(width)
+        , height(height)
+        , source(static_cast<std::size_t>(width) * height * 4)
+        , yuv(static_cast<std::size_t>(width) * height * 2)
+    {
+        unsigned int seed = 1;
+        for (auto &value : source)
+        {
+            seed = seed * 1103515245u + 12345u;
+            value = static_cast<unsigned char>(seed >> 16);
+        }
+
+        const auto chroma_width = (width + 1) >> 1;
+        const auto chroma_size = static_cast<std::size_t>(chroma_width) * ((height + 1) >> 1);
+        planes[0] = yuv.data();
+        planes[1] = planes[0] + static_cast<std::size_t>(width) * height;
+        planes[2] = planes[1] + chroma_size;
+        stride[0] = width;
+        stride[1] = chroma_width;
+        stride[2] = chroma_width;
+    }
+
+    int width;
+    int height;
+    std::vector<unsigned char> source;
+    std::vector<unsigned char> yuv;
+    unsigned char *planes[3]{};
+    int stride[3]{};
+};
+
+// the pinned subset: the hot entry points on the common video sizes, one per kernel family.
+void register_benchmarks(const settings &config, std::map<std::string, double> &pixels)
+{
+    using yuvconvert::simd_mode;
+
+    struct entry
+    {
+        const char *name;
+        int width;
+        int height;
+        void (*convert)(frame &f);
+    };
+
+    static const entry entries[] = {
+        {"bgra_to_420/c", 1920, 1080,
+            [](frame &f) {
+                const unsigned char *src[3] = {f.source.data(), nullptr, nullptr};
+                const int src_stride[3] = {f.width * 4, 0, 0};
+                yuvconvert::bgra_to_420(f.planes, f.stride, src, f.width, f.height, src_stride, simd_mode::plain_c);
+            }},
+        {"bgra_to_420/ssse3", 1280, 720,
+            [](frame &f) {
+                const unsigned char *src[3] = {f.source.data(), nullptr, nullptr};
+                const int src_stride[3] = {f.width * 4, 0, 0};
+                yuvconvert::bgra_to_420(f.planes, f.stride, src, f.width, f.height, src_stride, simd_mode::ssse3);
+            }},
+        {"bgra_to_420/ssse3", 1920, 1080,
+            [](frame &f) {
+                const unsigned char *src[3] = {f.source.data(), nullptr, nullptr};
+                const int src_stride[3] = {f.width * 4, 0, 0};
+                yuvconvert::bgra_to_420(f.planes, f.stride, src, f.width, f.height, src_stride, simd_mode::ssse3);
+            }},
+        {"bgr_to_420/ssse3", 1920, 1080,
+            [](frame &f) {
+                const unsigned char *src[3] = {f.source.data(), nullptr, nullptr};
+                const int src_stride[3] = {f.width * 3, 0, 0};
+                yuvconvert::bgr_to_420(f.planes, f.stride, src, f.width, f.height, src_stride, simd_mode::ssse3);
+            }},
+        {"bgra_to_420_float/avx2", 1920, 1080,
+            [](frame &f) {
+                const unsigned char *src[3] = {f.source.data(), nullptr, nullptr};
+                const int src_stride[3] = {f.width * 4, 0, 0};
+                yuvconvert::bgra_to_420(f.planes, f.stride, src, f.width, f.height, src_stride, simd_mode::avx2,
+                    yuvconvert::conversion_precision::floating_point);
+            }},
+        {"bgra_to_y/ssse3", 1920, 1080,
+            [](frame &f) {
+                yuvconvert::bgra_to_y(f.planes[0], f.stride[0], f.source.data(), f.width * 4, f.width, f.height,
+                    simd_mode::ssse3);
+            }},
+        {"converter_specialized/ssse3", 1920, 1080,
+            [](frame &f) {
+                static const yuvconvert::converter converter(yuvconvert::pixel_format::bgra, f.width, f.height,
+                    yuvconvert::converter_config{simd_mode::ssse3, 0, 0});
+                converter.convert(f.planes, f.stride, f.source.data(), f.width * 4);
+            }},
+    };
+
+    for (const auto &item : entries)
+    {
+        const auto name = std::string(item.name) + "/" + std::to_string(item.width) + "x" + std::to_string(item.height);
+        pixels[name] = static_cast<double>(item.width) * item.height;
+
+        benchmark::RegisterBenchmark(name.c_str(), [&item](benchmark::State &state) {
+            frame f(item.width, item.height);
+            for (auto _ : state)
+            {
+                item.convert(f);
+                benchmark::DoNotOptimize(f.yuv.data());
+            }
+            state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(item.width) * item.height);
+        })
+            ->Repetitions(config.repetitions)
+            ->MinTime(config.min_time)
+            ->UseRealTime()
+            ->Unit(benchmark::kMillisecond);
+    }
+}
+
+struct measurement
+{
+    double median{0.0};
+    double cv{0.0};
+};
+
+// the repetitions are collected, only the aggregates (mean, median, stddev and cv) go to the console.
+class collecting_reporter : public benchmark::ConsoleReporter
+{
+public:
+    explicit collecting_reporter(const std::map<std::string, double> &pixels)
+        : ConsoleReporter(OO_None)
+        , pixels_(pixels)
+    {
+    }
+
+    void ReportRuns(const std::vector<Run> &reports) override
+    {
+        std::vector<Run> aggregates;
+        for (const auto &run : reports)
+        {
+            if (run.run_type == Run::RT_Aggregate)
+            {
+                aggregates.push_back(run);
+                continue;
+            }
+
+            const auto name = run.run_name.function_name;
+            const auto itr = pixels_.find(name);
+            if (itr != pixels_.end() && run.real_accumulated_time > 0.0)
+                samples_[name].push_back(itr->second * run.iterations / run.real_accumulated_time);
+        }
+
+        if (!aggregates.empty())
+            ConsoleReporter::ReportRuns(aggregates);
+    }
+
+    std::map<std::string, measurement> measurements() const
+    {
+        std::map<std::string, measurement> result;
+        for (auto [name, values] : samples_)
+        {
+            std::sort(values.begin(), values.end());
+            const auto count = values.size();
+            const auto median = (count & 1) ? values[count / 2] : (values[count / 2 - 1] + values[count / 2]) / 2.0;
+
+            double mean = 0.0;
+            for (const auto value : values)
+                mean += value;
+            mean /= count;
+
+            double variance = 0.0;
+            for (const auto value : values)
+                variance += (value - mean) * (value - mean);
+            variance /= (count > 1) ? count - 1 : 1;
+
+            result[name] = {median, mean > 0.0 ? std::sqrt(variance) / mean : 0.0};
+        }
+        return result;
+    }
+
+private:
+    const std::map<std::string, double> &pixels_;
+    std::map<std::string, std::vector<double>> samples_;
+};
+
+// the baseline holds one entry per machine:
+// {"machines": [{"cpu": "<model>", "benchmarks": [{"name": "<name>", "pixels_per_second": <n>}, ...]}, ...]}
+// It is written by --update. The reader walks the strings and numbers in order and only understands that layout.
+using baseline = std::map<std::string, std::map<std::string, double>>;
+
+bool read_baseline(const std::string &path, baseline &result)
+{
+    std::ifstream file(path);
+    if (!file)
+        return false;
+
+    std::stringstream buffer;
+    buffer << file.rdbuf();
+    const auto text = buffer.str();
+
+    std::string key;
+    std::string machine;
+    std::string name;
+    for (std::size_t i = 0; i < text.size(); ++i)
+    {
+        if (text[i] == '"')
+        {
+            std::string value;
+            for (++i; i < text.size() && text[i] != '"'; ++i)
+            {
+                if (text[i] == '\\' && i + 1 < text.size())
+                    ++i;
+                value += text[i];
+            }
+
+            // a string followed by a colon is a key, otherwise it is the value of the last key.
+            auto next = text.find_first_not_of(" \t\r\n", i + 1);
+            if (next != std::string::npos && text[next] == ':')
+                key = value;
+            else if (key == "cpu")
+                machine = value;
+            else if (key == "name")
+                name = value;
+        }
+        else if (key == "pixels_per_second" && (std::isdigit(static_cast<unsigned char>(text[i])) || text[i] == '-'))
+        {
+            char *end = nullptr;
+            result[machine][name] = std::strtod(text.c_str() + i, &end);
+            i = end - text.c_str() - 1;
+            key.clear();
+        }
+    }
+    return true;
+}
+
+std::string escape(const std::string &value)
+{
+    std::string result;
+    for (const auto c : value)
+    {
+        if (c == '"' || c == '\\')
+            result += '\\';
+        result += c;
+    }
+    return result;
+}
+
+bool write_baseline(const std::string &path, const baseline &machines)
+{
+    std::ofstream file(path);
+    if (!file)
+        return false;
+
+    file << "{\n    \"machines\": [";
+    auto first_machine = true;
+    for (const auto &[machine, benchmarks] : machines)
+    {
+        file << (first_machine ? "\n" : ",\n") << "        {\n            \"cpu\": \"" << escape(machine)
+             << "\",\n            \"benchmarks\": [";
+        auto first = true;
+        for (const auto &[name, pixels_per_second] : benchmarks)
+        {
+            char number[32];
+            std::snprintf(number, sizeof(number), "%.4g", pixels_per_second);
+            file << (first ? "\n" : ",\n") << "                {\"name\": \"" << escape(name)
+                 << "\", \"pixels_per_second\": " << number << "}";
+            first = false;
+        }
+        file << "\n            ]\n        }";
+        first_machine = false;
+    }
+    file << "\n    ]\n}\n";
+    return static_cast<bool>(file);
+}
+
+std::string cpu_model()
+{
+#ifdef __linux__
+    std::ifstream cpuinfo("/proc/cpuinfo");
+    std::string line;
+    while (std::getline(cpuinfo, line))
+    {
+        if (line.compare(0, 10, "model name") != 0)
+            continue;
+        const auto colon = line.find(':');
+        const auto start = line.find_first_not_of(' ', colon + 1);
+        if (colon != std::string::npos && start != std::string::npos)
+            return line.substr(start);
+    }
+#endif
+    return "unknown";
+}
+
+// keep the process on the core it started on, a migration in the middle of a repetition is the
+// largest source of noise on an otherwise idle machine.
+void pin_to_current_core()
+{
+#ifdef __linux__
+    const auto cpu = sched_getcpu();
+    if (cpu < 0)
+        return;
+
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    sched_setaffinity(0, sizeof(set), &set);
+#endif
+}
+
+bool parse_arguments(int &argc, char **argv, settings &config)
+{
+    // our own arguments are removed, the rest is left for google benchmark.
+    int kept = 1;
+    for (int i = 1; i < argc; ++i)
+    {
+        const std::string argument = argv[i];
+        const auto has_value = i + 1 < argc;
+        if (argument == "--update")
+            config.update = true;
+        else if (argument == "--repetitions" && has_value)
+            config.repetitions = std::max(2, std::atoi(argv[++i]));
+        else if (argument == "--tolerance" && has_value)
+            config.tolerance = std::atof(argv[++i]);
+        else if (argument == "--machine" && has_value)
+            config.machine = argv[++i];
+        else if (argument.compare(0, 2, "--") != 0 && config.baseline_path.empty())
+            config.baseline_path = argument;
+        else
+            argv[kept++] = argv[i];
+    }
+    argc = kept;
+
+    if (config.machine.empty())
+        config.machine = cpu_model();
+    return !config.baseline_path.empty();
+}
+
+} // namespace
+
+int main(int argc, char **argv)
+{
+    settings config;
+    if (!parse_arguments(argc, argv, config))
+    {
+        std::fprintf(stderr, "usage: benchmark_regression <baseline.json> [--update] [--repetitions <n>] "
+                             "[--tolerance <fraction>] [--machine <name>] [benchmark flags]\n");
+        return exit_error;
+    }
+
+    baseline machines;
+    const auto have_baseline = read_baseline(config.baseline_path, machines);
+    if (!config.update && (!have_baseline || machines.find(config.machine) == machines.end()))
+    {
+        std::printf("no baseline for \"%s\" in %s, run with --update to record one\n", config.machine.c_str(),
+            config.baseline_path.c_str());
+        return exit_skipped;
+    }
+
+    pin_to_current_core();
+
+    std::map<std::string, double> pixels;
+    register_benchmarks(config, pixels);
+    benchmark::Initialize(&argc, argv);
+
+    collecting_reporter reporter(pixels);
+    benchmark::RunSpecifiedBenchmarks(&reporter);
+    const auto measurements = reporter.measurements();
+
+    if (config.update)
+    {
+        auto &entries = machines[config.machine];
+        for (const auto &[name, result] : measurements)
+            entries[name] = result.median;
+
+        if (!write_baseline(config.baseline_path, machines))
+        {
+            std::fprintf(stderr, "can not write %s\n", config.baseline_path.c_str());
+            return exit_error;
+        }
+        std::printf("baseline for \"%s\" written to %s\n", config.machine.c_str(), config.baseline_path.c_str());
+        return exit_passed;
+    }
+
+    const auto &expected = machines[config.machine];
+    auto result = exit_passed;
+    std::printf("\n%-40s %12s %12s %8s %8s %10s\n", "benchmark", "base Mpx/s", "Mpx/s", "change", "cv",
+        "threshold");
+    for (const auto &[name, measured] : measurements)
+    {
+        const auto itr = expected.find(name);
+        if (itr == expected.end())
+        {
+            std::printf("%-40s %12s %12.1f %8s %7.1f%% %10s new\n", name.c_str(), "-", measured.median / 1e6, "-",
+                measured.cv * 100.0, "-");
+            continue;
+        }
+
+        const auto change = measured.median / itr->second - 1.0;
+        const auto threshold = std::max(config.tolerance, 3.0 * measured.cv);
+        const auto slower = change < -threshold;
+        if (slower)
+            result = exit_slower;
+
+        std::printf("%-40s %12.1f %12.1f %+7.1f%% %7.1f%% %9.1f%% %s\n", name.c_str(), itr->second / 1e6,
+            measured.median / 1e6, change * 100.0, measured.cv * 100.0, threshold * 100.0, slower ? "SLOWER" : "ok");
+    }
+    return result;
+}
@@ -0,0 +1,361 @@
+/* Copyright(c) 2018 Steven Hoving
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+// many concurrent streams instead of one conversion in a tight loop. N streams deliver frames at a
+// fixed rate and M threads convert them through the converter api, every frame records the time from
+// its arrival until its conversion is done.
+//
+//   benchmark_streams [--streams <n>] [--threads <m>] [--frames <per stream>] [--fps <n>]
+//       [--size <width>x<height>] [--pixel-format bgra|bgr] [--simd c|ssse3|avx2|portable]
+//       [--mode stream|band] [--scaling]
+//
+// stream mode: M threads each convert whole frames on their own (band height 0), every stream is
+// owned by one thread so its frames are converted in order, the streams run side by side. band
+// mode: one thread converts the frames one after another, every frame is split into M bands on the
+// library pool. With --fps 0 all frames are available at the start, the
+// latency is then the conversion time of a frame and the throughput is the capacity of the machine.
+// --scaling runs both modes unpaced from 1 thread up to all hardware threads and reports the
+// throughput and the scaling efficiency, throughput(m) / (m * throughput(1)).
+
+#include <yuvconvert.h>
+#include <yuvconvert/yuvconvert_converter.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace
+{
+
+using clock_type = std::chrono::steady_clock;
+
+enum class parallel_mode
+{
+    stream,
+    band
+};
+
+struct options
+{
+    int streams{16};
+    int threads{static_cast<int>(std::max(1u, std::thread::hardware_concurrency()))};
+    int frames{120};
+    double fps{30.0};
+    int width{1920};
+    int height{1080};
+    yuvconvert::pixel_format format{yuvconvert::pixel_format::bgra};
+    yuvconvert::simd_mode mode{yuvconvert::simd_mode::ssse3};
+    parallel_mode parallel{parallel_mode::stream};
+    bool scaling{false};
+};
+
+struct stream
+{
+    explicit stream(const options &settings)
+    {
+        const auto pixel_width = (settings.format == yuvconvert::pixel_format::bgra) ? 4 : 3;
+        const auto chroma_width = (settings.width + 1) >> 1;
+        const auto luma_size = static_cast<std::size_t>(settings.width) * settings.height;
+        const auto chroma_size = static_cast<std::size_t>(chroma_width) * ((settings.height + 1) >> 1);
+
+        source.resize(luma_size * pixel_width);
+        unsigned int seed = static_cast<unsigned int>(reinterpret_cast<std::uintptr_t>(this));
+        for (auto &value : source)
+        {
+            seed = seed * 1103515245u + 12345u;
+            value = static_cast<unsigned char>(seed >> 16);
+        }
+        src_stride = settings.width * pixel_width;
+
+        yuv.resize(luma_size + chroma_size * 2);
+        planes[0] = yuv.data();
+        planes[1] = planes[0] + luma_size;
+        planes[2] = planes[1] + chroma_size;
+        stride[0] = settings.width;
+        stride[1] = chroma_width;
+        stride[2] = chroma_width;
+    }
+
+    std::vector<unsigned char> source;
+    int src_stride{0};
+    std::vector<unsigned char> yuv;
+    unsigned char *planes[3]{};
+    int stride[3]{};
+};
+
+struct frame_job
+{
+    int stream;
+    clock_type::duration arrival;
+};
+
+struct run_result
+{
+    int threads{0}; // the threads that converted, at most one per stream in stream mode.
+    double seconds{0.0};
+    int frames{0};
+    std::vector<double> latency_ms;
+    int late{0};
+};
+
+// the frames of all streams in order of arrival. The streams are spread evenly over a frame
+// interval, so they do not all deliver at the same moment.
+std::vector<frame_job> schedule(const options &settings)
+{
+    std::vector<frame_job> jobs;
+    jobs.reserve(static_cast<std::size_t>(settings.streams) * settings.frames);
+
+    const auto interval = (settings.fps > 0.0) ? 1.0 / settings.fps : 0.0;
+    for (int frame = 0; frame < settings.frames; ++frame)
+    {
+        for (int index = 0; index < settings.streams; ++index)
+        {
+            const auto arrival = interval * (frame + static_cast<double>(index) / settings.streams);
+            jobs.push_back({index, std::chrono::duration_cast<clock_type::duration>(std::chrono::duration<double>(arrival))});
+        }
+    }
+    return jobs;
+}
+
+run_result run(const options &settings, std::vector<stream> &streams, const parallel_mode parallel, const int threads)
+{
+    // band mode splits a frame in as many bands as there are threads, the pool runs that many in parallel.
+    yuvconvert::converter_config config{settings.mode, 0, 0};
+    if (parallel == parallel_mode::band && threads > 1)
+        config.band_height = (((settings.height + threads - 1) / threads) + 1) & ~1;
+    const yuvconvert::converter converter(settings.format, settings.width, settings.height, config);
+
+    const auto jobs = schedule(settings);
+    const auto paced = settings.fps > 0.0;
+    const auto deadline = paced ? std::chrono::duration<double>(1.0 / settings.fps) : std::chrono::duration<double>(0.0);
+
+    run_result result;
+    result.frames = static_cast<int>(jobs.size());
+    result.latency_ms.resize(jobs.size());
+
+    // a stream belongs to one worker, so its frames are converted in order and never two at the same
+    // time into the same planes. Threads beyond the number of streams would have nothing to do.
+    const auto worker_count = (parallel == parallel_mode::stream) ? std::min(threads, settings.streams) : 1;
+
+    result.threads = (parallel == parallel_mode::stream) ? worker_count : threads;
+
+    std::atomic<int> late{0};
+    const auto start = clock_type::now();
+
+    const auto worker = [&](const int worker_index) {
+        for (int index = 0; index < result.frames; ++index)
+        {
+            const auto &job = jobs[index];
+            if (job.stream % worker_count != worker_index)
+                continue;
+
+            const auto arrival = start + job.arrival;
+            if (paced)
+                std::this_thread::sleep_until(arrival);
+
+            auto &item = streams[job.stream];
+            const auto begin = clock_type::now();
+            converter.convert(item.planes, item.stride, item.source.data(), item.src_stride);
+            const auto end = clock_type::now();
+
+            const auto latency = end - (paced ? arrival : begin);
+            result.latency_ms[index] = std::chrono::duration<double, std::milli>(latency).count();
+            if (paced && latency > deadline)
+                ++late;
+        }
+    };
+
+    std::vector<std::thread> workers;
+    for (int index = 1; index < worker_count; ++index)
+        workers.emplace_back(worker, index);
+    worker(0);
+    for (auto &thread : workers)
+        thread.join();
+
+    result.seconds = std::chrono::duration<double>(clock_type::now() - start).count();
+    result.late = late;
+    std::sort(result.latency_ms.begin(), result.latency_ms.end());
+    return result;
+}
+
+// nearest rank percentile of sorted values.
+double percentile(const std::vector<double> &sorted, const double fraction)
+{
+    if (sorted.empty())
+        return 0.0;
+    const auto rank = static_cast<std::size_t>(fraction * sorted.size() + 0.999999);
+    return sorted[std::min(sorted.size(), std::max<std::size_t>(rank, 1)) - 1];
+}
+
+const char *mode_name(const parallel_mode parallel)
+{
+    return (parallel == parallel_mode::stream) ? "stream" : "band";
+}
+
+void print_latency(const options &settings, const parallel_mode parallel, const run_result &result)
+{
+    const auto frame_rate = result.frames / result.seconds;
+    const auto pixel_rate = frame_rate * settings.width * settings.height / 1e6;
+    std::printf("%-7s %7d %7d %9.1f %9.1f %8.2f %8.2f %8.2f %8.2f %6d\n", mode_name(parallel), result.threads,
+        settings.streams, frame_rate, pixel_rate, percentile(result.latency_ms, 0.5),
+        percentile(result.latency_ms, 0.99), percentile(result.latency_ms, 0.999), result.latency_ms.back(),
+        result.late);
+}
+
+int to_int(const std::string &value)
+{
+    std::size_t used = 0;
+    const auto result = std::stoi(value, &used);
+    if (used != value.size() || result < 0)
+        throw std::runtime_error("not a number: " + value);
+    return result;
+}
+
+options parse_options(int argc, char **argv)
+{
+    options result;
+    for (int i = 1; i < argc; ++i)
+    {
+        const std::string name = argv[i];
+        if (name == "--scaling")
+        {
+            result.scaling = true;
+            continue;
+        }
+
+        if (i + 1 >= argc)
+            throw std::runtime_error("missing value for " + name);
+        const std::string value = argv[++i];
+
+        if (name == "--streams")
+            result.streams = std::max(1, to_int(value));
+        else if (name == "--threads")
+            result.threads = std::max(1, to_int(value));
+        else if (name == "--frames")
+            result.frames = std::max(1, to_int(value));
+        else if (name == "--fps")
+            result.fps = std::atof(value.c_str());
+        else if (name == "--size")
+        {
+            const auto separator = value.find('x');
+            if (separator == std::string::npos)
+                throw std::runtime_error("size has to be <width>x<height>");
+            result.width = std::max(2, to_int(value.substr(0, separator)));
+            result.height = std::max(2, to_int(value.substr(separator + 1)));
+        }
+        else if (name == "--pixel-format")
+        {
+            if (value != "bgra" && value != "bgr")
+                throw std::runtime_error("unknown pixel format: " + value);
+            result.format = (value == "bgra") ? yuvconvert::pixel_format::bgra : yuvconvert::pixel_format::bgr;
+        }
+        else if (name == "--simd")
+        {
+            if (value == "c")
+                result.mode = yuvconvert::simd_mode::plain_c;
+            else if (value == "ssse3")
+                result.mode = yuvconvert::simd_mode::ssse3;
+            else if (value == "avx2")
+                result.mode = yuvconvert::simd_mode::avx2;
+            else if (value == "portable")
+                result.mode = yuvconvert::simd_mode::portable;
+            else
+                throw std::runtime_error("unknown simd mode: " + value);
+        }
+        else if (name == "--mode")
+        {
+            if (value != "stream" && value != "band")
+                throw std::runtime_error("unknown mode: " + value);
+            result.parallel = (value == "stream") ? parallel_mode::stream : parallel_mode::band;
+        }
+        else
+            throw std::runtime_error("unknown option: " + name);
+    }
+    return result;
+}
+
+} // namespace
+
+int main(int argc, char **argv)
+{
+    options settings;
+    try
+    {
+        settings = parse_options(argc, argv);
+    }
+    catch (const std::exception &error)
+    {
+        std::fprintf(stderr, "benchmark_streams: %s\n", error.what());
+        return 2;
+    }
+
+    std::vector<stream> streams;
+    streams.reserve(settings.streams);
+    for (int index = 0; index < settings.streams; ++index)
+        streams.emplace_back(settings);
+
+    std::printf("%dx%d, %d frames per stream\n\n", settings.width, settings.height, settings.frames);
+
+    if (!settings.scaling)
+    {
+        std::printf("%-7s %7s %7s %9s %9s %8s %8s %8s %8s %6s\n", "mode", "threads", "streams", "frames/s", "Mpx/s",
+            "p50 ms", "p99 ms", "p99.9 ms", "max ms", "late");
+        print_latency(settings, settings.parallel, run(settings, streams, settings.parallel, settings.threads));
+        return 0;
+    }
+
+    // capacity, so every frame is available at the start.
+    auto unpaced = settings;
+    unpaced.fps = 0.0;
+
+    const auto hardware_threads = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+    std::vector<int> thread_counts;
+    for (int threads = 1; threads < hardware_threads; threads *= 2)
+        thread_counts.push_back(threads);
+    thread_counts.push_back(hardware_threads);
+
+    std::printf("%-7s %7s %9s %9s %10s %8s %8s\n", "mode", "threads", "frames/s", "Mpx/s", "efficiency", "p50 ms",
+        "p99 ms");
+    for (const auto parallel : {parallel_mode::stream, parallel_mode::band})
+    {
+        double single = 0.0;
+        for (const auto threads : thread_counts)
+        {
+            const auto result = run(unpaced, streams, parallel, threads);
+            const auto frame_rate = result.frames / result.seconds;
+            if (threads == 1)
+                single = frame_rate;
+
+            // stream mode runs at most one thread per stream, the efficiency is over the threads that ran.
+            std::printf("%-7s %7d %9.1f %9.1f %9.0f%% %8.2f %8.2f\n", mode_name(parallel), result.threads, frame_rate,
+                frame_rate * settings.width * settings.height / 1e6, 100.0 * frame_rate / (result.threads * single),
+                percentile(result.latency_ms, 0.5), percentile(result.latency_ms, 0.99));
+        }
+    }
+    return 0;
+}
@@ -19,6 +19,8 @@
  * SOFTWARE.
  */
 
+#include "perf_counters.h"
+
 #include <benchmark/benchmark.h>
 #include <yuvconvert.h>
 
@@ -54,6 +56,22 @@ public:
     {
     }
 
+    // time convert, and count it with the hardware counters where the system has them.
+    template <typename convert_function>
+    void run(benchmark::State& st, convert_function convert)
+    {
+        perf_counters counters;
+        counters.start();
+        for (auto _ : st) {
+            convert();
+        }
+        counters.stop();
+
+        const auto pixels = static_cast<double>(st.iterations()) * width * height;
+        st.SetItemsProcessed(st.iterations() * width * height);
+        counters.report(st, pixels);
+    }
+
 public:
     std::vector<unsigned char> rgb_buffer;
     unsigned char * source[3] = {};
@@ -69,9 +87,9 @@ public:
 
 BENCHMARK_DEFINE_F(bgrx_to_420_fixture, bgra_to_420)(benchmark::State& st)
 {
-    for (auto _ : st) {
+    run(st, [&] {
         yuvconvert::bgra_to_420(destination, destination_stride, source, width, height, source_stride);
-    }
+    });
 }
 
 BENCHMARK_REGISTER_F(bgrx_to_420_fixture, bgra_to_420)
@@ -82,12 +100,28 @@ BENCHMARK_REGISTER_F(bgrx_to_420_fixture, bgra_to_420)
     ->Args({ 2048, 2048})
     ->Args({ 4096, 4096});
 
+BENCHMARK_DEFINE_F(bgrx_to_420_fixture, bgra_to_420_portable)(benchmark::State& st)
+{
+    run(st, [&] {
+        yuvconvert::bgra_to_420(destination, destination_stride, source, width, height,
+            source_stride, yuvconvert::simd_mode::portable);
+    });
+}
+
+BENCHMARK_REGISTER_F(bgrx_to_420_fixture, bgra_to_420_portable)
+    ->Args({ 128, 128 })
+    ->Args({ 256, 256 })
+    ->Args({ 512, 512 })
+    ->Args({ 1024, 1024 })
+    ->Args({ 2048, 2048 })
+    ->Args({ 4096, 4096 });
+
 BENCHMARK_DEFINE_F(bgrx_to_420_fixture, bgra_to_420_ssse3)(benchmark::State& st)
 {
-    for (auto _ : st) {
+    run(st, [&] {
         yuvconvert::bgra_to_420(destination, destination_stride, source, width, height,
             source_stride, yuvconvert::simd_mode::ssse3);
-    }
+    });
 }
 
 BENCHMARK_REGISTER_F(bgrx_to_420_fixture, bgra_to_420_ssse3)
@@ -101,10 +135,10 @@ BENCHMARK_REGISTER_F(bgrx_to_420_fixture, bgra_to_420_ssse3)
 
 BENCHMARK_DEFINE_F(bgrx_to_420_fixture, bgr_to_420)(benchmark::State& st)
 {
-    for (auto _ : st) {
+    run(st, [&] {
         yuvconvert::bgr_to_420(destination, destination_stride, source, width, height,
             source_stride, yuvconvert::simd_mode::plain_c);
-    }
+    });
 }
 
 BENCHMARK_REGISTER_F(bgrx_to_420_fixture, bgr_to_420)
@@ -115,12 +149,28 @@ BENCHMARK_REGISTER_F(bgrx_to_420_fixture, bgr_to_420)
     ->Args({ 2048, 2048 })
     ->Args({ 4096, 4096 });
 
+BENCHMARK_DEFINE_F(bgrx_to_420_fixture, bgr_to_420_portable)(benchmark::State& st)
+{
+    run(st, [&] {
+        yuvconvert::bgr_to_420(destination, destination_stride, source, width, height,
+            source_stride, yuvconvert::simd_mode::portable);
+    });
+}
+
+BENCHMARK_REGISTER_F(bgrx_to_420_fixture, bgr_to_420_portable)
+    ->Args({ 128, 128 })
+    ->Args({ 256, 256 })
+    ->Args({ 512, 512 })
+    ->Args({ 1024, 1024 })
+    ->Args({ 2048, 2048 })
+    ->Args({ 4096, 4096 });
+
 BENCHMARK_DEFINE_F(bgrx_to_420_fixture, bgr_to_420_ssse3)(benchmark::State& st)
 {
-    for (auto _ : st) {
+    run(st, [&] {
         yuvconvert::bgr_to_420(destination, destination_stride, source, width, height,
             source_stride, yuvconvert::simd_mode::ssse3);
-    }
+    });
 }
 
 BENCHMARK_REGISTER_F(bgrx_to_420_fixture, bgr_to_420_ssse3)
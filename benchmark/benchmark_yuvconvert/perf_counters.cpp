@@ -0,0 +1,165 @@
+/* Copyright(c) 2018 Steven Hoving
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "perf_counters.h"
+
+#include <cstdio>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <cstdint>
+#include <cstring>
+#endif
+
+namespace
+{
+
+const char *const counter_names[perf_counters::counter_count] = {
+    "cycles/px", "instructions/px", "l1d_misses/px", "llc_misses/px", "frontend_stalls/px"};
+
+#ifdef __linux__
+
+struct event
+{
+    std::uint32_t type;
+    std::uint64_t config;
+};
+
+constexpr std::uint64_t l1d_read_miss = PERF_COUNT_HW_CACHE_L1D | (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+    (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+
+const event events[perf_counters::counter_count] = {
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES},
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS},
+    {PERF_TYPE_HW_CACHE, l1d_read_miss},
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES},
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_STALLED_CYCLES_FRONTEND}};
+
+int open_counter(const event &counter)
+{
+    perf_event_attr attr;
+    std::memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = counter.type;
+    attr.config = counter.config;
+    attr.disabled = 1;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+
+    // the counters are multiplexed when the cpu has fewer than we open, the enabled and running
+    // times scale the count back up.
+    attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+    return static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+}
+
+#endif
+
+} // namespace
+
+perf_counters::perf_counters()
+{
+    for (auto &fd : fd_)
+        fd = -1;
+
+#ifdef __linux__
+    for (int index = 0; index < counter_count; ++index)
+        fd_[index] = open_counter(events[index]);
+#endif
+
+    static bool warned = false;
+    if (!available() && !warned)
+    {
+        std::fprintf(stderr, "hardware performance counters are not available, only time is reported\n");
+        warned = true;
+    }
+}
+
+perf_counters::~perf_counters()
+{
+#ifdef __linux__
+    for (const auto fd : fd_)
+    {
+        if (fd >= 0)
+            close(fd);
+    }
+#endif
+}
+
+bool perf_counters::available() const noexcept
+{
+    for (const auto fd : fd_)
+    {
+        if (fd >= 0)
+            return true;
+    }
+    return false;
+}
+
+void perf_counters::start()
+{
+#ifdef __linux__
+    for (const auto fd : fd_)
+    {
+        if (fd < 0)
+            continue;
+        ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+        ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+    }
+#endif
+}
+
+void perf_counters::stop()
+{
+#ifdef __linux__
+    for (int index = 0; index < counter_count; ++index)
+    {
+        if (fd_[index] < 0)
+            continue;
+        ioctl(fd_[index], PERF_EVENT_IOC_DISABLE, 0);
+
+        // value, time enabled, time running.
+        std::uint64_t values[3] = {0, 0, 0};
+        if (read(fd_[index], values, sizeof(values)) != sizeof(values) || values[2] == 0)
+            continue;
+        value_[index] += static_cast<double>(values[0]) * values[1] / values[2];
+        counted_[index] = true;
+    }
+#endif
+}
+
+void perf_counters::report(benchmark::State &state, const double pixels) const
+{
+    if (pixels <= 0.0)
+        return;
+
+    for (int index = 0; index < counter_count; ++index)
+    {
+        if (counted_[index])
+            state.counters[counter_names[index]] = value_[index] / pixels;
+    }
+
+    if (counted_[cycles] && counted_[instructions] && value_[cycles] > 0.0)
+        state.counters["ipc"] = value_[instructions] / value_[cycles];
+}
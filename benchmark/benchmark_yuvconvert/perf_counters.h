@@ -0,0 +1,62 @@
+/* Copyright(c) 2018 Steven Hoving
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include <benchmark/benchmark.h>
+
+// hardware performance counters read through perf_event_open on linux. Every counter is opened on
+// its own, so a counter the cpu (or a virtual machine) does not have only drops that counter. On
+// other systems, or when perf_event_paranoid does not allow user space counting, nothing is opened
+// and report does nothing.
+class perf_counters
+{
+public:
+    enum counter
+    {
+        cycles,
+        instructions,
+        l1d_misses,
+        llc_misses,
+        frontend_stalls,
+        counter_count
+    };
+
+    perf_counters();
+    ~perf_counters();
+
+    perf_counters(const perf_counters &) = delete;
+    perf_counters &operator=(const perf_counters &) = delete;
+
+    bool available() const noexcept;
+
+    // count the calling thread between start and stop, the counts of every start / stop pair add up.
+    void start();
+    void stop();
+
+    // add the counts per pixel (and the instructions per cycle) to the counters of the benchmark.
+    void report(benchmark::State &state, double pixels) const;
+
+private:
+    int fd_[counter_count];
+    double value_[counter_count]{};
+    bool counted_[counter_count]{};
+};
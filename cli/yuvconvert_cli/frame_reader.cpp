@@ -0,0 +1,171 @@
+/* Copyright(c) 2018 Steven Hoving
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "frame_reader.h"
+
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+static std::runtime_error system_error(const std::string &what)
+{
+    return std::runtime_error(what + ": " + std::strerror(errno));
+}
+
+class input_file
+{
+public:
+    explicit input_file(const std::string &path)
+        : fd_(::open(path.c_str(), O_RDONLY))
+    {
+        if (fd_ < 0)
+            throw system_error("can not open " + path);
+    }
+
+    ~input_file()
+    {
+        ::close(fd_);
+    }
+
+    input_file(const input_file &) = delete;
+    input_file &operator=(const input_file &) = delete;
+
+    int get() const noexcept
+    {
+        return fd_;
+    }
+
+    std::size_t size() const
+    {
+        struct stat info;
+        if (::fstat(fd_, &info) != 0)
+            throw system_error("can not stat input");
+        return static_cast<std::size_t>(info.st_size);
+    }
+
+private:
+    int fd_;
+};
+
+class mmap_frame_reader : public frame_reader
+{
+public:
+    mmap_frame_reader(const std::string &path, std::size_t frame_size)
+        : file_(path)
+        , frame_size_(frame_size)
+        , size_(file_.size())
+    {
+        if (size_ < frame_size_)
+            return;
+
+        data_ = static_cast<unsigned char *>(::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, file_.get(), 0));
+        if (data_ == MAP_FAILED)
+            throw system_error("can not map " + path);
+
+        ::madvise(data_, size_, MADV_SEQUENTIAL);
+    }
+
+    ~mmap_frame_reader() override
+    {
+        if (data_ && data_ != MAP_FAILED)
+            ::munmap(data_, size_);
+    }
+
+    std::size_t frame_count() const noexcept override
+    {
+        return size_ / frame_size_;
+    }
+
+    const unsigned char *read(std::size_t index, int) override
+    {
+        // ask for the next frame while this one is converted.
+        const auto offset = index * frame_size_;
+        if (index + 1 < frame_count())
+        {
+            const auto page_size = static_cast<std::size_t>(::sysconf(_SC_PAGESIZE));
+            const auto next = (offset + frame_size_) & ~(page_size - 1);
+            ::madvise(data_ + next, offset + 2 * frame_size_ - next, MADV_WILLNEED);
+        }
+        return data_ + offset;
+    }
+
+private:
+    input_file file_;
+    std::size_t frame_size_;
+    std::size_t size_;
+    unsigned char *data_{nullptr};
+};
+
+class stream_frame_reader : public frame_reader
+{
+public:
+    stream_frame_reader(const std::string &path, std::size_t frame_size, int slot_count)
+        : file_(path)
+        , frame_size_(frame_size)
+        , size_(file_.size())
+        , slots_(slot_count, std::vector<unsigned char>(frame_size))
+    {
+        ::posix_fadvise(file_.get(), 0, 0, POSIX_FADV_SEQUENTIAL);
+    }
+
+    std::size_t frame_count() const noexcept override
+    {
+        return size_ / frame_size_;
+    }
+
+    const unsigned char *read(std::size_t, int slot) override
+    {
+        auto &buffer = slots_[slot];
+        std::size_t done = 0;
+        while (done < frame_size_)
+        {
+            const auto result = ::read(file_.get(), buffer.data() + done, frame_size_ - done);
+            if (result < 0 && errno == EINTR)
+                continue;
+            if (result < 0)
+                throw system_error("can not read input");
+            if (result == 0)
+                throw std::runtime_error("unexpected end of input");
+            done += static_cast<std::size_t>(result);
+        }
+        return buffer.data();
+    }
+
+private:
+    input_file file_;
+    std::size_t frame_size_;
+    std::size_t size_;
+    std::vector<std::vector<unsigned char>> slots_;
+};
+
+std::unique_ptr<frame_reader> open_frame_reader(const std::string &path, std::size_t frame_size, int slot_count,
+    read_mode mode)
+{
+    if (mode == read_mode::mmap)
+        return std::make_unique<mmap_frame_reader>(path, frame_size);
+    return std::make_unique<stream_frame_reader>(path, frame_size, slot_count);
+}
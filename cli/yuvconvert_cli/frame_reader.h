@@ -0,0 +1,49 @@
+/* Copyright(c) 2018 Steven Hoving
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <string>
+
+// reads fixed size frames from a raw file.
+class frame_reader
+{
+public:
+    virtual ~frame_reader() = default;
+
+    // the number of whole frames in the file.
+    virtual std::size_t frame_count() const noexcept = 0;
+
+    // the frame with this index, valid until the slot it was read into is read into again. Frames
+    // are read in order, slot is in [0, slot_count).
+    virtual const unsigned char *read(std::size_t index, int slot) = 0;
+};
+
+enum class read_mode
+{
+    mmap,  // map the whole file, frames point straight into the mapping.
+    stream // read() every frame into one of the slots, with the kernel read ahead enabled.
+};
+
+std::unique_ptr<frame_reader> open_frame_reader(const std::string &path, std::size_t frame_size, int slot_count,
+    read_mode mode);
@@ -0,0 +1,84 @@
+/* Copyright(c) 2018 Steven Hoving
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "frame_writer.h"
+
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+
+#include <fcntl.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+static void write_all(int fd, iovec *parts, int count)
+{
+    while (count > 0)
+    {
+        auto result = ::writev(fd, parts, count);
+        if (result < 0 && errno == EINTR)
+            continue;
+        if (result < 0)
+            throw std::runtime_error(std::string("can not write output: ") + std::strerror(errno));
+
+        // skip what was written, a short write can end halfway a part.
+        while (count > 0 && static_cast<std::size_t>(result) >= parts->iov_len)
+        {
+            result -= static_cast<ssize_t>(parts->iov_len);
+            ++parts;
+            --count;
+        }
+
+        if (count > 0)
+        {
+            parts->iov_base = static_cast<char *>(parts->iov_base) + result;
+            parts->iov_len -= static_cast<std::size_t>(result);
+        }
+    }
+}
+
+frame_writer::frame_writer(const std::string &path)
+    : fd_(STDOUT_FILENO)
+    , owns_fd_(path != "-")
+{
+    if (owns_fd_)
+    {
+        fd_ = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        if (fd_ < 0)
+            throw std::runtime_error("can not create " + path + ": " + std::strerror(errno));
+    }
+}
+
+frame_writer::~frame_writer()
+{
+    if (owns_fd_)
+        ::close(fd_);
+}
+
+void frame_writer::write(const unsigned char *const planes[], const std::size_t plane_sizes[], int plane_count)
+{
+    iovec parts[3];
+    int count = 0;
+    for (int i = 0; i < plane_count && count < 3; ++i)
+        parts[count++] = {const_cast<unsigned char *>(planes[i]), plane_sizes[i]};
+
+    write_all(fd_, parts, count);
+}
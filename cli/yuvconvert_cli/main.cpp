@@ -0,0 +1,432 @@
+/* Copyright(c) 2018 Steven Hoving
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "blocking_queue.h"
+#include "frame_reader.h"
+#include "frame_writer.h"
+
+#include <yuvconvert.h>
+#include <yuvconvert/yuvconvert_converter.h>
+#include <yuvconvert/yuvconvert_y4m.h>
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+// converts a raw bgra or bgr file frame by frame. Reading, converting and writing run as three
+// pipeline stages on their own threads, with a few frames in flight between them. The conversion
+// itself is split in bands over the library thread pool.
+
+struct options
+{
+    std::string input;
+    std::string output;
+    int width{0};
+    int height{0};
+    yuvconvert::pixel_format pixel_format{yuvconvert::pixel_format::bgra};
+    output_format format{output_format::i420};
+    bool format_given{false};
+    int fps{30};
+    read_mode read{read_mode::mmap};
+    yuvconvert::converter_config config{yuvconvert::simd_mode::ssse3, 64, 0};
+    std::string autotune_cache;
+    std::size_t max_frames{0};
+    int slots{4};
+};
+
+static void print_usage()
+{
+    std::fprintf(stderr,
+        "usage: yuvconvert -i <input> -o <output> -s <width>x<height> [options]\n"
+        "  -i <path>                     raw bgra or bgr input\n"
+        "  -o <path>                     output file, - for stdout\n"
+        "  -s <width>x<height>           frame size\n"
+        "  --pixel-format bgra|bgr       input pixel format (bgra)\n"
+        "  --output-format i420|nv12|y4m output format (y4m for a .y4m output, i420 otherwise)\n"
+        "  --fps <n>                     frame rate written to the y4m header (30)\n"
+        "  --read mmap|stream            map the input, or read it frame by frame (mmap)\n"
+        "  --simd c|portable|ssse3|avx2  conversion kernels (ssse3)\n"
+        "  --band-height <n>             rows per thread pool band, 0 for a single thread (64)\n"
+        "  --tile-width <n>              column tile width, 0 for full rows (0)\n"
+        "  --precision fixed|float       fixed point, or the exact matrix for reference output (fixed)\n"
+        "  --interlaced                  top field first input, chroma is converted per field\n"
+        "  --autotune <cache>            tune the kernels and bands, cached in this file\n"
+        "  --frames <n>                  convert at most n frames\n"
+        "  --slots <n>                   frames in flight between the stages (4)\n");
+}
+
+static bool ends_with(const std::string &value, const std::string &suffix)
+{
+    return value.size() >= suffix.size() && value.compare(value.size() - suffix.size(), suffix.size(), suffix) == 0;
+}
+
+static int parse_int(const std::string &value, const char *name)
+{
+    char *end = nullptr;
+    const auto result = std::strtol(value.c_str(), &end, 10);
+    if (end == value.c_str() || *end != '\0' || result < 0)
+        throw std::runtime_error(std::string("invalid ") + name + ": " + value);
+    return static_cast<int>(result);
+}
+
+static options parse_options(int argc, char *argv[])
+{
+    options result;
+    for (int i = 1; i < argc; ++i)
+    {
+        const std::string name = argv[i];
+
+        // the only option without a value.
+        if (name == "--interlaced")
+        {
+            result.config.interlaced = true;
+            continue;
+        }
+
+        if (i + 1 >= argc)
+            throw std::runtime_error("missing value for " + name);
+        const std::string value = argv[++i];
+
+        if (name == "-i")
+            result.input = value;
+        else if (name == "-o")
+            result.output = value;
+        else if (name == "-s")
+        {
+            const auto separator = value.find('x');
+            if (separator == std::string::npos)
+                throw std::runtime_error("invalid size: " + value);
+            result.width = parse_int(value.substr(0, separator), "width");
+            result.height = parse_int(value.substr(separator + 1), "height");
+        }
+        else if (name == "--pixel-format")
+        {
+            if (value != "bgra" && value != "bgr")
+                throw std::runtime_error("unknown pixel format: " + value);
+            result.pixel_format = (value == "bgra") ? yuvconvert::pixel_format::bgra : yuvconvert::pixel_format::bgr;
+        }
+        else if (name == "--output-format")
+        {
+            if (value == "i420")
+                result.format = output_format::i420;
+            else if (value == "nv12")
+                result.format = output_format::nv12;
+            else if (value == "y4m")
+                result.format = output_format::y4m;
+            else
+                throw std::runtime_error("unknown output format: " + value);
+            result.format_given = true;
+        }
+        else if (name == "--fps")
+            result.fps = parse_int(value, "frame rate");
+        else if (name == "--read")
+        {
+            if (value != "mmap" && value != "stream")
+                throw std::runtime_error("unknown read mode: " + value);
+            result.read = (value == "mmap") ? read_mode::mmap : read_mode::stream;
+        }
+        else if (name == "--simd")
+        {
+            if (value == "c")
+                result.config.mode = yuvconvert::simd_mode::plain_c;
+            else if (value == "portable")
+                result.config.mode = yuvconvert::simd_mode::portable;
+            else if (value == "ssse3")
+                result.config.mode = yuvconvert::simd_mode::ssse3;
+            else if (value == "avx2")
+                result.config.mode = yuvconvert::simd_mode::avx2;
+            else
+                throw std::runtime_error("unknown simd mode: " + value);
+        }
+        else if (name == "--band-height")
+            result.config.band_height = parse_int(value, "band height");
+        else if (name == "--tile-width")
+            result.config.tile_width = parse_int(value, "tile width");
+        else if (name == "--precision")
+        {
+            if (value != "fixed" && value != "float")
+                throw std::runtime_error("unknown precision: " + value);
+            result.config.precision = (value == "fixed") ? yuvconvert::conversion_precision::fixed_point
+                                                         : yuvconvert::conversion_precision::floating_point;
+        }
+        else if (name == "--autotune")
+            result.autotune_cache = value;
+        else if (name == "--frames")
+            result.max_frames = static_cast<std::size_t>(parse_int(value, "frame count"));
+        else if (name == "--slots")
+            result.slots = std::max(1, parse_int(value, "slot count"));
+        else
+            throw std::runtime_error("unknown option: " + name);
+    }
+
+    if (result.input.empty() || result.output.empty() || result.width <= 0 || result.height <= 0)
+        throw std::runtime_error("input, output and size are required");
+
+    if (!result.format_given && ends_with(result.output, ".y4m"))
+        result.format = output_format::y4m;
+
+    return result;
+}
+
+// an i420 frame with its planes back to back. An nv12 frame uses the same buffer, with the
+// interleaved chroma where the u plane would be, and keeps the u and v planes the converter writes
+// to in scratch.
+struct output_slot
+{
+    explicit output_slot(const options &settings)
+    {
+        const auto chroma_width = (settings.width + 1) >> 1;
+        const auto chroma_height = (settings.height + 1) >> 1;
+        const auto luma_size = static_cast<std::size_t>(settings.width) * settings.height;
+        const auto chroma_size = static_cast<std::size_t>(chroma_width) * chroma_height;
+
+        buffer.resize(luma_size + chroma_size * 2);
+        stride[0] = settings.width;
+        stride[1] = chroma_width;
+        stride[2] = chroma_width;
+        planes[0] = buffer.data();
+
+        if (settings.format == output_format::nv12)
+        {
+            scratch.resize(chroma_size * 2);
+            planes[1] = scratch.data();
+            planes[2] = scratch.data() + chroma_size;
+            output[0] = buffer.data();
+            output[1] = buffer.data() + luma_size;
+            output_size[0] = luma_size;
+            output_size[1] = chroma_size * 2;
+            output_count = 2;
+        }
+        else
+        {
+            planes[1] = buffer.data() + luma_size;
+            planes[2] = planes[1] + chroma_size;
+            output[0] = buffer.data();
+            output_size[0] = buffer.size();
+            output_count = 1;
+        }
+    }
+
+    void interleave_chroma(const int width, const int height, yuvconvert::simd_mode mode)
+    {
+        if (output_count != 2)
+            return;
+
+        // the luma is already in place, only the chroma is interleaved.
+        unsigned char *nv12[2] = {planes[0], buffer.data() + output_size[0]};
+        const int nv12_stride[2] = {stride[0], stride[1] * 2};
+        yuvconvert::i420_to_nv12(nv12, nv12_stride, planes, stride, width, height, mode);
+    }
+
+    std::vector<unsigned char> buffer;
+    std::vector<unsigned char> scratch;
+    unsigned char *planes[3]{nullptr, nullptr, nullptr};
+    int stride[3]{0, 0, 0};
+
+    const unsigned char *output[3]{nullptr, nullptr, nullptr};
+    std::size_t output_size[3]{0, 0, 0};
+    int output_count{0};
+};
+
+struct source_item
+{
+    std::size_t index;
+    const unsigned char *data;
+    int slot;
+};
+
+struct output_item
+{
+    std::size_t index;
+    int slot;
+};
+
+// the first error of any stage, it stops all of them.
+class pipeline_error
+{
+public:
+    template <typename... Queues>
+    void set(std::exception_ptr error, Queues &...queues)
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (!error_)
+                error_ = error;
+        }
+        (queues.close(), ...);
+    }
+
+    void rethrow()
+    {
+        if (error_)
+            std::rethrow_exception(error_);
+    }
+
+private:
+    std::mutex mutex_;
+    std::exception_ptr error_;
+};
+
+static int run(const options &settings)
+{
+    const auto pixel_width = (settings.pixel_format == yuvconvert::pixel_format::bgra) ? 4 : 3;
+    const auto src_stride = settings.width * pixel_width;
+    const auto frame_size = static_cast<std::size_t>(src_stride) * settings.height;
+
+    auto config = settings.config;
+    if (!settings.autotune_cache.empty())
+    {
+        // the tuning is done on the fixed point kernels, the precision is not a tuning parameter.
+        config = yuvconvert::autotune(settings.pixel_format, settings.width, settings.height, settings.autotune_cache);
+        config.precision = settings.config.precision;
+        config.interlaced = settings.config.interlaced;
+    }
+    const yuvconvert::converter converter(settings.pixel_format, settings.width, settings.height, config);
+
+    auto reader = open_frame_reader(settings.input, frame_size, settings.slots, settings.read);
+    auto frame_count = reader->frame_count();
+    if (settings.max_frames != 0)
+        frame_count = std::min(frame_count, settings.max_frames);
+
+    std::unique_ptr<frame_writer> writer;
+    std::unique_ptr<yuvconvert::y4m_writer> y4m_writer;
+    if (settings.format == output_format::y4m)
+    {
+        yuvconvert::y4m_header header;
+        header.width = settings.width;
+        header.height = settings.height;
+        header.fps_numerator = settings.fps;
+        header.interlace = settings.config.interlaced ? 't' : 'p';
+        y4m_writer = std::make_unique<yuvconvert::y4m_writer>(settings.output, header);
+    }
+    else
+    {
+        writer = std::make_unique<frame_writer>(settings.output);
+    }
+    // the slots point into their own buffers, so they are constructed in place and never copied.
+    std::vector<output_slot> outputs;
+    outputs.reserve(settings.slots);
+    for (int i = 0; i < settings.slots; ++i)
+        outputs.emplace_back(settings);
+
+    blocking_queue<int> free_sources;
+    blocking_queue<int> free_outputs;
+    blocking_queue<source_item> to_convert;
+    blocking_queue<output_item> to_write;
+    for (int i = 0; i < settings.slots; ++i)
+    {
+        free_sources.push(i);
+        free_outputs.push(i);
+    }
+
+    pipeline_error error;
+    const auto start = std::chrono::steady_clock::now();
+
+    std::thread read_stage([&] {
+        try
+        {
+            for (std::size_t index = 0; index < frame_count; ++index)
+            {
+                const auto slot = free_sources.pop();
+                if (!slot)
+                    break;
+                to_convert.push({index, reader->read(index, *slot), *slot});
+            }
+        }
+        catch (...)
+        {
+            error.set(std::current_exception(), free_sources, free_outputs, to_convert, to_write);
+        }
+        to_convert.close();
+    });
+
+    std::thread write_stage([&] {
+        try
+        {
+            while (const auto item = to_write.pop())
+            {
+                const auto &output = outputs[item->slot];
+                if (y4m_writer)
+                    y4m_writer->write(output.planes, output.stride);
+                else
+                    writer->write(output.output, output.output_size, output.output_count);
+                free_outputs.push(item->slot);
+            }
+        }
+        catch (...)
+        {
+            error.set(std::current_exception(), free_sources, free_outputs, to_convert, to_write);
+        }
+    });
+
+    // the conversion stage runs on this thread, the bands of a frame go to the library pool.
+    std::size_t converted = 0;
+    while (const auto item = to_convert.pop())
+    {
+        const auto slot = free_outputs.pop();
+        if (!slot)
+            break;
+
+        auto &output = outputs[*slot];
+        converter.convert(output.planes, output.stride, item->data, src_stride);
+        output.interleave_chroma(settings.width, settings.height, settings.config.mode);
+        free_sources.push(item->slot);
+        to_write.push({item->index, *slot});
+        ++converted;
+    }
+    to_write.close();
+
+    read_stage.join();
+    write_stage.join();
+    error.rethrow();
+
+    const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    const auto seconds = std::max(elapsed.count(), 1e-9);
+    std::fprintf(stderr, "%zu frames in %.3f s, %.1f fps, %.1f MB/s input\n", converted, seconds,
+        converted / seconds, converted * frame_size / seconds / 1e6);
+    return 0;
+}
+
+int main(int argc, char *argv[])
+{
+    if (argc < 2)
+    {
+        print_usage();
+        return 1;
+    }
+
+    try
+    {
+        return run(parse_options(argc, argv));
+    }
+    catch (const std::exception &e)
+    {
+        std::fprintf(stderr, "yuvconvert: %s\n", e.what());
+        return 1;
+    }
+}
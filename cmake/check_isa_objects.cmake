@@ -0,0 +1,41 @@
+# Copyright(c) 2018 Steven Hoving
+#
+# Permission is hereby granted, free of charge, to any person obtaining a copy
+# of this software and associated documentation files(the "Software"), to deal
+# in the Software without restriction, including without limitation the rights
+# to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+# copies of the Software, and to permit persons to whom the Software is
+# furnished to do so, subject to the following conditions :
+#
+# The above copyright notice and this permission notice shall be included in all
+# copies or substantial portions of the Software.
+#
+# THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+# IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+# FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+# AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+# LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+# OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+# SOFTWARE.
+
+# fails when one of the objects in OBJECTS ("|" separated) has a static initializer or a weak definition,
+# NM is the nm of the toolchain. Used for the isa object libraries, which are linked into every binary:
+# - a dynamic initializer built with their code generation flags would run at startup, before the cpu check.
+# - a weak definition (an inline function or template instantiated in the object) may be the copy the
+#   linker keeps for every caller, including the c path.
+
+string(REPLACE "|" ";" objects "${OBJECTS}")
+foreach (object ${objects})
+    execute_process(COMMAND ${NM} ${object} OUTPUT_VARIABLE symbols RESULT_VARIABLE result)
+    if (NOT result EQUAL 0)
+        message(FATAL_ERROR "${NM} failed on ${object}")
+    endif ()
+    if (symbols MATCHES "_GLOBAL__sub_I")
+        message(FATAL_ERROR "${object} has a static initializer, build its simd constants inside the kernels")
+    endif ()
+    string(REGEX MATCHALL "[^\n]* [VWu] [^\n]*" weak_symbols "${symbols}")
+    if (weak_symbols)
+        string(REPLACE ";" "\n" weak_symbols "${weak_symbols}")
+        message(FATAL_ERROR "${object} has weak definitions, keep the helpers of the kernels local to the translation unit:\n${weak_symbols}")
+    endif ()
+endforeach ()
@@ -0,0 +1,262 @@
+/* Copyright(c) 2018 Steven Hoving
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <yuvconvert.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iterator>
+#include <vector>
+
+// libFuzzer target for the public conversion entry points. The input picks the geometry, the
+// strides, the pixel format, the output format and the simd mode, the rest of the input is the
+// image. Every plane lives in its own exactly sized allocation so the sanitizers catch any read or
+// write past the last visible pixel, and the result is compared against the plain c path.
+
+namespace
+{
+
+constexpr auto max_width = 320;
+constexpr auto max_height = 64;
+constexpr auto padding_canary = 0xa5;
+
+// the simd modes the input selects from.
+constexpr yuvconvert::simd_mode simd_modes[] = {yuvconvert::simd_mode::plain_c, yuvconvert::simd_mode::ssse3,
+    yuvconvert::simd_mode::avx2, yuvconvert::simd_mode::portable};
+
+enum class output_format
+{
+    i420,
+    i422,
+    i444,
+    yuy2,
+    uyvy,
+    count
+};
+
+using convert_function = void(unsigned char *destination[3], const int dst_stride[3],
+    const unsigned char *const source[3], const int width, const int height, const int src_stride[3],
+    yuvconvert::simd_mode mode);
+
+class input_reader
+{
+public:
+    input_reader(const uint8_t *data, size_t size)
+        : data_(data)
+        , size_(size)
+    {
+    }
+
+    auto next() -> int
+    {
+        if (size_ == 0)
+            return 0;
+        --size_;
+        return *data_++;
+    }
+
+    auto next16() -> int
+    {
+        const auto lo = next();
+        return lo | (next() << 8);
+    }
+
+    auto remaining() const -> const uint8_t *
+    {
+        return data_;
+    }
+
+    auto remaining_size() const -> size_t
+    {
+        return size_;
+    }
+
+private:
+    const uint8_t *data_;
+    size_t size_;
+};
+
+// a plane of rows that are row_bytes wide, stride apart. The allocation ends right after the last
+// visible byte so nothing may be touched past it.
+struct plane
+{
+    plane() = default;
+
+    plane(int row_bytes, int rows, int padding)
+        : row_bytes(row_bytes)
+        , rows(rows)
+        , stride(row_bytes + padding)
+        , buffer(static_cast<size_t>(stride) * (rows - 1) + row_bytes, padding_canary)
+    {
+    }
+
+    auto padding_untouched() const -> bool
+    {
+        for (int row = 0; row + 1 < rows; ++row)
+        {
+            const auto begin = buffer.begin() + static_cast<ptrdiff_t>(row) * stride + row_bytes;
+            if (std::any_of(begin, begin + (stride - row_bytes), [](auto value) { return value != padding_canary; }))
+                return false;
+        }
+        return true;
+    }
+
+    int row_bytes = 0;
+    int rows = 0;
+    int stride = 0;
+    std::vector<unsigned char> buffer;
+};
+
+struct output_frame
+{
+    output_frame(output_format format, int width, int height, const int padding[3])
+    {
+        const auto half_width = (width + 1) >> 1;
+        const auto half_height = (height + 1) >> 1;
+
+        switch (format)
+        {
+        case output_format::yuy2:
+        case output_format::uyvy:
+            planes[0] = plane(half_width * 4, height, padding[0]);
+            return;
+        case output_format::i420:
+            planes[1] = plane(half_width, half_height, padding[1]);
+            planes[2] = plane(half_width, half_height, padding[2]);
+            break;
+        case output_format::i422:
+            planes[1] = plane(half_width, height, padding[1]);
+            planes[2] = plane(half_width, height, padding[2]);
+            break;
+        default:
+            planes[1] = plane(width, height, padding[1]);
+            planes[2] = plane(width, height, padding[2]);
+            break;
+        }
+        planes[0] = plane(width, height, padding[0]);
+    }
+
+    void bind(unsigned char *destination[3], int dst_stride[3])
+    {
+        for (int i = 0; i < 3; ++i)
+        {
+            destination[i] = planes[i].buffer.empty() ? nullptr : planes[i].buffer.data();
+            dst_stride[i] = planes[i].stride;
+        }
+    }
+
+    plane planes[3];
+};
+
+auto get_convert_function(output_format format, yuvconvert::pixel_format pixel) -> convert_function *
+{
+    const auto bgra = pixel == yuvconvert::pixel_format::bgra;
+    switch (format)
+    {
+    case output_format::i420:
+        // bgrx_to_420 is overloaded, the cast picks the one taking a simd mode.
+        return bgra ? static_cast<convert_function *>(yuvconvert::bgra_to_420)
+                    : static_cast<convert_function *>(yuvconvert::bgr_to_420);
+    case output_format::i422:
+        return bgra ? yuvconvert::bgra_to_422 : yuvconvert::bgr_to_422;
+    case output_format::i444:
+        return bgra ? yuvconvert::bgra_to_444 : yuvconvert::bgr_to_444;
+    case output_format::yuy2:
+        return bgra ? yuvconvert::bgra_to_yuy2 : yuvconvert::bgr_to_yuy2;
+    default:
+        return bgra ? yuvconvert::bgra_to_uyvy : yuvconvert::bgr_to_uyvy;
+    }
+}
+
+[[noreturn]] void report_failure(const char *what, output_format format, yuvconvert::pixel_format pixel,
+    yuvconvert::simd_mode mode, int width, int height)
+{
+    std::fprintf(stderr, "%s: output format %d, pixel format %d, simd mode %d, %dx%d\n", what,
+        static_cast<int>(format), static_cast<int>(pixel), static_cast<int>(mode), width, height);
+    std::abort();
+}
+
+} // namespace
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size)
+{
+    input_reader input(data, size);
+
+    const auto selection = input.next();
+    const auto pixel = (selection & 1) ? yuvconvert::pixel_format::bgra : yuvconvert::pixel_format::bgr;
+    const auto flip = (selection & 2) != 0;
+    const auto mode = simd_modes[((selection >> 2) & 3) % std::size(simd_modes)];
+    const auto format = static_cast<output_format>((selection >> 4) % static_cast<int>(output_format::count));
+
+    const auto width = 1 + input.next16() % max_width;
+    const auto height = 1 + input.next() % max_height;
+    const auto src_padding = input.next() & 63;
+    const int dst_padding[3] = {input.next() & 31, input.next() & 31, input.next() & 31};
+
+    const auto pixel_width = (pixel == yuvconvert::pixel_format::bgra) ? 4 : 3;
+    plane source(width * pixel_width, height, src_padding);
+
+    // the image is whatever is left of the input, repeated to fill the frame.
+    if (input.remaining_size() != 0)
+    {
+        for (size_t i = 0; i < source.buffer.size(); ++i)
+            source.buffer[i] = input.remaining()[i % input.remaining_size()];
+    }
+
+    // a flipped source starts at its last row and walks up with a negative stride.
+    const unsigned char *source_planes[3] = {source.buffer.data(), nullptr, nullptr};
+    int src_stride[3] = {source.stride, 0, 0};
+    if (flip)
+    {
+        source_planes[0] += static_cast<ptrdiff_t>(source.stride) * (height - 1);
+        src_stride[0] = -source.stride;
+    }
+
+    const auto convert = get_convert_function(format, pixel);
+
+    output_frame reference(format, width, height, dst_padding);
+    unsigned char *reference_planes[3];
+    int reference_stride[3];
+    reference.bind(reference_planes, reference_stride);
+    convert(reference_planes, reference_stride, source_planes, width, height, src_stride,
+        yuvconvert::simd_mode::plain_c);
+
+    output_frame result(format, width, height, dst_padding);
+    unsigned char *result_planes[3];
+    int result_stride[3];
+    result.bind(result_planes, result_stride);
+    convert(result_planes, result_stride, source_planes, width, height, src_stride, mode);
+
+    for (int i = 0; i < 3; ++i)
+    {
+        if (!reference.planes[i].padding_untouched() || !result.planes[i].padding_untouched())
+            report_failure("stride padding was written", format, pixel, mode, width, height);
+
+        if (reference.planes[i].buffer != result.planes[i].buffer)
+            report_failure("result differs from the c path", format, pixel, mode, width, height);
+    }
+
+    return 0;
+}
@@ -32,7 +32,22 @@ namespace yuvconvert
     enum class simd_mode
     {
         plain_c,
-        ssse3
+        ssse3,
+        avx2, // falls back to ssse3 where there is no avx2 kernel, or when the cpu lacks avx2.
+        portable // compiler vector extensions, for any target. Falls back to plain_c where there is no
+                 // portable kernel. ssse3 and avx2 fall back to portable off x86.
+    };
+
+    enum class pixel_format
+    {
+        bgr,
+        bgra
+    };
+
+    enum class conversion_precision
+    {
+        fixed_point, // 8 bit coefficients, the fastest.
+        floating_point // the exact bt.601 matrix, every sample is rounded to nearest. For reference output.
     };
 
     void bgr_to_420(unsigned char *destination[3], const int dst_stride[3], const unsigned char *const source[3],
@@ -40,4 +55,166 @@ namespace yuvconvert
 
     void bgra_to_420(unsigned char *destination[3], const int dst_stride[3], const unsigned char *const source[3],
         const int width, const int height, const int src_stride[3], simd_mode mode);
+
+    void bgr_to_420(unsigned char *destination[3], const int dst_stride[3], const unsigned char *const source[3],
+        const int width, const int height, const int src_stride[3], simd_mode mode, conversion_precision precision);
+
+    void bgra_to_420(unsigned char *destination[3], const int dst_stride[3], const unsigned char *const source[3],
+        const int width, const int height, const int src_stride[3], simd_mode mode, conversion_precision precision);
+
+    // the padding of an encoder frame. The planes are padded on the right and at the bottom to a
+    // multiple of alignment luma samples, and get a border of border luma samples (rounded up to
+    // even) on all four sides, chroma gets half of both. Padding and border replicate the nearest
+    // sample of the picture. destination points to the top left of the picture, the planes need
+    // room for the border around it and dst_stride has to cover border + padded width + border.
+    struct output_padding
+    {
+        int alignment{16};
+        int border{0};
+    };
+
+    // convert and pad in one pass, the edges of every few rows are extended right after they are
+    // converted, while they are still in the cache.
+    void bgr_to_420_padded(unsigned char *destination[3], const int dst_stride[3], const unsigned char *const source[3],
+        const int width, const int height, const int src_stride[3], simd_mode mode, const output_padding &padding);
+
+    void bgra_to_420_padded(unsigned char *destination[3], const int dst_stride[3], const unsigned char *const source[3],
+        const int width, const int height, const int src_stride[3], simd_mode mode, const output_padding &padding);
+
+    // interlaced frames, the two fields are converted separately so chroma never mixes them. Chroma
+    // rows alternate between the fields like the source rows do: chroma row 2k + f is taken from the
+    // row pair k of field f, the rows 4k + f and 4k + f + 2 of the frame.
+    void bgr_to_420_interlaced(unsigned char *destination[3], const int dst_stride[3],
+        const unsigned char *const source[3], const int width, const int height, const int src_stride[3],
+        simd_mode mode);
+
+    void bgra_to_420_interlaced(unsigned char *destination[3], const int dst_stride[3],
+        const unsigned char *const source[3], const int width, const int height, const int src_stride[3],
+        simd_mode mode);
+
+    // premultiplied bgra, as delivered by compositors and browser capture. The color is divided by
+    // alpha while the pixels are unpacked, so there is no separate pass. Pixels with an alpha of 0 become black.
+    void bgra_premultiplied_to_420(unsigned char *destination[3], const int dst_stride[3],
+        const unsigned char *const source[3], const int width, const int height, const int src_stride[3],
+        simd_mode mode);
+
+    // 16 bit per channel input, bgr48 (3 channels) and bgra64 (4 channels), with samples of bit_depth
+    // (8 to 16) bits in the low bits of every channel. src_stride is in bytes. The reduction to 8 bits
+    // keeps the fraction bits of the input until the final shift. With dither a 4x4 ordered dither
+    // matrix is added before that shift instead of rounding, which hides the banding of smooth gradients.
+    void bgr48_to_420(unsigned char *destination[3], const int dst_stride[3], const unsigned short *source,
+        const int src_stride, const int width, const int height, const int bit_depth, const bool dither,
+        simd_mode mode);
+
+    void bgra64_to_420(unsigned char *destination[3], const int dst_stride[3], const unsigned short *source,
+        const int src_stride, const int width, const int height, const int bit_depth, const bool dither,
+        simd_mode mode);
+
+    // luma only, for consumers that have no use for chroma. Only the y row kernels run.
+    void bgr_to_y(unsigned char *destination, const int dst_stride, const unsigned char *source, const int src_stride,
+        const int width, const int height, simd_mode mode);
+
+    void bgra_to_y(unsigned char *destination, const int dst_stride, const unsigned char *source, const int src_stride,
+        const int width, const int height, simd_mode mode);
+
+    // the reverse, a gray frame to i420. The gray plane is copied to y and the chroma planes are
+    // filled with 128.
+    void gray8_to_420(unsigned char *destination[3], const int dst_stride[3], const unsigned char *source,
+        const int src_stride, const int width, const int height, simd_mode mode);
+
+    // plane repacking. width and height are the size of the luma plane, chroma is (width + 1) / 2 by
+    // (height + 1) / 2. Every plane is written straight into the stride of the caller, so planes can
+    // be padded or be part of a larger frame. The row bands run on the library pool.
+    void copy_plane(unsigned char *destination, const int dst_stride, const unsigned char *source,
+        const int src_stride, const int width, const int height, simd_mode mode);
+
+    // i420 to semi planar nv12 (interleaved u v) and nv21 (interleaved v u), destination and dst_stride
+    // hold y and uv. The luma is left alone when destination[0] is source[0].
+    void i420_to_nv12(unsigned char *destination[2], const int dst_stride[2], const unsigned char *const source[3],
+        const int src_stride[3], const int width, const int height, simd_mode mode);
+
+    void i420_to_nv21(unsigned char *destination[2], const int dst_stride[2], const unsigned char *const source[3],
+        const int src_stride[3], const int width, const int height, simd_mode mode);
+
+    // the reverse, source and src_stride hold y and uv. The luma is left alone when destination[0] is source[0].
+    void nv12_to_i420(unsigned char *destination[3], const int dst_stride[3], const unsigned char *const source[2],
+        const int src_stride[2], const int width, const int height, simd_mode mode);
+
+    void nv21_to_i420(unsigned char *destination[3], const int dst_stride[3], const unsigned char *const source[2],
+        const int src_stride[2], const int width, const int height, simd_mode mode);
+
+    // swap the order of the interleaved chroma, nv12 to nv21 and back. Can run in place.
+    void nv12_to_nv21(unsigned char *destination[2], const int dst_stride[2], const unsigned char *const source[2],
+        const int src_stride[2], const int width, const int height, simd_mode mode);
+
+    // yv12 stores v before u. The planes are passed in memory order (y, v, u for yv12), so this copies
+    // source[1] to destination[2] and source[2] to destination[1] and also converts yv12 back to i420.
+    void i420_to_yv12(unsigned char *destination[3], const int dst_stride[3], const unsigned char *const source[3],
+        const int src_stride[3], const int width, const int height, simd_mode mode);
+
+    // convert a frame to i420 in the memory of the frame itself. The result is a contiguous i420
+    // frame at the start of buffer, y with a stride of width followed by u and v with a stride of
+    // (width + 1) / 2, their pointers and strides are returned in destination and dst_stride.
+    // src_stride can not be negative. Rows are converted top to bottom on the calling thread, so
+    // nothing is overwritten before it is read. The first chroma rows would overwrite source rows
+    // that are still to be read, they go through a small scratch buffer.
+    void bgr_to_420_inplace(unsigned char *buffer, const int width, const int height, const int src_stride,
+        unsigned char *destination[3], int dst_stride[3], simd_mode mode);
+
+    void bgra_to_420_inplace(unsigned char *buffer, const int width, const int height, const int src_stride,
+        unsigned char *destination[3], int dst_stride[3], simd_mode mode);
+
+    // planar 4:2:2, chroma is subsampled horizontally only (I422).
+    void bgr_to_422(unsigned char *destination[3], const int dst_stride[3], const unsigned char *const source[3],
+        const int width, const int height, const int src_stride[3], simd_mode mode);
+
+    void bgra_to_422(unsigned char *destination[3], const int dst_stride[3], const unsigned char *const source[3],
+        const int width, const int height, const int src_stride[3], simd_mode mode);
+
+    // planar 4:4:4, no chroma subsampling (I444).
+    void bgr_to_444(unsigned char *destination[3], const int dst_stride[3], const unsigned char *const source[3],
+        const int width, const int height, const int src_stride[3], simd_mode mode);
+
+    void bgra_to_444(unsigned char *destination[3], const int dst_stride[3], const unsigned char *const source[3],
+        const int width, const int height, const int src_stride[3], simd_mode mode);
+
+    // packed 4:2:2, only destination[0] and dst_stride[0] are used.
+    void bgr_to_yuy2(unsigned char *destination[3], const int dst_stride[3], const unsigned char *const source[3],
+        const int width, const int height, const int src_stride[3], simd_mode mode);
+
+    void bgra_to_yuy2(unsigned char *destination[3], const int dst_stride[3], const unsigned char *const source[3],
+        const int width, const int height, const int src_stride[3], simd_mode mode);
+
+    void bgr_to_uyvy(unsigned char *destination[3], const int dst_stride[3], const unsigned char *const source[3],
+        const int width, const int height, const int src_stride[3], simd_mode mode);
+
+    void bgra_to_uyvy(unsigned char *destination[3], const int dst_stride[3], const unsigned char *const source[3],
+        const int width, const int height, const int src_stride[3], simd_mode mode);
+
+    // alpha blend a bgra overlay onto an existing i420 frame of dst_width x dst_height, with the
+    // top left corner of the overlay at (x, y). The overlay is clipped to the frame and only the
+    // pixels it covers are touched. Chroma is blended with the alpha of the pixel it is sampled from.
+    void bgra_blend_to_420(unsigned char *destination[3], const int dst_stride[3], const int dst_width,
+        const int dst_height, const unsigned char *const overlay[3], const int overlay_width,
+        const int overlay_height, const int overlay_stride[3], const int x, const int y, simd_mode mode);
+
+    struct composition_source
+    {
+        const unsigned char *data;
+        int stride;
+        int width;
+        int height;
+        pixel_format format;
+
+        // the top left of the destination rectangle on the canvas, rounded down to even so the
+        // chroma of the source lines up with the chroma of the canvas.
+        int x;
+        int y;
+    };
+
+    // convert a list of sources straight into their rectangles of a dst_width x dst_height i420
+    // canvas. Sources are clipped to the canvas, the rest of the canvas is left alone. The row bands
+    // of all sources are converted in parallel, so sources should not overlap.
+    void compose_420(unsigned char *destination[3], const int dst_stride[3], const int dst_width,
+        const int dst_height, const composition_source *sources, const int source_count, simd_mode mode);
 } // namespace yuvconvert
@@ -0,0 +1,89 @@
+/* Copyright(c) 2018 Steven Hoving
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include <yuvconvert/yuvconvert_converter.h>
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <unordered_set>
+
+namespace yuvconvert
+{
+    // identifies a submitted conversion, tickets are handed out in submission order starting at 1.
+    using ticket = std::uint64_t;
+
+    // runs the conversions of a converter on the library thread pool, so the submitting thread
+    // never waits for a frame. Any number of frames can be in flight, from any number of threads.
+    // The source and destination of a frame have to stay valid until its conversion completed.
+    // A completed conversion is either reported to the callback it was submitted with, or added to
+    // the completion queue.
+    class async_converter
+    {
+    public:
+        explicit async_converter(const converter &converter);
+
+        // waits for all conversions that are still in flight.
+        ~async_converter();
+
+        async_converter(const async_converter &) = delete;
+        async_converter &operator=(const async_converter &) = delete;
+
+        ticket submit(unsigned char *const destination[3], const int dst_stride[3], const unsigned char *source,
+            const int src_stride);
+
+        // the callback is called from a pool thread once the frame is converted, the ticket is not
+        // added to the completion queue.
+        ticket submit(unsigned char *const destination[3], const int dst_stride[3], const unsigned char *source,
+            const int src_stride, std::function<void(ticket)> on_complete);
+
+        // take the oldest ticket from the completion queue, returns false if it is empty.
+        bool poll(ticket &completed);
+
+        // take the oldest ticket from the completion queue, waits until there is one.
+        ticket wait_any();
+
+        // wait until the conversion of this ticket completed, it stays in the completion queue.
+        void wait(const ticket value);
+
+        // wait until nothing is in flight anymore.
+        void wait_all();
+
+        // the number of conversions submitted but not completed yet.
+        std::size_t in_flight() const;
+
+    private:
+        void run(const ticket value, unsigned char *const destination[3], const int dst_stride[3],
+            const unsigned char *source, const int src_stride, const std::function<void(ticket)> &on_complete);
+
+        converter converter_;
+
+        mutable std::mutex mutex_;
+        std::condition_variable completed_;
+        ticket next_ticket_{1};
+        std::unordered_set<ticket> in_flight_;
+        std::deque<ticket> completion_queue_;
+    };
+} // namespace yuvconvert
@@ -23,6 +23,9 @@
 
 #include <algorithm>
 #include <array>
+#include <cmath>
+#include <cstdint>
+#include <limits>
 
 #include <static_math/cmath.h>
 
@@ -151,21 +154,22 @@ constexpr auto rgbconvert<fixed_point>::to_v(const uint8_t r, const uint8_t g, c
 template<>
 constexpr auto rgbconvert<floating_point>::to_y(const uint8_t r, const uint8_t g, const uint8_t b) -> uint8_t
 {
-    const auto y = (luma_factor[0] * r) + (luma_factor[1] * g) + (luma_factor[2] * b) + 16;
+    // + 0.5 and truncation rounds to nearest, the value is never negative after the clamp.
+    const auto y = (luma_factor[0] * r) + (luma_factor[1] * g) + (luma_factor[2] * b) + 16.5;
     return static_cast<uint8_t>(std::clamp(y, 0.0, 255.0));
 }
 
 template<>
 constexpr auto rgbconvert<floating_point>::to_u(const uint8_t r, const uint8_t g, const uint8_t b) -> uint8_t
 {
-    const auto u = (chroma_u_factor[0] * r) - (chroma_u_factor[1] * g) + (chroma_u_factor[2] * b) + 128;
+    const auto u = (chroma_u_factor[0] * r) + (chroma_u_factor[1] * g) + (chroma_u_factor[2] * b) + 128.5;
     return static_cast<uint8_t>(std::clamp(u, 0.0, 255.0));
 }
 
 template<>
 constexpr auto rgbconvert<floating_point>::to_v(const uint8_t r, const uint8_t g, const uint8_t b) -> uint8_t
 {
-    const auto v = (0.615 * r) - (0.51499 * g) - (0.10001 * b) + 128;
+    const auto v = (chroma_v_factor[0] * r) + (chroma_v_factor[1] * g) + (chroma_v_factor[2] * b) + 128.5;
     return static_cast<uint8_t>(std::clamp(v, 0.0, 255.0));
 }
 
@@ -193,6 +197,43 @@ static constexpr auto rgb2v(const uint8_t r, const uint8_t g, const uint8_t b) -
     //return static_cast<uint8_t>(std::clamp(v, 0.0, 255.0));
 }
 
+// divide a premultiplied color channel by its alpha, rounded to nearest. These are the same single
+// precision steps as the simd kernels, so both round the same way. An alpha of 0 gives 0.
+static inline auto unpremultiply(const uint8_t value, const uint8_t alpha) -> uint8_t
+{
+    const auto scale = alpha ? 255.0f / alpha : 0.0f;
+    return static_cast<uint8_t>(std::lrint(std::min(value * scale, 255.0f)));
+}
+
+// 16 bit per channel input is normalized to 15 bits, so the sums keep 7 fraction bits more than
+// the 8 bit kernels until the final shift. The rounding constant is replaced by a threshold, which is
+// either deep_half (round to nearest) or an entry of the dither matrix.
+constexpr auto deep_input_bits = 15;
+constexpr auto deep_fixed_point_precision = fixed_point_precision + deep_input_bits - 8;
+constexpr auto deep_half = 1 << (deep_fixed_point_precision - 1);
+
+// normalize a sample of bit_depth (8 to 16) bits to deep_input_bits.
+static constexpr auto deep_normalize(const unsigned int value, const int bit_depth) -> int
+{
+    return static_cast<int>((bit_depth <= deep_input_bits) ? value << (deep_input_bits - bit_depth)
+                                                           : value >> (bit_depth - deep_input_bits));
+}
+
+static constexpr auto deep2y(const int r, const int g, const int b, const int threshold) -> uint8_t
+{
+    return ((66 * r + 129 * g + 25 * b + threshold) >> deep_fixed_point_precision) + 16;
+}
+
+static constexpr auto deep2u(const int r, const int g, const int b, const int threshold) -> uint8_t
+{
+    return ((-38 * r + -74 * g + 112 * b + threshold) >> deep_fixed_point_precision) + 128;
+}
+
+static constexpr auto deep2v(const int r, const int g, const int b, const int threshold) -> uint8_t
+{
+    return ((112 * r + -94 * g + -18 * b + threshold) >> deep_fixed_point_precision) + 128;
+}
+
 //B = 1.164(Y - 16) + 2.018(U - 128)
 //G = 1.164(Y - 16) - 0.813(V - 128) - 0.391(U - 128)
 //R = 1.164(Y - 16) + 1.596(V - 128)
@@ -229,4 +270,11 @@ static constexpr auto yuv2b(const uint8_t y, const uint8_t u, const uint8_t /*v*
 static constexpr uint32_t adder_scaler(const uint32_t a, const uint32_t b)
 {
     return (((a ^ b) & 0x7f7f7f7f) >> 1) | (a & b);
+}
+
+// blend src over dst, alpha 255 is fully src. The division by 255 is rounded.
+static constexpr auto alpha_blend(const uint8_t src, const uint8_t dst, const uint8_t alpha) -> uint8_t
+{
+    const auto value = src * alpha + dst * (255 - alpha) + 128;
+    return static_cast<uint8_t>((value + (value >> 8)) >> 8);
 }
\ No newline at end of file
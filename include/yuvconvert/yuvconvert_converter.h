@@ -0,0 +1,113 @@
+/* Copyright(c) 2018 Steven Hoving
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include <yuvconvert.h>
+#include <string>
+
+namespace yuvconvert
+{
+    struct converter_config
+    {
+        simd_mode mode{simd_mode::ssse3};
+
+        // the frame is split into bands of this many rows that are converted on the library
+        // thread pool, 0 converts the whole frame on the calling thread.
+        int band_height{0};
+
+        // every band is walked in column tiles of this many pixels, 0 converts full rows. Tiling
+        // only pays off on frames much wider than default_tile_width.
+        int tile_width{0};
+
+        // use the kernels that are compiled for a fixed frame width when the width is one of the
+        // common video widths (1280, 1920 or 3840), other widths always use the generic kernels.
+        bool specialized{true};
+
+        // floating_point is only used for reference output, it never uses the specialized kernels.
+        conversion_precision precision{conversion_precision::fixed_point};
+
+        // convert the two fields of an interlaced frame separately, see bgra_to_420_interlaced.
+        bool interlaced{false};
+
+        // pad the planes for an encoder, see output_padding. The edges are extended in the bands
+        // right after they are converted, interlaced frames are padded after both fields.
+        bool padded{false};
+        output_padding padding{};
+    };
+
+    // the column tile width that keeps the source and destination of a row pair tile in half of
+    // the l1 data cache of this cpu.
+    int default_tile_width(pixel_format format);
+
+    // a bgr(a) to i420 converter for one geometry, set up once and used for every frame.
+    class converter
+    {
+    public:
+        converter(pixel_format format, int width, int height, const converter_config &config);
+
+        void convert(unsigned char *const destination[3], const int dst_stride[3], const unsigned char *source,
+            const int src_stride) const;
+
+        pixel_format format() const noexcept
+        {
+            return format_;
+        }
+
+        int width() const noexcept
+        {
+            return width_;
+        }
+
+        int height() const noexcept
+        {
+            return height_;
+        }
+
+        const converter_config &config() const noexcept
+        {
+            return config_;
+        }
+
+        // true if the frames are converted by a kernel specialized for this width.
+        bool specialized() const noexcept
+        {
+            return specialized_;
+        }
+
+    private:
+        pixel_format format_;
+        int width_;
+        int height_;
+        converter_config config_;
+        bool specialized_{false};
+    };
+
+    // microbenchmark the kernels this cpu supports, a range of band heights and column tiling for
+    // the given geometry, and return the fastest configuration. This takes a few milliseconds and allocates a
+    // scratch frame of the given size.
+    converter_config autotune(pixel_format format, int width, int height);
+
+    // the same, but the result is looked up in (and added to) a cache file, keyed by the cpu model
+    // and the geometry. Only the first start on a machine pays for the tuning. A cache file that
+    // can not be read or written is ignored.
+    converter_config autotune(pixel_format format, int width, int height, const std::string &cache_path);
+} // namespace yuvconvert
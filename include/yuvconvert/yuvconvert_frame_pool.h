@@ -0,0 +1,109 @@
+/* Copyright(c) 2018 Steven Hoving
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <mutex>
+#include <vector>
+
+namespace yuvconvert
+{
+    // every plane and every stride of a pooled frame is a multiple of this.
+    constexpr int frame_alignment = 64;
+
+    enum class frame_format
+    {
+        i420,
+        nv12, // the second plane holds interleaved u and v, the third plane is unused.
+        bgra
+    };
+
+    enum class page_backing
+    {
+        normal,
+        transparent_huge_pages, // madvise(MADV_HUGEPAGE), linux only.
+        huge_pages              // MAP_HUGETLB, falls back to normal pages when none are reserved.
+    };
+
+    struct frame
+    {
+        unsigned char *planes[3]{nullptr, nullptr, nullptr};
+        int stride[3]{0, 0, 0};
+        int width{0};
+        int height{0};
+        frame_format format{frame_format::i420};
+    };
+
+    // hands out frames of a single format and size. A released frame is kept by the pool and
+    // handed out again by the next acquire, so a steady stream of frames never goes back to the
+    // allocator. All memory is returned when the pool is destroyed. The pool is thread safe.
+    // \note the conversion functions pick aligned loads and stores for frames from a pool.
+    class frame_pool
+    {
+    public:
+        frame_pool(frame_format format, int width, int height, page_backing backing = page_backing::normal);
+        ~frame_pool();
+
+        frame_pool(const frame_pool &) = delete;
+        frame_pool &operator=(const frame_pool &) = delete;
+
+        // get a frame, the contents are whatever the previous user left behind.
+        frame acquire();
+
+        // hand a frame from acquire back to the pool.
+        void release(const frame &value);
+
+        // allocate frames up front so the next count calls to acquire do not have to.
+        void reserve(int count);
+
+        // the size in bytes of a single frame, including the stride padding.
+        std::size_t frame_size() const noexcept
+        {
+            return frame_size_;
+        }
+
+        // the number of frames allocated by the pool, in use or not.
+        std::size_t allocated_count() const;
+
+    private:
+        struct allocation
+        {
+            unsigned char *data;
+            std::size_t size;
+        };
+
+        unsigned char *allocate();
+        frame make_frame(unsigned char *data) const noexcept;
+
+        frame_format format_;
+        int width_;
+        int height_;
+        page_backing backing_;
+        int stride_[3]{0, 0, 0};
+        std::size_t plane_offset_[3]{0, 0, 0};
+        std::size_t frame_size_{0};
+
+        mutable std::mutex mutex_;
+        std::vector<allocation> allocations_;
+        std::vector<unsigned char *> free_;
+    };
+} // namespace yuvconvert
@@ -0,0 +1,68 @@
+/* Copyright(c) 2018 Steven Hoving
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include <yuvconvert.h>
+#include <cstdint>
+
+namespace yuvconvert
+{
+    // the psnr reported for identical planes.
+    constexpr double max_psnr = 128.0;
+
+    struct frame_metrics
+    {
+        // per plane (y, u, v), or per channel (b, g, r) for a round trip comparison.
+        std::uint64_t sse[3]{0, 0, 0};
+        double psnr[3]{0.0, 0.0, 0.0};
+        double ssim[3]{0.0, 0.0, 0.0};
+
+        // psnr over all samples of all planes.
+        double psnr_all{0.0};
+
+        // 0.8 y + 0.1 u + 0.1 v for yuv, the channel average for a round trip comparison.
+        double ssim_all{0.0};
+    };
+
+    // sum of squared errors of a plane.
+    std::uint64_t plane_sse(const unsigned char *a, const int a_stride, const unsigned char *b, const int b_stride,
+        const int width, const int height, simd_mode mode);
+
+    // mean ssim of a plane, calculated over 8x8 windows placed every 4 pixels.
+    double plane_ssim(const unsigned char *a, const int a_stride, const unsigned char *b, const int b_stride,
+        const int width, const int height, simd_mode mode);
+
+    // psnr = 10 * log10(255^2 * samples / sse), capped at max_psnr.
+    double psnr(const std::uint64_t sse, const std::uint64_t samples) noexcept;
+
+    // compare two i420 frames.
+    frame_metrics compare_420(const unsigned char *const a[3], const int a_stride[3],
+        const unsigned char *const b[3], const int b_stride[3], const int width, const int height,
+        simd_mode mode);
+
+    // compare an i420 frame against the bgra frame it was converted from. The i420 frame is
+    // converted back to rgb (with nearest neighbour chroma) and the b, g and r channels are
+    // compared. This allocates 6 planes of width x height for the duration of the call.
+    frame_metrics compare_bgra_to_420(const unsigned char *const source[3], const int src_stride[3],
+        const unsigned char *const yuv[3], const int yuv_stride[3], const int width, const int height,
+        simd_mode mode);
+} // namespace yuvconvert
@@ -0,0 +1,137 @@
+/* Copyright(c) 2018 Steven Hoving
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace yuvconvert
+{
+    struct y4m_header
+    {
+        int width{0};
+        int height{0};
+        int fps_numerator{30};
+        int fps_denominator{1};
+        char interlace{'p'};
+        int aspect_numerator{1};
+        int aspect_denominator{1};
+
+        // the C parameter, 420jpeg, 420mpeg2, 420paldv, 420, 422, 444 or mono. The chroma siting of
+        // the converters matches none of the 4:2:0 variants exactly, 420jpeg is what most tools expect.
+        std::string colorspace{"420jpeg"};
+    };
+
+    // the size of the chroma planes of a colorspace, 0x0 for mono.
+    void y4m_chroma_size(const y4m_header &header, int &chroma_width, int &chroma_height);
+
+    // a frame of a y4m stream. The planes point straight into the mapped file or into a slot of
+    // the reader's ring buffer, nothing is copied.
+    struct y4m_frame_view
+    {
+        const unsigned char *planes[3]{nullptr, nullptr, nullptr};
+        int stride[3]{0, 0, 0};
+        std::size_t index{0};
+    };
+
+    enum class y4m_read_mode
+    {
+        mmap,  // map the whole file, views stay valid as long as the reader lives.
+        stream // read frames into a ring of slots, a view stays valid until ring_size more frames are read.
+    };
+
+    class y4m_reader
+    {
+    public:
+        // "-" reads stdin, which is always streamed. Throws std::runtime_error when the file can not be
+        // opened or does not start with a valid header. Mapping is posix only, windows streams.
+        explicit y4m_reader(const std::string &path, y4m_read_mode mode = y4m_read_mode::mmap, int ring_size = 4);
+        ~y4m_reader();
+
+        y4m_reader(const y4m_reader &) = delete;
+        y4m_reader &operator=(const y4m_reader &) = delete;
+
+        const y4m_header &header() const noexcept
+        {
+            return header_;
+        }
+
+        // the size of the planes of a frame, without the frame header.
+        std::size_t frame_size() const noexcept
+        {
+            return frame_size_;
+        }
+
+        // get the next frame, returns false at the end of the stream. A truncated last frame ends the
+        // stream as well.
+        bool next(y4m_frame_view &frame);
+
+    private:
+        bool next_mapped(y4m_frame_view &frame);
+        bool next_streamed(y4m_frame_view &frame);
+        bool read_line(std::string &line);
+        bool read_exact(unsigned char *data, std::size_t size);
+        void set_planes(const unsigned char *data, y4m_frame_view &frame) noexcept;
+        void close() noexcept;
+
+        int fd_{-1};
+        bool owns_fd_{false};
+        y4m_header header_;
+        std::size_t frame_size_{0};
+        std::size_t plane_size_[3]{0, 0, 0};
+        int chroma_width_{0};
+        std::size_t next_index_{0};
+
+        // mapped
+        const unsigned char *data_{nullptr};
+        std::size_t size_{0};
+        std::size_t offset_{0};
+
+        // streamed
+        std::vector<std::vector<unsigned char>> ring_;
+    };
+
+    class y4m_writer
+    {
+    public:
+        // "-" writes to stdout. Throws std::runtime_error when the file can not be created.
+        y4m_writer(const std::string &path, const y4m_header &header);
+        ~y4m_writer();
+
+        y4m_writer(const y4m_writer &) = delete;
+        y4m_writer &operator=(const y4m_writer &) = delete;
+
+        // write a frame straight from the planes, for example the output planes of a converter. The
+        // frame header and the planes go out with a single writev when the planes are unpadded, or
+        // with one io vector per row when they are padded.
+        void write(const unsigned char *const planes[3], const int stride[3]);
+
+    private:
+        int fd_{-1};
+        bool owns_fd_{false};
+        y4m_header header_;
+        int chroma_width_{0};
+        int chroma_height_{0};
+    };
+} // namespace yuvconvert
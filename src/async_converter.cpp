@@ -0,0 +1,130 @@
+/* Copyright(c) 2018 Steven Hoving
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "yuvconvert_async.h"
+#include "thread_pool.h"
+
+#include <array>
+
+namespace yuvconvert
+{
+
+async_converter::async_converter(const converter &converter)
+    : converter_(converter)
+{
+}
+
+async_converter::~async_converter()
+{
+    wait_all();
+}
+
+ticket async_converter::submit(unsigned char *const destination[3], const int dst_stride[3],
+    const unsigned char *source, const int src_stride)
+{
+    return submit(destination, dst_stride, source, src_stride, nullptr);
+}
+
+ticket async_converter::submit(unsigned char *const destination[3], const int dst_stride[3],
+    const unsigned char *source, const int src_stride, std::function<void(ticket)> on_complete)
+{
+    ticket value;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        value = next_ticket_++;
+        in_flight_.insert(value);
+    }
+
+    // the plane pointers and strides are copied, the caller's arrays may be gone by the time the
+    // task runs.
+    const std::array<unsigned char *, 3> planes{destination[0], destination[1], destination[2]};
+    const std::array<int, 3> strides{dst_stride[0], dst_stride[1], dst_stride[2]};
+
+    auto &pool = thread_pool::instance();
+    if (pool.size() == 0)
+    {
+        // a single core machine has no workers, the caller is the only thread there is.
+        run(value, planes.data(), strides.data(), source, src_stride, on_complete);
+        return value;
+    }
+
+    pool.submit([this, value, planes, strides, source, src_stride, on_complete = std::move(on_complete)] {
+        run(value, planes.data(), strides.data(), source, src_stride, on_complete);
+    });
+    return value;
+}
+
+void async_converter::run(const ticket value, unsigned char *const destination[3], const int dst_stride[3],
+    const unsigned char *source, const int src_stride, const std::function<void(ticket)> &on_complete)
+{
+    converter_.convert(destination, dst_stride, source, src_stride);
+
+    if (on_complete)
+        on_complete(value);
+
+    // notify under the lock, a waiting destructor may destroy the converter as soon as it is released.
+    std::lock_guard<std::mutex> lock(mutex_);
+    in_flight_.erase(value);
+    if (!on_complete)
+        completion_queue_.push_back(value);
+    completed_.notify_all();
+}
+
+bool async_converter::poll(ticket &completed)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (completion_queue_.empty())
+        return false;
+
+    completed = completion_queue_.front();
+    completion_queue_.pop_front();
+    return true;
+}
+
+ticket async_converter::wait_any()
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    completed_.wait(lock, [this] { return !completion_queue_.empty(); });
+
+    const auto completed = completion_queue_.front();
+    completion_queue_.pop_front();
+    return completed;
+}
+
+void async_converter::wait(const ticket value)
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    completed_.wait(lock, [this, value] { return in_flight_.count(value) == 0; });
+}
+
+void async_converter::wait_all()
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    completed_.wait(lock, [this] { return in_flight_.empty(); });
+}
+
+std::size_t async_converter::in_flight() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return in_flight_.size();
+}
+
+} // namespace yuvconvert
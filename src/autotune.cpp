@@ -0,0 +1,221 @@
+/* Copyright(c) 2018 Steven Hoving
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "yuvconvert_converter.h"
+#include "cpu_features.h"
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <limits>
+#include <sstream>
+#include <vector>
+
+namespace yuvconvert
+{
+
+// the band heights that are tried, 0 is the single threaded conversion.
+static constexpr int tune_band_heights[] = {0, 16, 32, 64, 128, 256};
+
+// the rows used to pick the kernel, the kernels are compared single threaded on a strip of the frame.
+static constexpr auto tune_strip_height = 16;
+
+// every candidate is run until it used this much time, at least once and at most tune_max_runs times.
+static constexpr auto tune_budget = std::chrono::microseconds(1500);
+static constexpr auto tune_max_runs = 8;
+
+struct scratch_frame
+{
+    scratch_frame(pixel_format format, int width, int height)
+    {
+        const auto pixel_width = (format == pixel_format::bgra) ? 4 : 3;
+        const auto chroma_width = (width + 1) >> 1;
+        const auto chroma_height = (height + 1) >> 1;
+
+        source_stride = width * pixel_width;
+        source.resize(static_cast<size_t>(source_stride) * height);
+
+        // something that is not constant, so nothing can take a shortcut.
+        unsigned int seed = 1;
+        for (auto &itr : source)
+        {
+            seed = seed * 1103515245u + 12345u;
+            itr = static_cast<unsigned char>(seed >> 16);
+        }
+
+        stride[0] = width;
+        stride[1] = chroma_width;
+        stride[2] = chroma_width;
+        buffer.resize(static_cast<size_t>(width) * height + static_cast<size_t>(chroma_width) * chroma_height * 2);
+        planes[0] = buffer.data();
+        planes[1] = planes[0] + static_cast<size_t>(width) * height;
+        planes[2] = planes[1] + static_cast<size_t>(chroma_width) * chroma_height;
+    }
+
+    std::vector<unsigned char> source;
+    int source_stride{0};
+    std::vector<unsigned char> buffer;
+    unsigned char *planes[3]{nullptr, nullptr, nullptr};
+    int stride[3]{0, 0, 0};
+};
+
+// the fastest of a few runs, in seconds.
+static double measure(const converter &candidate, scratch_frame &frame)
+{
+    using clock = std::chrono::steady_clock;
+
+    // warm up the caches (and the thread pool) first.
+    candidate.convert(frame.planes, frame.stride, frame.source.data(), frame.source_stride);
+
+    auto best = std::chrono::duration<double>::max();
+    const auto start = clock::now();
+    for (int run = 0; run < tune_max_runs; ++run)
+    {
+        const auto begin = clock::now();
+        candidate.convert(frame.planes, frame.stride, frame.source.data(), frame.source_stride);
+        const auto end = clock::now();
+
+        best = std::min<std::chrono::duration<double>>(best, end - begin);
+        if (end - start > tune_budget)
+            break;
+    }
+
+    return best.count();
+}
+
+static std::vector<simd_mode> supported_modes()
+{
+    std::vector<simd_mode> result{simd_mode::plain_c};
+    // the portable kernels only stand in for the x86 kernels, they never beat them.
+    if (get_cpu_features().ssse3)
+        result.push_back(simd_mode::ssse3);
+    else if (YUVCONVERT_VECTOR_EXTENSIONS)
+        result.push_back(simd_mode::portable);
+    return result;
+}
+
+converter_config autotune(pixel_format format, int width, int height)
+{
+    converter_config result;
+    scratch_frame frame(format, width, height);
+
+    // pick the kernel on a strip, the relative speed of the kernels does not depend on the height.
+    auto best_time = std::numeric_limits<double>::max();
+    for (const auto mode : supported_modes())
+    {
+        const converter candidate(format, width, std::min(height, tune_strip_height), {mode, 0, 0});
+        const auto time = measure(candidate, frame);
+        if (time < best_time)
+        {
+            best_time = time;
+            result.mode = mode;
+        }
+    }
+
+    // then the band height, with the chosen kernel on the full frame.
+    best_time = std::numeric_limits<double>::max();
+    for (const auto band_height : tune_band_heights)
+    {
+        if (band_height >= height)
+            break;
+
+        const converter candidate(format, width, height, {result.mode, band_height, 0});
+        const auto time = measure(candidate, frame);
+        if (time < best_time)
+        {
+            best_time = time;
+            result.band_height = band_height;
+        }
+    }
+
+    // and last whether walking the bands in column tiles helps, which only matters for wide frames.
+    const auto tile_width = default_tile_width(format);
+    if (tile_width < width)
+    {
+        const converter candidate(format, width, height, {result.mode, result.band_height, tile_width});
+        if (measure(candidate, frame) < best_time)
+            result.tile_width = tile_width;
+    }
+
+    return result;
+}
+
+// the cache key of a geometry on this machine, the cpu model with the spaces replaced so the key
+// is a single token.
+static std::string cache_key(pixel_format format, int width, int height)
+{
+    std::string model = get_cpu_features().model;
+    model.erase(0, model.find_first_not_of(' '));
+    if (model.empty())
+        model = "unknown";
+    std::replace(model.begin(), model.end(), ' ', '_');
+
+    std::ostringstream key;
+    key << model << ' ' << static_cast<int>(format) << ' ' << width << 'x' << height;
+    return key.str();
+}
+
+// every line of the cache is
+// "<cpu model> <pixel format> <width>x<height> <simd mode> <band height> <tile width>".
+static bool load_cached(const std::string &cache_path, const std::string &key, converter_config &config)
+{
+    std::ifstream file(cache_path);
+    std::string line;
+    while (std::getline(file, line))
+    {
+        if (line.compare(0, key.size(), key) != 0 || line.size() <= key.size() || line[key.size()] != ' ')
+            continue;
+
+        std::istringstream values(line.substr(key.size()));
+        int mode = 0;
+        int band_height = 0;
+        int tile_width = 0;
+        if (!(values >> mode >> band_height >> tile_width) || band_height < 0 || tile_width < 0)
+            continue;
+
+        const auto modes = supported_modes();
+        if (std::find(modes.begin(), modes.end(), static_cast<simd_mode>(mode)) == modes.end())
+            continue;
+
+        config = {static_cast<simd_mode>(mode), band_height, tile_width};
+        return true;
+    }
+
+    return false;
+}
+
+converter_config autotune(pixel_format format, int width, int height, const std::string &cache_path)
+{
+    const auto key = cache_key(format, width, height);
+
+    converter_config result;
+    if (load_cached(cache_path, key, result))
+        return result;
+
+    result = autotune(format, width, height);
+
+    std::ofstream file(cache_path, std::ios::app);
+    file << key << ' ' << static_cast<int>(result.mode) << ' ' << result.band_height << ' ' << result.tile_width
+         << '\n';
+    return result;
+}
+
+} // namespace yuvconvert
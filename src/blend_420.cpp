@@ -0,0 +1,93 @@
+/* Copyright(c) 2018 Steven Hoving
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "blend_420_c.h"
+#include "blend_420_ssse3.h"
+#include "row_converter.h"
+#include "cpu_features.h"
+#include "yuvconvert.h"
+
+#include <algorithm>
+
+namespace yuvconvert
+{
+using bgra_row_blend_uv_row = void(const unsigned char *src, unsigned char *dst_u, unsigned char *dst_v,
+    const int width);
+
+void bgra_blend_to_420(unsigned char *destination[3], const int dst_stride[3], const int dst_width,
+    const int dst_height, const unsigned char *const overlay[3], const int overlay_width, const int overlay_height,
+    const int overlay_stride[3], const int x, const int y, simd_mode mode)
+{
+    // clip the overlay rectangle to the frame.
+    const auto first_column = std::max(0, x);
+    const auto last_column = std::min(dst_width, x + overlay_width);
+    const auto first_row = std::max(0, y);
+    const auto last_row = std::min(dst_height, y + overlay_height);
+    if (first_column >= last_column || first_row >= last_row)
+        return;
+
+    const auto width = last_column - first_column;
+
+    // chroma is sampled at the even columns, so for an odd first column the first chroma sample
+    // is taken from the next overlay pixel.
+    const auto chroma_column = (first_column + 1) & ~1;
+    const auto chroma_width = last_column - chroma_column;
+
+    bgrx_row_to_y_row *y_row_blender = bgra_row_blend_y_row_c;
+    bgra_row_blend_uv_row *uv_row_blender = bgra_row_blend_uv_row_c;
+    bgrx_row_to_yuv_row *yuv_row_blender = bgra_row_blend_yuv_row_c;
+#if YUVCONVERT_X86
+    if (use_x86_kernels(mode))
+    {
+        y_row_blender = bgra_row_blend_y_row_ssse3;
+        uv_row_blender = bgra_row_blend_uv_row_ssse3;
+        yuv_row_blender = bgra_row_blend_yuv_row_ssse3;
+    }
+#endif
+
+    for (int line = first_row; line < last_row; ++line)
+    {
+        const auto src = overlay[0] + (line - y) * overlay_stride[0] + (first_column - x) * 4;
+        const auto dst_y = destination[0] + line * dst_stride[0] + first_column;
+
+        // only the even lines carry chroma.
+        if (line & 1)
+        {
+            y_row_blender(src, dst_y, width);
+            continue;
+        }
+
+        const auto dst_u = destination[1] + (line >> 1) * dst_stride[1] + (chroma_column >> 1);
+        const auto dst_v = destination[2] + (line >> 1) * dst_stride[2] + (chroma_column >> 1);
+        if (chroma_column == first_column)
+        {
+            yuv_row_blender(src, dst_y, dst_u, dst_v, width);
+        }
+        else
+        {
+            y_row_blender(src, dst_y, width);
+            if (chroma_width > 0)
+                uv_row_blender(src + 4, dst_u, dst_v, chroma_width);
+        }
+    }
+}
+
+} // namespace yuvconvert
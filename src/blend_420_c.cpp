@@ -0,0 +1,56 @@
+/* Copyright(c) 2018 Steven Hoving
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "blend_420_c.h"
+#include "yuv_pixel_type.h"
+#include "yuvconvert_common.h"
+
+void bgra_row_blend_y_row_c(const unsigned char *src, unsigned char *dst, const int width)
+{
+    auto pixel = reinterpret_cast<const bgra *>(src);
+    for (int x = 0; x < width; ++x)
+    {
+        *dst = alpha_blend(rgb2y(pixel->r, pixel->g, pixel->b), *dst, pixel->a);
+        ++dst;
+        ++pixel;
+    }
+}
+
+void bgra_row_blend_uv_row_c(const unsigned char *src, unsigned char *dst_u, unsigned char *dst_v,
+    const int width)
+{
+    auto pixel = reinterpret_cast<const bgra *>(src);
+    for (int x = 0; x < width; x += 2)
+    {
+        *dst_u = alpha_blend(rgb2u(pixel->r, pixel->g, pixel->b), *dst_u, pixel->a);
+        *dst_v = alpha_blend(rgb2v(pixel->r, pixel->g, pixel->b), *dst_v, pixel->a);
+        ++dst_u;
+        ++dst_v;
+        pixel += 2;
+    }
+}
+
+void bgra_row_blend_yuv_row_c(const unsigned char *src, unsigned char *dst_y, unsigned char *dst_u,
+    unsigned char *dst_v, const int width)
+{
+    bgra_row_blend_y_row_c(src, dst_y, width);
+    bgra_row_blend_uv_row_c(src, dst_u, dst_v, width);
+}
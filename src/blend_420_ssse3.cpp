@@ -0,0 +1,172 @@
+/* Copyright(c) 2018 Steven Hoving
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "blend_420_ssse3.h"
+#include "blend_420_c.h"
+#include "yuvconvert_common.h"
+
+#include "simd_vec.h"
+#include "simd_common.h"
+#include "simd_bgrx.h"
+#include "simd_utility.h"
+
+#include <emmintrin.h>
+#include <tmmintrin.h>
+
+using namespace simd;
+
+// moves the alpha of 4 bgra pixels into the lowest 4 bytes.
+static const auto alpha_shuffle = _mm_set_epi8(
+    mask, mask, mask, mask,
+    mask, mask, mask, mask,
+    mask, mask, mask, mask,
+    15, 11, 7, 3);
+
+// takes every even byte, the alpha of the pixels we take the chroma of.
+static const auto even_shuffle = _mm_set_epi8(
+    mask, mask, mask, mask,
+    mask, mask, mask, mask,
+    14, 12, 10, 8, 6, 4, 2, 0);
+
+static const auto alpha_max = _mm_set1_epi16(255);
+
+// load the alpha of 16 bgra pixels (64 bytes).
+static __forceinline __m128i bgra_block_alpha(const unsigned char *src)
+{
+    const auto alpha0 = _mm_shuffle_epi8(_mm_lddqu_si128((const __m128i *)(src +  0)), alpha_shuffle);
+    const auto alpha1 = _mm_shuffle_epi8(_mm_lddqu_si128((const __m128i *)(src + 16)), alpha_shuffle);
+    const auto alpha2 = _mm_shuffle_epi8(_mm_lddqu_si128((const __m128i *)(src + 32)), alpha_shuffle);
+    const auto alpha3 = _mm_shuffle_epi8(_mm_lddqu_si128((const __m128i *)(src + 48)), alpha_shuffle);
+
+    return _mm_or_si128(
+        _mm_or_si128(alpha0, _mm_slli_si128(alpha1, 4)),
+        _mm_or_si128(_mm_slli_si128(alpha2, 8), _mm_slli_si128(alpha3, 12)));
+}
+
+// blend 8 values in 16 bit lanes, (src * alpha + dst * (255 - alpha)) / 255 rounded.
+static __forceinline __m128i blend_epi16(__m128i src, __m128i dst, __m128i alpha)
+{
+    // both products are at most 255 * 255, so the sum still fits an unsigned 16 bit lane.
+    const auto inverse = _mm_sub_epi16(alpha_max, alpha);
+    auto value = _mm_add_epi16(_mm_mullo_epi16(src, alpha), _mm_mullo_epi16(dst, inverse));
+    value = _mm_add_epi16(value, uv_add); // abuse uv_add to + 128
+    return _mm_srli_epi16(_mm_add_epi16(value, _mm_srli_epi16(value, 8)), 8);
+}
+
+// blend 16 packed 8 bit values.
+static __forceinline __m128i blend_epu8(__m128i src, __m128i dst, __m128i alpha)
+{
+    const auto zero = _mm_setzero_si128();
+    const auto lo = blend_epi16(_mm_unpacklo_epi8(src, zero), _mm_unpacklo_epi8(dst, zero),
+        _mm_unpacklo_epi8(alpha, zero));
+    const auto hi = blend_epi16(_mm_unpackhi_epi8(src, zero), _mm_unpackhi_epi8(dst, zero),
+        _mm_unpackhi_epi8(alpha, zero));
+    return _mm_packus_epi16(lo, hi);
+}
+
+// blend the luma of 16 pixels.
+static __forceinline void blend_block_y(const vec3 &part0, const vec3 &part1, __m128i alpha, unsigned char *dst_y)
+{
+    const auto y = block_to_y(part0, part1);
+    const auto dst = _mm_loadu_si128((const __m128i *)dst_y);
+    _mm_storeu_si128((__m128i *)dst_y, blend_epu8(y, dst, alpha));
+}
+
+// blend the chroma of the 8 even pixels of a 16 pixel block.
+static __forceinline void blend_block_uv(const vec3 &part0, const vec3 &part1, __m128i alpha,
+    unsigned char *dst_u, unsigned char *dst_v)
+{
+    const auto zero = _mm_setzero_si128();
+    const auto alpha_even = _mm_unpacklo_epi8(_mm_shuffle_epi8(alpha, even_shuffle), zero);
+
+    const auto u = _mm_unpacklo_epi8(chroma_pack_even(block_to_chroma(part0, part1, u_mul)), zero);
+    const auto v = _mm_unpacklo_epi8(chroma_pack_even(block_to_chroma(part0, part1, v_mul)), zero);
+
+    const auto dst_u_value = _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i *)dst_u), zero);
+    const auto dst_v_value = _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i *)dst_v), zero);
+
+    _mm_storel_epi64((__m128i *)dst_u, _mm_packus_epi16(blend_epi16(u, dst_u_value, alpha_even), zero));
+    _mm_storel_epi64((__m128i *)dst_v, _mm_packus_epi16(blend_epi16(v, dst_v_value, alpha_even), zero));
+}
+
+void bgra_row_blend_y_row_ssse3(const unsigned char *src, unsigned char *dst, const int width)
+{
+    const int aligned_width = simd::align_down(width, 16);
+
+    int x = 0;
+    __no_unroll
+    for (; x < aligned_width; x += 16)
+    {
+        vec3 vec_part0;
+        vec3 vec_part1;
+        bgra_block_unpack(src, vec_part0, vec_part1);
+        blend_block_y(vec_part0, vec_part1, bgra_block_alpha(src), dst);
+        src += 64; // we process 64 bytes (16 pixels) per block
+        dst += 16;
+    }
+
+    bgra_row_blend_y_row_c(src, dst, width - x);
+}
+
+void bgra_row_blend_uv_row_ssse3(const unsigned char *src, unsigned char *dst_u, unsigned char *dst_v,
+    const int width)
+{
+    const int aligned_width = simd::align_down(width, 16);
+
+    int x = 0;
+    __no_unroll
+    for (; x < aligned_width; x += 16)
+    {
+        vec3 vec_part0;
+        vec3 vec_part1;
+        bgra_block_unpack(src, vec_part0, vec_part1);
+        blend_block_uv(vec_part0, vec_part1, bgra_block_alpha(src), dst_u, dst_v);
+        src += 64;
+        dst_u += 8;
+        dst_v += 8;
+    }
+
+    bgra_row_blend_uv_row_c(src, dst_u, dst_v, width - x);
+}
+
+void bgra_row_blend_yuv_row_ssse3(const unsigned char *src, unsigned char *dst_y, unsigned char *dst_u,
+    unsigned char *dst_v, const int width)
+{
+    const int aligned_width = simd::align_down(width, 16);
+
+    int x = 0;
+    __no_unroll
+    for (; x < aligned_width; x += 16)
+    {
+        vec3 vec_part0;
+        vec3 vec_part1;
+        bgra_block_unpack(src, vec_part0, vec_part1);
+        const auto alpha = bgra_block_alpha(src);
+        blend_block_y(vec_part0, vec_part1, alpha, dst_y);
+        blend_block_uv(vec_part0, vec_part1, alpha, dst_u, dst_v);
+        src += 64;
+        dst_y += 16;
+        dst_u += 8;
+        dst_v += 8;
+    }
+
+    bgra_row_blend_yuv_row_c(src, dst_y, dst_u, dst_v, width - x);
+}
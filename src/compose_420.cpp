@@ -0,0 +1,88 @@
+/* Copyright(c) 2018 Steven Hoving
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "to_420.h"
+#include "thread_pool.h"
+#include "yuvconvert.h"
+
+#include <algorithm>
+#include <vector>
+
+namespace yuvconvert
+{
+
+// a band of rows of one source, clipped to the canvas.
+struct composition_job
+{
+    const composition_source *source;
+    int first_column;
+    int last_column;
+    int top; // the first visible canvas row of the source
+    int first_row;
+    int last_row;
+};
+
+void compose_420(unsigned char *destination[3], const int dst_stride[3], const int dst_width,
+    const int dst_height, const composition_source *sources, const int source_count, simd_mode mode)
+{
+    std::vector<composition_job> jobs;
+    for (int i = 0; i < source_count; ++i)
+    {
+        const auto &source = sources[i];
+        const auto x = source.x & ~1;
+        const auto y = source.y & ~1;
+
+        const auto first_column = std::max(0, x);
+        const auto last_column = std::min(dst_width, x + source.width);
+        const auto first_row = std::max(0, y);
+        const auto last_row = std::min(dst_height, y + source.height);
+        if (first_column >= last_column || first_row >= last_row)
+            continue;
+
+        // split every source into bands, so the bands of all sources share the pool.
+        for (int row = first_row; row < last_row; row += default_band_height)
+            jobs.push_back({&source, first_column, last_column, first_row, row,
+                std::min(last_row, row + default_band_height)});
+    }
+
+    thread_pool::instance().parallel_for(static_cast<int>(jobs.size()), [&](int index) {
+        const auto &job = jobs[index];
+        const auto &source = *job.source;
+        const auto x = source.x & ~1;
+        const auto y = source.y & ~1;
+        const auto pixel_width = (source.format == pixel_format::bgra) ? 4 : 3;
+
+        // the top left of the visible part of the source, both in the source and on the canvas. The
+        // visible part is converted as a frame of its own, top is even so it starts at a row pair.
+        const auto src = source.data + (job.top - y) * source.stride + (job.first_column - x) * pixel_width;
+        unsigned char *const dst[3] = {
+            destination[0] + job.top * dst_stride[0] + job.first_column,
+            destination[1] + (job.top >> 1) * dst_stride[1] + (job.first_column >> 1),
+            destination[2] + (job.top >> 1) * dst_stride[2] + (job.first_column >> 1)
+        };
+
+        const auto converters = get_row_converters_420(source.format, mode);
+        convert_rows_420(converters, dst, dst_stride, src, source.stride, job.last_column - job.first_column,
+            job.first_row - job.top, job.last_row - job.top);
+    });
+}
+
+} // namespace yuvconvert
@@ -0,0 +1,133 @@
+/* Copyright(c) 2018 Steven Hoving
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "yuvconvert_converter.h"
+#include "to_420.h"
+#include "to_420_fixed_ssse3.h"
+#include "thread_pool.h"
+#include "cpu_features.h"
+#include "simd_utility.h"
+
+#include <algorithm>
+
+namespace yuvconvert
+{
+
+// the converter specialized for this width, or nullptr. The specialized converters are ssse3 only.
+#if YUVCONVERT_X86
+static fixed_rows_420 *get_fixed_rows_420(pixel_format format, int width, bool aligned)
+{
+    return get_fixed_rows_420_ssse3(format, width, aligned);
+}
+#else
+static fixed_rows_420 *get_fixed_rows_420(pixel_format, int, bool)
+{
+    return nullptr;
+}
+#endif
+
+int default_tile_width(pixel_format format)
+{
+    constexpr auto fallback_l1d_cache_size = 32 * 1024;
+    const auto cache_size = static_cast<int>(get_cpu_features().l1d_cache_size);
+    const auto l1d_cache_size = cache_size ? cache_size : fallback_l1d_cache_size;
+
+    // a pixel of a row pair takes 2 source pixels, 2 luma samples and half a u and v sample.
+    const auto pixel_width = (format == pixel_format::bgra) ? 4 : 3;
+    const auto bytes_per_pixel_x2 = 4 * pixel_width + 5;
+    return std::max(16, simd::align_down(l1d_cache_size / bytes_per_pixel_x2, 16));
+}
+
+converter::converter(pixel_format format, int width, int height, const converter_config &config)
+    : format_(format)
+    , width_(width)
+    , height_(height)
+    , config_(config)
+{
+    // column tiles split the rows into other widths, so they always use the generic kernels.
+    const auto tiled = config.tile_width > 0 && config.tile_width < width;
+    specialized_ = config.specialized && use_x86_kernels(config.mode) && !tiled &&
+        config.precision == conversion_precision::fixed_point && get_fixed_rows_420(format, width, false) != nullptr;
+}
+
+void converter::convert(unsigned char *const destination[3], const int dst_stride[3], const unsigned char *source,
+    const int src_stride) const
+{
+    const auto aligned = is_aligned_420(destination, dst_stride, source, src_stride);
+    const auto converters = get_row_converters_420(format_, config_.mode, aligned, config_.precision);
+    const auto fixed_rows = specialized_ ? get_fixed_rows_420(format_, width_, aligned) : nullptr;
+
+    // the rows [0, height) of a frame, or of a field with its doubled strides.
+    const auto convert_frame = [&](unsigned char *const dst[3], const int stride[3], const unsigned char *src,
+                                   const int src_row_stride, const int height) {
+        const auto convert_rows = [&](int first_row, int last_row) {
+            if (fixed_rows)
+                fixed_rows(dst, stride, src, src_row_stride, first_row, last_row);
+            else if (config_.tile_width > 0)
+                convert_rows_420_tiled(converters, format_, dst, stride, src, src_row_stride, width_,
+                    first_row, last_row, config_.tile_width);
+            else
+                convert_rows_420(converters, dst, stride, src, src_row_stride, width_, first_row, last_row);
+        };
+
+        const auto convert_band = [&](int first_row, int last_row) {
+            if (!config_.padded || config_.interlaced)
+            {
+                convert_rows(first_row, last_row);
+                return;
+            }
+
+            for (int row = first_row; row < last_row; row += padding_chunk_height)
+            {
+                const auto chunk_last_row = std::min(last_row, row + padding_chunk_height);
+                convert_rows(row, chunk_last_row);
+                pad_rows_420(dst, stride, width_, height_, config_.padding, row, chunk_last_row, config_.mode);
+            }
+        };
+
+        if (config_.band_height <= 0 || config_.band_height >= height)
+        {
+            convert_band(0, height);
+            return;
+        }
+
+        parallel_bands(height, config_.band_height, convert_band);
+    };
+
+    if (!config_.interlaced)
+    {
+        convert_frame(destination, dst_stride, source, src_stride, height_);
+        return;
+    }
+
+    for (int index = 0; index < 2; ++index)
+    {
+        const auto field = get_field_420(destination, dst_stride, source, src_stride, height_, index);
+        convert_frame(field.destination, field.dst_stride, field.source, field.src_stride, field.paired_height);
+        for (int row = field.paired_height; row < field.height; ++row)
+            converters.y_row(field.source + row * field.src_stride, field.destination[0] + row * field.dst_stride[0], width_);
+    }
+
+    if (config_.padded)
+        pad_rows_420(destination, dst_stride, width_, height_, config_.padding, 0, height_, config_.mode);
+}
+
+} // namespace yuvconvert
@@ -0,0 +1,183 @@
+/* Copyright(c) 2018 Steven Hoving
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "cpu_features.h"
+
+#include <cstring>
+
+#if YUVCONVERT_X86
+#if defined(_MSC_VER)
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#endif
+#endif
+
+namespace yuvconvert
+{
+
+#if YUVCONVERT_X86
+
+static void cpuid(unsigned int leaf, unsigned int subleaf, unsigned int regs[4]) noexcept
+{
+#if defined(_MSC_VER)
+    int info[4];
+    __cpuidex(info, static_cast<int>(leaf), static_cast<int>(subleaf));
+    for (int i = 0; i < 4; ++i)
+        regs[i] = static_cast<unsigned int>(info[i]);
+#else
+    __cpuid_count(leaf, subleaf, regs[0], regs[1], regs[2], regs[3]);
+#endif
+}
+
+static unsigned long long xgetbv0() noexcept
+{
+#if defined(_MSC_VER)
+    return _xgetbv(0);
+#else
+    unsigned int eax = 0;
+    unsigned int edx = 0;
+    __asm__ volatile("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+    return (static_cast<unsigned long long>(edx) << 32) | eax;
+#endif
+}
+
+static void detect_cache_sizes(unsigned int max_leaf, unsigned int max_extended_leaf, cpu_features &result) noexcept
+{
+    unsigned int regs[4] = {};
+
+    // the deterministic cache parameters, one subleaf per cache (intel).
+    if (max_leaf >= 4)
+    {
+        for (unsigned int index = 0; index < 16; ++index)
+        {
+            cpuid(4, index, regs);
+            const auto type = regs[0] & 0x1f;
+            if (type == 0)
+                break;
+
+            const auto level = (regs[0] >> 5) & 0x7;
+            const auto ways = (regs[1] >> 22) + 1;
+            const auto partitions = ((regs[1] >> 12) & 0x3ff) + 1;
+            const auto line_size = (regs[1] & 0xfff) + 1;
+            const auto sets = regs[2] + 1;
+            const auto size = ways * partitions * line_size * sets;
+
+            // type 1 is a data cache, type 3 a unified cache.
+            if (level == 1 && type == 1)
+                result.l1d_cache_size = size;
+            else if (level == 2 && (type == 1 || type == 3))
+                result.l2_cache_size = size;
+        }
+    }
+
+    // the sizes in KiB from the extended leaves (amd, and the l2 size on intel as well).
+    if (result.l1d_cache_size == 0 && max_extended_leaf >= 0x80000005u)
+    {
+        cpuid(0x80000005u, 0, regs);
+        result.l1d_cache_size = (regs[2] >> 24) * 1024;
+    }
+
+    if (result.l2_cache_size == 0 && max_extended_leaf >= 0x80000006u)
+    {
+        cpuid(0x80000006u, 0, regs);
+        result.l2_cache_size = (regs[2] >> 16) * 1024;
+    }
+}
+
+static cpu_features detect_cpu_features() noexcept
+{
+    cpu_features result;
+
+    unsigned int regs[4] = {};
+    cpuid(0, 0, regs);
+    const auto max_leaf = regs[0];
+    if (max_leaf < 1)
+        return result;
+
+    cpuid(1, 0, regs);
+    const auto ecx = regs[2];
+    const auto edx = regs[3];
+    result.sse2 = (edx & (1u << 26)) != 0;
+    result.ssse3 = (ecx & (1u << 9)) != 0;
+    result.sse41 = (ecx & (1u << 19)) != 0;
+
+    // avx state must be enabled by the os before we can use ymm registers.
+    const auto osxsave = (ecx & (1u << 27)) != 0;
+    const auto avx = (ecx & (1u << 28)) != 0;
+    const auto ymm_enabled = osxsave && avx && ((xgetbv0() & 0x6) == 0x6);
+    result.fma = ymm_enabled && (ecx & (1u << 12)) != 0;
+
+    if (max_leaf >= 7)
+    {
+        cpuid(7, 0, regs);
+        result.avx2 = ymm_enabled && (regs[1] & (1u << 5)) != 0;
+    }
+
+    cpuid(0x80000000u, 0, regs);
+    const auto max_extended_leaf = regs[0];
+
+    detect_cache_sizes(max_leaf, max_extended_leaf, result);
+
+    // the brand string is spread over 3 extended leaves of 16 bytes each.
+    if (max_extended_leaf >= 0x80000004u)
+    {
+        for (int i = 0; i < 3; ++i)
+        {
+            cpuid(0x80000002u + i, 0, regs);
+            std::memcpy(result.model + i * 16, regs, 16);
+        }
+    }
+
+    return result;
+}
+#else
+// there are no x86 kernels to detect features for.
+static cpu_features detect_cpu_features() noexcept
+{
+    return {};
+}
+#endif
+
+const cpu_features &get_cpu_features() noexcept
+{
+    static const cpu_features features = detect_cpu_features();
+    return features;
+}
+
+simd_mode supported_simd_mode(simd_mode mode) noexcept
+{
+    if (mode == simd_mode::plain_c)
+        return mode;
+
+    if (mode != simd_mode::portable && get_cpu_features().ssse3)
+        return mode;
+
+    return YUVCONVERT_VECTOR_EXTENSIONS ? simd_mode::portable : simd_mode::plain_c;
+}
+
+bool use_x86_kernels(simd_mode mode) noexcept
+{
+    const auto supported = supported_simd_mode(mode);
+    return supported == simd_mode::ssse3 || supported == simd_mode::avx2;
+}
+
+} // namespace yuvconvert
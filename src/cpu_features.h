@@ -0,0 +1,72 @@
+/* Copyright(c) 2018 Steven Hoving
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include "yuvconvert.h"
+#include "simd_utility.h"
+
+namespace yuvconvert
+{
+
+struct cpu_features
+{
+    bool sse2{false};
+    bool ssse3{false};
+    bool sse41{false};
+    bool avx2{false};
+    bool fma{false};
+
+    // the size in bytes of the level 1 data cache and the level 2 cache of a core, 0 if unknown.
+    unsigned int l1d_cache_size{0};
+    unsigned int l2_cache_size{0};
+
+    // the processor brand string, for example "Intel(R) Core(TM) i7-8700 CPU @ 3.20GHz".
+    char model[49]{};
+};
+
+// the instruction sets supported by this cpu (and enabled by the os), detected once.
+const cpu_features &get_cpu_features() noexcept;
+
+// the mode the kernels actually run in on this cpu. ssse3 and avx2 fall back to portable (or plain_c
+// when the compiler has no vector extensions) off x86 and on a cpu without ssse3, the avx2 kernels
+// check for avx2 themselves.
+simd_mode supported_simd_mode(simd_mode mode) noexcept;
+
+// true when the ssse3 kernels (and where there are some, the avx2 kernels) run for mode.
+bool use_x86_kernels(simd_mode mode) noexcept;
+
+// picks kernel when the x86 kernels run for mode and fallback otherwise. Off x86 the x86 kernels are
+// not built, so there the reference is dropped.
+#if YUVCONVERT_X86
+#define select_x86_kernel(mode, kernel, fallback) (use_x86_kernels(mode) ? (kernel) : (fallback))
+#else
+#define select_x86_kernel(mode, kernel, fallback) (fallback)
+#endif
+
+// picks kernel when the portable kernels run for mode and fallback otherwise.
+template <typename kernel_type>
+kernel_type *select_portable_kernel(simd_mode mode, kernel_type *kernel, kernel_type *fallback) noexcept
+{
+    return supported_simd_mode(mode) == simd_mode::portable ? kernel : fallback;
+}
+
+} // namespace yuvconvert
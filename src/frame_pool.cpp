@@ -0,0 +1,210 @@
+/* Copyright(c) 2018 Steven Hoving
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "yuvconvert_frame_pool.h"
+#include "simd_utility.h"
+
+#include <new>
+
+#if defined(_WIN32)
+#include <malloc.h>
+#else
+#include <sys/mman.h>
+#endif
+
+namespace yuvconvert
+{
+
+// huge pages are 2 MiB on every platform we map them on.
+constexpr std::size_t huge_page_size = 2 * 1024 * 1024;
+constexpr std::size_t page_size = 4096;
+
+frame_pool::frame_pool(frame_format format, int width, int height, page_backing backing)
+    : format_(format)
+    , width_(width)
+    , height_(height)
+    , backing_(backing)
+{
+    const auto chroma_width = (width + 1) >> 1;
+    const auto chroma_height = (height + 1) >> 1;
+
+    int rows[3]{0, 0, 0};
+    switch (format)
+    {
+    case frame_format::i420:
+        stride_[0] = simd::align_up(width, frame_alignment);
+        stride_[1] = simd::align_up(chroma_width, frame_alignment);
+        stride_[2] = stride_[1];
+        rows[0] = height;
+        rows[1] = chroma_height;
+        rows[2] = chroma_height;
+        break;
+    case frame_format::nv12:
+        stride_[0] = simd::align_up(width, frame_alignment);
+        stride_[1] = simd::align_up(chroma_width * 2, frame_alignment);
+        rows[0] = height;
+        rows[1] = chroma_height;
+        break;
+    case frame_format::bgra:
+        stride_[0] = simd::align_up(width * 4, frame_alignment);
+        rows[0] = height;
+        break;
+    }
+
+    // every stride is a multiple of the alignment, so every plane starts aligned as well.
+    for (int i = 0; i < 3; ++i)
+    {
+        plane_offset_[i] = frame_size_;
+        frame_size_ += static_cast<std::size_t>(stride_[i]) * rows[i];
+    }
+}
+
+static void free_frame_memory(unsigned char *data, const std::size_t size) noexcept
+{
+#if defined(_WIN32)
+    (void)size;
+    _aligned_free(data);
+#else
+    munmap(data, size);
+#endif
+}
+
+frame_pool::~frame_pool()
+{
+    for (const auto &itr : allocations_)
+        free_frame_memory(itr.data, itr.size);
+}
+
+frame frame_pool::acquire()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!free_.empty())
+        {
+            const auto data = free_.back();
+            free_.pop_back();
+            return make_frame(data);
+        }
+    }
+
+    const auto data = allocate();
+    return make_frame(data);
+}
+
+void frame_pool::release(const frame &value)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    free_.push_back(value.planes[0]);
+}
+
+void frame_pool::reserve(int count)
+{
+    std::vector<unsigned char *> reserved;
+    reserved.reserve(count);
+    for (int i = 0; i < count; ++i)
+        reserved.push_back(allocate());
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    free_.insert(free_.end(), reserved.begin(), reserved.end());
+}
+
+std::size_t frame_pool::allocated_count() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return allocations_.size();
+}
+
+unsigned char *frame_pool::allocate()
+{
+    allocation result{nullptr, frame_size_};
+
+#if defined(_WIN32)
+    // large pages need a privilege most processes do not have, so windows always uses normal pages.
+    result.data = static_cast<unsigned char *>(_aligned_malloc(result.size, frame_alignment));
+#else
+    void *data = MAP_FAILED;
+#if defined(MAP_HUGETLB)
+    if (backing_ == page_backing::huge_pages)
+    {
+        const auto size = simd::align_up(frame_size_, huge_page_size);
+        data = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+        if (data != MAP_FAILED)
+            result.size = size;
+    }
+#endif
+
+#if defined(MADV_HUGEPAGE)
+    // the kernel only backs whole huge pages, without rounding up the end of the frame stays on normal pages.
+    if (backing_ == page_backing::transparent_huge_pages)
+        result.size = simd::align_up(frame_size_, huge_page_size);
+#endif
+
+    if (data == MAP_FAILED)
+        data = mmap(nullptr, result.size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+
+    if (data != MAP_FAILED)
+    {
+        result.data = static_cast<unsigned char *>(data);
+
+#if defined(MADV_HUGEPAGE)
+        if (backing_ == page_backing::transparent_huge_pages)
+            madvise(data, result.size, MADV_HUGEPAGE);
+#endif
+    }
+#endif
+
+    if (!result.data)
+        throw std::bad_alloc();
+
+    // fault the pages in now instead of in the middle of the first conversion.
+    for (std::size_t offset = 0; offset < result.size; offset += page_size)
+        result.data[offset] = 0;
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    try
+    {
+        allocations_.push_back(result);
+    }
+    catch (...)
+    {
+        free_frame_memory(result.data, result.size);
+        throw;
+    }
+    return result.data;
+}
+
+frame frame_pool::make_frame(unsigned char *data) const noexcept
+{
+    frame result;
+    result.width = width_;
+    result.height = height_;
+    result.format = format_;
+    for (int i = 0; i < 3; ++i)
+    {
+        if (stride_[i] == 0)
+            continue;
+        result.planes[i] = data + plane_offset_[i];
+        result.stride[i] = stride_[i];
+    }
+    return result;
+}
+
+} // namespace yuvconvert
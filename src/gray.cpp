@@ -0,0 +1,89 @@
+/* Copyright(c) 2018 Steven Hoving
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "to_420_c.h"
+#include "to_420_ssse3.h"
+#include "to_420_portable.h"
+#include "plane_c.h"
+#include "plane_ssse3.h"
+#include "row_converter.h"
+#include "cpu_features.h"
+#include "yuvconvert.h"
+
+namespace yuvconvert
+{
+
+static void bgrx_to_y(unsigned char *destination, const int dst_stride, const unsigned char *source,
+    const int src_stride, const int width, const int height, bgrx_row_to_y_row *y_row_converter)
+{
+    for (int line = 0; line < height; ++line)
+    {
+        y_row_converter(source, destination, width);
+        source += src_stride;
+        destination += dst_stride;
+    }
+}
+
+void bgr_to_y(unsigned char *destination, const int dst_stride, const unsigned char *source, const int src_stride,
+    const int width, const int height, simd_mode mode)
+{
+    bgrx_to_y(destination, dst_stride, source, src_stride, width, height,
+        select_x86_kernel(mode, bgr_row_to_y_row_ssse3,
+            select_portable_kernel(mode, bgr_row_to_y_row_portable, bgr_row_to_y_row_c)));
+}
+
+void bgra_to_y(unsigned char *destination, const int dst_stride, const unsigned char *source, const int src_stride,
+    const int width, const int height, simd_mode mode)
+{
+    bgrx_to_y(destination, dst_stride, source, src_stride, width, height,
+        select_x86_kernel(mode, bgra_row_to_y_row_ssse3,
+            select_portable_kernel(mode, bgra_row_to_y_row_portable, bgra_row_to_y_row_c)));
+}
+
+void gray8_to_420(unsigned char *destination[3], const int dst_stride[3], const unsigned char *source,
+    const int src_stride, const int width, const int height, simd_mode mode)
+{
+    plane_copy_row *copy_row = select_x86_kernel(mode, copy_row_ssse3, copy_row_c);
+    plane_fill_row *fill_row = select_x86_kernel(mode, fill_row_ssse3, fill_row_c);
+
+    auto y = destination[0];
+    for (int line = 0; line < height; ++line)
+    {
+        copy_row(source, y, width);
+        source += src_stride;
+        y += dst_stride[0];
+    }
+
+    // gray has no colour, which is 128 for both u and v.
+    const auto chroma_width = (width + 1) >> 1;
+    const auto chroma_height = (height + 1) >> 1;
+    auto u = destination[1];
+    auto v = destination[2];
+    for (int line = 0; line < chroma_height; ++line)
+    {
+        fill_row(u, 128, chroma_width);
+        fill_row(v, 128, chroma_width);
+        u += dst_stride[1];
+        v += dst_stride[2];
+    }
+}
+
+} // namespace yuvconvert
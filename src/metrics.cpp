@@ -0,0 +1,194 @@
+/* Copyright(c) 2018 Steven Hoving
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "yuvconvert_metrics.h"
+#include "metrics_c.h"
+#include "metrics_ssse3.h"
+#include "metrics_avx2.h"
+#include "cpu_features.h"
+#include "thread_pool.h"
+#include "yuvconvert_common.h"
+
+#include <atomic>
+#include <cmath>
+#include <vector>
+
+namespace yuvconvert
+{
+
+using sum_square_error_row = std::uint64_t(const unsigned char *a, const unsigned char *b, const int width);
+using ssim_row_8x8 = double(const unsigned char *a, const int a_stride, const unsigned char *b, const int b_stride,
+    const int width);
+
+static sum_square_error_row *get_sum_square_error_row(simd_mode mode)
+{
+#if YUVCONVERT_X86
+    if (use_x86_kernels(mode))
+        return (mode == simd_mode::avx2 && get_cpu_features().avx2) ? sum_square_error_row_avx2
+                                                                    : sum_square_error_row_ssse3;
+#endif
+    return sum_square_error_row_c;
+}
+
+static ssim_row_8x8 *get_ssim_row_8x8(simd_mode mode)
+{
+    // there is no avx2 ssim kernel, a window is only 8 pixels wide.
+    return select_x86_kernel(mode, ssim_row_8x8_ssse3, ssim_row_8x8_c);
+}
+
+std::uint64_t plane_sse(const unsigned char *a, const int a_stride, const unsigned char *b, const int b_stride,
+    const int width, const int height, simd_mode mode)
+{
+    const auto row_sse = get_sum_square_error_row(mode);
+
+    std::atomic<std::uint64_t> sse{0};
+    parallel_bands(height, default_band_height, [&](int first_row, int last_row) {
+        std::uint64_t band_sse = 0;
+        for (int line = first_row; line < last_row; ++line)
+            band_sse += row_sse(a + line * a_stride, b + line * b_stride, width);
+        sse += band_sse;
+    });
+    return sse;
+}
+
+double plane_ssim(const unsigned char *a, const int a_stride, const unsigned char *b, const int b_stride,
+    const int width, const int height, simd_mode mode)
+{
+    if (width <= 0 || height <= 0)
+        return 1.0;
+
+    // too small for a single 8x8 window, use one window that covers the whole plane.
+    if (width < 8 || height < 8)
+        return ssim_similarity(ssim_window_sums_c(a, a_stride, b, b_stride, width, height), width * height);
+
+    const auto ssim_row = get_ssim_row_8x8(mode);
+
+    // windows are placed every 4 pixels, both horizontally and vertically.
+    const auto window_rows = (height - 8) / 4 + 1;
+    const auto window_columns = (width - 8) / 4 + 1;
+
+    std::vector<double> band_ssim((window_rows + default_band_height - 1) / default_band_height, 0.0);
+    parallel_bands(window_rows, default_band_height, [&](int first_row, int last_row) {
+        double ssim = 0.0;
+        for (int row = first_row; row < last_row; ++row)
+            ssim += ssim_row(a + row * 4 * a_stride, a_stride, b + row * 4 * b_stride, b_stride, width);
+        band_ssim[first_row / default_band_height] = ssim;
+    });
+
+    double ssim = 0.0;
+    for (const auto value : band_ssim)
+        ssim += value;
+    return ssim / (static_cast<double>(window_rows) * window_columns);
+}
+
+double psnr(const std::uint64_t sse, const std::uint64_t samples) noexcept
+{
+    const auto peak = 255.0 * 255.0 * static_cast<double>(samples);
+    const auto min_sse = peak / std::pow(10.0, max_psnr / 10.0);
+    const auto clamped_sse = std::max(static_cast<double>(sse), min_sse);
+    return 10.0 * std::log10(peak / clamped_sse);
+}
+
+static frame_metrics compare_planes(const unsigned char *const a[3], const int a_stride[3],
+    const unsigned char *const b[3], const int b_stride[3], const int width[3], const int height[3],
+    simd_mode mode)
+{
+    frame_metrics result;
+    std::uint64_t total_sse = 0;
+    std::uint64_t total_samples = 0;
+    for (int plane = 0; plane < 3; ++plane)
+    {
+        const auto samples = static_cast<std::uint64_t>(width[plane]) * height[plane];
+        result.sse[plane] = plane_sse(a[plane], a_stride[plane], b[plane], b_stride[plane], width[plane],
+            height[plane], mode);
+        result.psnr[plane] = psnr(result.sse[plane], samples);
+        result.ssim[plane] = plane_ssim(a[plane], a_stride[plane], b[plane], b_stride[plane], width[plane],
+            height[plane], mode);
+
+        total_sse += result.sse[plane];
+        total_samples += samples;
+    }
+    result.psnr_all = psnr(total_sse, total_samples);
+    return result;
+}
+
+frame_metrics compare_420(const unsigned char *const a[3], const int a_stride[3],
+    const unsigned char *const b[3], const int b_stride[3], const int width, const int height,
+    simd_mode mode)
+{
+    const auto chroma_width = (width + 1) >> 1;
+    const auto chroma_height = (height + 1) >> 1;
+    const int plane_width[3] = {width, chroma_width, chroma_width};
+    const int plane_height[3] = {height, chroma_height, chroma_height};
+
+    auto result = compare_planes(a, a_stride, b, b_stride, plane_width, plane_height, mode);
+    result.ssim_all = 0.8 * result.ssim[0] + 0.1 * (result.ssim[1] + result.ssim[2]);
+    return result;
+}
+
+frame_metrics compare_bgra_to_420(const unsigned char *const source[3], const int src_stride[3],
+    const unsigned char *const yuv[3], const int yuv_stride[3], const int width, const int height,
+    simd_mode mode)
+{
+    const auto plane_size = static_cast<std::size_t>(width) * height;
+    std::vector<unsigned char> planes(plane_size * 6);
+
+    unsigned char *const original[3] = {&planes[0], &planes[plane_size], &planes[plane_size * 2]};
+    unsigned char *const round_trip[3] = {&planes[plane_size * 3], &planes[plane_size * 4], &planes[plane_size * 5]};
+
+    // split the source into b, g and r planes, and convert the yuv frame back to b, g and r planes.
+    parallel_bands(height, default_band_height, [&](int first_row, int last_row) {
+        for (int line = first_row; line < last_row; ++line)
+        {
+            const auto src = source[0] + line * src_stride[0];
+            const auto y = yuv[0] + line * yuv_stride[0];
+            const auto u = yuv[1] + (line >> 1) * yuv_stride[1];
+            const auto v = yuv[2] + (line >> 1) * yuv_stride[2];
+            const auto offset = static_cast<std::size_t>(line) * width;
+
+            for (int x = 0; x < width; ++x)
+            {
+                original[0][offset + x] = src[x * 4 + 0];
+                original[1][offset + x] = src[x * 4 + 1];
+                original[2][offset + x] = src[x * 4 + 2];
+
+                const auto y_value = y[x];
+                const auto u_value = u[x >> 1];
+                const auto v_value = v[x >> 1];
+                round_trip[0][offset + x] = yuv2b(y_value, u_value, v_value);
+                round_trip[1][offset + x] = yuv2g(y_value, u_value, v_value);
+                round_trip[2][offset + x] = yuv2r(y_value, u_value, v_value);
+            }
+        }
+    });
+
+    const unsigned char *const a[3] = {original[0], original[1], original[2]};
+    const unsigned char *const b[3] = {round_trip[0], round_trip[1], round_trip[2]};
+    const int stride[3] = {width, width, width};
+    const int plane_width[3] = {width, width, width};
+    const int plane_height[3] = {height, height, height};
+
+    auto result = compare_planes(a, stride, b, stride, plane_width, plane_height, mode);
+    result.ssim_all = (result.ssim[0] + result.ssim[1] + result.ssim[2]) / 3.0;
+    return result;
+}
+
+} // namespace yuvconvert
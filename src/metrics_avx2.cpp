@@ -0,0 +1,69 @@
+/* Copyright(c) 2018 Steven Hoving
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "metrics_avx2.h"
+#include "metrics_c.h"
+
+#include "simd_utility.h"
+
+#include <immintrin.h>
+
+std::uint64_t sum_square_error_row_avx2(const unsigned char *a, const unsigned char *b, const int width)
+{
+    // every block adds at most 2 * 2 * 255^2 to a 32 bit lane, flush before it can overflow.
+    constexpr auto blocks_per_flush = 8192;
+
+    const int aligned_width = simd::align_down(width, 32);
+    const auto zero = _mm256_setzero_si256();
+
+    std::uint64_t sse = 0;
+    int x = 0;
+    while (x < aligned_width)
+    {
+        auto acc = _mm256_setzero_si256();
+        // no std::min, its instantiation in this object would be a weak symbol built with avx2.
+        const auto flush_end = x + blocks_per_flush * 32;
+        const auto end = (flush_end < aligned_width) ? flush_end : aligned_width;
+
+        __no_unroll
+        for (; x < end; x += 32)
+        {
+            const auto pxl_a = _mm256_loadu_si256((const __m256i *)(a + x));
+            const auto pxl_b = _mm256_loadu_si256((const __m256i *)(b + x));
+
+            const auto diff = _mm256_or_si256(_mm256_subs_epu8(pxl_a, pxl_b), _mm256_subs_epu8(pxl_b, pxl_a));
+            const auto diff_lo = _mm256_unpacklo_epi8(diff, zero);
+            const auto diff_hi = _mm256_unpackhi_epi8(diff, zero);
+
+            acc = _mm256_add_epi32(acc, _mm256_madd_epi16(diff_lo, diff_lo));
+            acc = _mm256_add_epi32(acc, _mm256_madd_epi16(diff_hi, diff_hi));
+        }
+
+        const auto acc64 = _mm256_add_epi64(_mm256_unpacklo_epi32(acc, zero), _mm256_unpackhi_epi32(acc, zero));
+        const auto sum = _mm_add_epi64(_mm256_castsi256_si128(acc64), _mm256_extracti128_si256(acc64, 1));
+
+        alignas(16) std::uint64_t result[2];
+        _mm_store_si128((__m128i *)result, sum);
+        sse += result[0] + result[1];
+    }
+
+    return sse + sum_square_error_row_c(a + x, b + x, width - x);
+}
@@ -0,0 +1,86 @@
+/* Copyright(c) 2018 Steven Hoving
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "metrics_c.h"
+
+// 64^2 * (0.01 * 255)^2 and 64^2 * (0.03 * 255)^2, the constants are scaled for an 8x8 window.
+constexpr std::int64_t cc1 = 26634;
+constexpr std::int64_t cc2 = 239708;
+
+double ssim_similarity(const ssim_window_sums &sums, const int count) noexcept
+{
+    const auto n = static_cast<double>(count);
+    const auto c1 = static_cast<double>((cc1 * count * count) >> 12);
+    const auto c2 = static_cast<double>((cc2 * count * count) >> 12);
+
+    const auto sum_a = static_cast<double>(sums.sum_a);
+    const auto sum_b = static_cast<double>(sums.sum_b);
+
+    const auto numerator = (2.0 * sum_a * sum_b + c1) *
+        (2.0 * n * sums.sum_ab - 2.0 * sum_a * sum_b + c2);
+
+    const auto denominator = (sum_a * sum_a + sum_b * sum_b + c1) *
+        (n * sums.sum_sq_a - sum_a * sum_a + n * sums.sum_sq_b - sum_b * sum_b + c2);
+
+    return numerator / denominator;
+}
+
+std::uint64_t sum_square_error_row_c(const unsigned char *a, const unsigned char *b, const int width)
+{
+    std::uint64_t sse = 0;
+    for (int x = 0; x < width; ++x)
+    {
+        const int diff = a[x] - b[x];
+        sse += static_cast<std::uint32_t>(diff * diff);
+    }
+    return sse;
+}
+
+ssim_window_sums ssim_window_sums_c(const unsigned char *a, const int a_stride, const unsigned char *b,
+    const int b_stride, const int width, const int height)
+{
+    ssim_window_sums sums{0, 0, 0, 0, 0};
+    for (int line = 0; line < height; ++line)
+    {
+        for (int x = 0; x < width; ++x)
+        {
+            const std::uint32_t value_a = a[x];
+            const std::uint32_t value_b = b[x];
+            sums.sum_a += value_a;
+            sums.sum_b += value_b;
+            sums.sum_sq_a += value_a * value_a;
+            sums.sum_sq_b += value_b * value_b;
+            sums.sum_ab += value_a * value_b;
+        }
+        a += a_stride;
+        b += b_stride;
+    }
+    return sums;
+}
+
+double ssim_row_8x8_c(const unsigned char *a, const int a_stride, const unsigned char *b, const int b_stride,
+    const int width)
+{
+    double ssim = 0.0;
+    for (int x = 0; x + 8 <= width; x += 4)
+        ssim += ssim_similarity(ssim_window_sums_c(a + x, a_stride, b + x, b_stride, 8, 8), 64);
+    return ssim;
+}
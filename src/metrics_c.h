@@ -0,0 +1,46 @@
+/* Copyright(c) 2018 Steven Hoving
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include <cstdint>
+
+// the 5 sums the ssim of a window is calculated from.
+struct ssim_window_sums
+{
+    std::uint32_t sum_a;
+    std::uint32_t sum_b;
+    std::uint32_t sum_sq_a;
+    std::uint32_t sum_sq_b;
+    std::uint32_t sum_ab;
+};
+
+// ssim of a window from its sums, count is the number of pixels in the window.
+double ssim_similarity(const ssim_window_sums &sums, const int count) noexcept;
+
+std::uint64_t sum_square_error_row_c(const unsigned char *a, const unsigned char *b, const int width);
+
+ssim_window_sums ssim_window_sums_c(const unsigned char *a, const int a_stride, const unsigned char *b,
+    const int b_stride, const int width, const int height);
+
+// sum of the ssim of all 8x8 windows (every 4 pixels) of a row of windows.
+double ssim_row_8x8_c(const unsigned char *a, const int a_stride, const unsigned char *b, const int b_stride,
+    const int width);
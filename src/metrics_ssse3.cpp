@@ -0,0 +1,126 @@
+/* Copyright(c) 2018 Steven Hoving
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "metrics_ssse3.h"
+#include "metrics_c.h"
+
+#include "simd_utility.h"
+
+#include <emmintrin.h>
+#include <tmmintrin.h>
+#include <algorithm>
+
+// sum the 4 unsigned 32 bit lanes.
+static __forceinline std::uint64_t hsum_epu32(__m128i value)
+{
+    const auto zero = _mm_setzero_si128();
+    auto sum = _mm_add_epi64(_mm_unpacklo_epi32(value, zero), _mm_unpackhi_epi32(value, zero));
+    sum = _mm_add_epi64(sum, _mm_srli_si128(sum, 8));
+
+    alignas(16) std::uint64_t result[2];
+    _mm_store_si128((__m128i *)result, sum);
+    return result[0];
+}
+
+std::uint64_t sum_square_error_row_ssse3(const unsigned char *a, const unsigned char *b, const int width)
+{
+    // every block adds at most 2 * 2 * 255^2 to a 32 bit lane, flush before it can overflow.
+    constexpr auto blocks_per_flush = 8192;
+
+    const int aligned_width = simd::align_down(width, 16);
+    const auto zero = _mm_setzero_si128();
+
+    std::uint64_t sse = 0;
+    int x = 0;
+    while (x < aligned_width)
+    {
+        auto acc = _mm_setzero_si128();
+        const auto end = std::min(aligned_width, x + blocks_per_flush * 16);
+
+        __no_unroll
+        for (; x < end; x += 16)
+        {
+            const auto pxl_a = _mm_loadu_si128((const __m128i *)(a + x));
+            const auto pxl_b = _mm_loadu_si128((const __m128i *)(b + x));
+
+            // |a - b| fits in 8 bits, unpack to 16 bit and let madd square and pair wise add.
+            const auto diff = _mm_or_si128(_mm_subs_epu8(pxl_a, pxl_b), _mm_subs_epu8(pxl_b, pxl_a));
+            const auto diff_lo = _mm_unpacklo_epi8(diff, zero);
+            const auto diff_hi = _mm_unpackhi_epi8(diff, zero);
+
+            acc = _mm_add_epi32(acc, _mm_madd_epi16(diff_lo, diff_lo));
+            acc = _mm_add_epi32(acc, _mm_madd_epi16(diff_hi, diff_hi));
+        }
+        sse += hsum_epu32(acc);
+    }
+
+    return sse + sum_square_error_row_c(a + x, b + x, width - x);
+}
+
+// this function sums an 8x8 window.
+static __forceinline ssim_window_sums ssim_window_sums_8x8_ssse3(const unsigned char *a, const int a_stride,
+    const unsigned char *b, const int b_stride)
+{
+    const auto zero = _mm_setzero_si128();
+
+    // 8 rows of 255 still fit the 16 bit lanes.
+    auto sum_a = _mm_setzero_si128();
+    auto sum_b = _mm_setzero_si128();
+    auto sum_sq_a = _mm_setzero_si128();
+    auto sum_sq_b = _mm_setzero_si128();
+    auto sum_ab = _mm_setzero_si128();
+
+    for (int line = 0; line < 8; ++line)
+    {
+        const auto pxl_a = _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i *)a), zero);
+        const auto pxl_b = _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i *)b), zero);
+
+        sum_a = _mm_add_epi16(sum_a, pxl_a);
+        sum_b = _mm_add_epi16(sum_b, pxl_b);
+        sum_sq_a = _mm_add_epi32(sum_sq_a, _mm_madd_epi16(pxl_a, pxl_a));
+        sum_sq_b = _mm_add_epi32(sum_sq_b, _mm_madd_epi16(pxl_b, pxl_b));
+        sum_ab = _mm_add_epi32(sum_ab, _mm_madd_epi16(pxl_a, pxl_b));
+
+        a += a_stride;
+        b += b_stride;
+    }
+
+    const auto ones = _mm_set1_epi16(1);
+    return {
+        static_cast<std::uint32_t>(hsum_epu32(_mm_madd_epi16(sum_a, ones))),
+        static_cast<std::uint32_t>(hsum_epu32(_mm_madd_epi16(sum_b, ones))),
+        static_cast<std::uint32_t>(hsum_epu32(sum_sq_a)),
+        static_cast<std::uint32_t>(hsum_epu32(sum_sq_b)),
+        static_cast<std::uint32_t>(hsum_epu32(sum_ab))
+    };
+}
+
+double ssim_row_8x8_ssse3(const unsigned char *a, const int a_stride, const unsigned char *b, const int b_stride,
+    const int width)
+{
+    double ssim = 0.0;
+
+    __no_unroll
+    for (int x = 0; x + 8 <= width; x += 4)
+        ssim += ssim_similarity(ssim_window_sums_8x8_ssse3(a + x, a_stride, b + x, b_stride), 64);
+
+    return ssim;
+}
@@ -0,0 +1,89 @@
+/* Copyright(c) 2018 Steven Hoving
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "to_420.h"
+#include "plane_c.h"
+#include "plane_ssse3.h"
+#include "cpu_features.h"
+#include "yuvconvert.h"
+
+#include <algorithm>
+
+namespace yuvconvert
+{
+
+static int round_up(const int size, const int alignment)
+{
+    return ((size + alignment - 1) / alignment) * alignment;
+}
+
+void pad_rows_420(unsigned char *const destination[3], const int dst_stride[3], const int width, const int height,
+    const output_padding &padding, const int first_row, const int last_row, simd_mode mode)
+{
+    if (width <= 0 || height <= 0)
+        return;
+
+    plane_copy_row *copy_row = select_x86_kernel(mode, copy_row_ssse3, copy_row_c);
+    plane_fill_row *fill_row = select_x86_kernel(mode, fill_row_ssse3, fill_row_c);
+
+    const auto alignment = std::max(1, padding.alignment);
+    const auto border = std::max(0, (padding.border + 1) & ~1);
+    const auto padded_width = round_up(width, alignment);
+    const auto padded_height = round_up(height, alignment);
+
+    for (int plane = 0; plane < 3; ++plane)
+    {
+        // the chroma planes are half the size of luma, rounded up.
+        const auto shift = (plane == 0) ? 0 : 1;
+        const auto plane_width = (width + shift) >> shift;
+        const auto plane_height = (height + shift) >> shift;
+        const auto plane_padded_width = (padded_width + shift) >> shift;
+        const auto plane_padded_height = (padded_height + shift) >> shift;
+        const auto plane_border = border >> shift;
+        const auto row_width = plane_border + plane_padded_width + plane_border;
+        const auto stride = dst_stride[plane];
+        const auto first = first_row >> shift;
+        const auto last = (last_row + shift) >> shift;
+
+        for (int line = first; line < last; ++line)
+        {
+            auto row = destination[plane] + line * stride;
+            fill_row(row - plane_border, row[0], plane_border);
+            fill_row(row + plane_width, row[plane_width - 1], plane_padded_width - plane_width + plane_border);
+        }
+
+        if (first == 0)
+        {
+            const auto top = destination[plane] - plane_border;
+            for (int line = 1; line <= plane_border; ++line)
+                copy_row(top, top - line * stride, row_width);
+        }
+
+        if (last == plane_height)
+        {
+            const auto bottom = destination[plane] + (plane_height - 1) * stride - plane_border;
+            for (int line = plane_height; line < plane_padded_height + plane_border; ++line)
+                copy_row(bottom, bottom + (line - plane_height + 1) * stride, row_width);
+        }
+    }
+}
+
+} // namespace yuvconvert
@@ -0,0 +1,93 @@
+/* Copyright(c) 2018 Steven Hoving
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "plane_avx2.h"
+#include "plane_c.h"
+
+#include "simd_utility.h"
+
+#include <immintrin.h>
+
+// 32 sample pairs per iteration. The byte unpacks and shuffles work within a 128 bit lane, the
+// lanes are put back in order with a cross lane permute.
+void interleave_row_avx2(const unsigned char *src_u, const unsigned char *src_v, unsigned char *dst, const int width)
+{
+    const int block_width = simd::align_down(width, 32);
+
+    __no_unroll
+    for (int x = 0; x < block_width; x += 32)
+    {
+        const auto u = _mm256_loadu_si256((const __m256i *)(src_u + x));
+        const auto v = _mm256_loadu_si256((const __m256i *)(src_v + x));
+
+        // lo holds the pairs 0..7 and 16..23, hi the pairs 8..15 and 24..31.
+        const auto lo = _mm256_unpacklo_epi8(u, v);
+        const auto hi = _mm256_unpackhi_epi8(u, v);
+        _mm256_storeu_si256((__m256i *)(dst + x * 2 + 0), _mm256_permute2x128_si256(lo, hi, 0x20));
+        _mm256_storeu_si256((__m256i *)(dst + x * 2 + 32), _mm256_permute2x128_si256(lo, hi, 0x31));
+    }
+
+    interleave_row_c(src_u + block_width, src_v + block_width, dst + block_width * 2, width - block_width);
+}
+
+void deinterleave_row_avx2(const unsigned char *src, unsigned char *dst_u, unsigned char *dst_v, const int width)
+{
+    const int block_width = simd::align_down(width, 32);
+
+    // per lane: u0 v0 u1 v1 ... -> u0 .. u7 v0 .. v7
+    const auto split = _mm256_setr_epi8(
+        0, 2, 4, 6, 8, 10, 12, 14, 1, 3, 5, 7, 9, 11, 13, 15,
+        0, 2, 4, 6, 8, 10, 12, 14, 1, 3, 5, 7, 9, 11, 13, 15);
+
+    __no_unroll
+    for (int x = 0; x < block_width; x += 32)
+    {
+        const auto a = _mm256_shuffle_epi8(_mm256_loadu_si256((const __m256i *)(src + x * 2 + 0)), split);
+        const auto b = _mm256_shuffle_epi8(_mm256_loadu_si256((const __m256i *)(src + x * 2 + 32)), split);
+
+        // u0..15 | v0..15 and u16..31 | v16..31
+        const auto u_v_lo = _mm256_permute4x64_epi64(a, 0xd8);
+        const auto u_v_hi = _mm256_permute4x64_epi64(b, 0xd8);
+        _mm256_storeu_si256((__m256i *)(dst_u + x), _mm256_permute2x128_si256(u_v_lo, u_v_hi, 0x20));
+        _mm256_storeu_si256((__m256i *)(dst_v + x), _mm256_permute2x128_si256(u_v_lo, u_v_hi, 0x31));
+    }
+
+    deinterleave_row_c(src + block_width * 2, dst_u + block_width, dst_v + block_width, width - block_width);
+}
+
+void swap_uv_row_avx2(const unsigned char *src, unsigned char *dst, const int width)
+{
+    const int block_width = simd::align_down(width, 32);
+    const auto swap = _mm256_setr_epi8(
+        1, 0, 3, 2, 5, 4, 7, 6, 9, 8, 11, 10, 13, 12, 15, 14,
+        1, 0, 3, 2, 5, 4, 7, 6, 9, 8, 11, 10, 13, 12, 15, 14);
+
+    __no_unroll
+    for (int x = 0; x < block_width; x += 32)
+    {
+        const auto a = _mm256_loadu_si256((const __m256i *)(src + x * 2 + 0));
+        const auto b = _mm256_loadu_si256((const __m256i *)(src + x * 2 + 32));
+        _mm256_storeu_si256((__m256i *)(dst + x * 2 + 0), _mm256_shuffle_epi8(a, swap));
+        _mm256_storeu_si256((__m256i *)(dst + x * 2 + 32), _mm256_shuffle_epi8(b, swap));
+    }
+
+    swap_uv_row_c(src + block_width * 2, dst + block_width * 2, width - block_width);
+}
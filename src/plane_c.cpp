@@ -0,0 +1,63 @@
+/* Copyright(c) 2018 Steven Hoving
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "plane_c.h"
+
+#include <cstring>
+
+void copy_row_c(const unsigned char *src, unsigned char *dst, const int width)
+{
+    std::memcpy(dst, src, width);
+}
+
+void fill_row_c(unsigned char *dst, const unsigned char value, const int width)
+{
+    std::memset(dst, value, width);
+}
+
+void interleave_row_c(const unsigned char *src_u, const unsigned char *src_v, unsigned char *dst, const int width)
+{
+    for (int x = 0; x < width; ++x)
+    {
+        dst[x * 2 + 0] = src_u[x];
+        dst[x * 2 + 1] = src_v[x];
+    }
+}
+
+void deinterleave_row_c(const unsigned char *src, unsigned char *dst_u, unsigned char *dst_v, const int width)
+{
+    for (int x = 0; x < width; ++x)
+    {
+        dst_u[x] = src[x * 2 + 0];
+        dst_v[x] = src[x * 2 + 1];
+    }
+}
+
+void swap_uv_row_c(const unsigned char *src, unsigned char *dst, const int width)
+{
+    for (int x = 0; x < width; ++x)
+    {
+        const auto u = src[x * 2 + 0];
+        const auto v = src[x * 2 + 1];
+        dst[x * 2 + 0] = v;
+        dst[x * 2 + 1] = u;
+    }
+}
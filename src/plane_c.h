@@ -0,0 +1,31 @@
+/* Copyright(c) 2018 Steven Hoving
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+// plain plane rows, these are the building blocks of the gray and repack paths.
+void copy_row_c(const unsigned char *src, unsigned char *dst, const int width);
+void fill_row_c(unsigned char *dst, const unsigned char value, const int width);
+
+// width is the number of sample pairs. swap_uv_row may run in place (src == dst).
+void interleave_row_c(const unsigned char *src_u, const unsigned char *src_v, unsigned char *dst, const int width);
+void deinterleave_row_c(const unsigned char *src, unsigned char *dst_u, unsigned char *dst_v, const int width);
+void swap_uv_row_c(const unsigned char *src, unsigned char *dst, const int width);
@@ -0,0 +1,145 @@
+/* Copyright(c) 2018 Steven Hoving
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "plane_ssse3.h"
+#include "plane_c.h"
+#include "simd_utility.h"
+
+#include <emmintrin.h>
+#include <tmmintrin.h>
+
+// 64 bytes per iteration, the tail is done with one unaligned store that overlaps the last block.
+void copy_row_ssse3(const unsigned char *src, unsigned char *dst, const int width)
+{
+    if (width < 16)
+    {
+        for (int x = 0; x < width; ++x)
+            dst[x] = src[x];
+        return;
+    }
+
+    const int block_width = simd::align_down(width, 64);
+
+    int x = 0;
+    __no_unroll
+    for (; x < block_width; x += 64)
+    {
+        const auto a = _mm_loadu_si128((const __m128i *)(src + x + 0));
+        const auto b = _mm_loadu_si128((const __m128i *)(src + x + 16));
+        const auto c = _mm_loadu_si128((const __m128i *)(src + x + 32));
+        const auto d = _mm_loadu_si128((const __m128i *)(src + x + 48));
+        _mm_storeu_si128((__m128i *)(dst + x + 0), a);
+        _mm_storeu_si128((__m128i *)(dst + x + 16), b);
+        _mm_storeu_si128((__m128i *)(dst + x + 32), c);
+        _mm_storeu_si128((__m128i *)(dst + x + 48), d);
+    }
+
+    __no_unroll
+    for (; x + 16 <= width; x += 16)
+        _mm_storeu_si128((__m128i *)(dst + x), _mm_loadu_si128((const __m128i *)(src + x)));
+
+    if (x < width)
+        _mm_storeu_si128((__m128i *)(dst + width - 16), _mm_loadu_si128((const __m128i *)(src + width - 16)));
+}
+
+void fill_row_ssse3(unsigned char *dst, const unsigned char value, const int width)
+{
+    if (width < 16)
+    {
+        for (int x = 0; x < width; ++x)
+            dst[x] = value;
+        return;
+    }
+
+    const auto fill = _mm_set1_epi8(static_cast<char>(value));
+    const int block_width = simd::align_down(width, 64);
+
+    int x = 0;
+    __no_unroll
+    for (; x < block_width; x += 64)
+    {
+        _mm_storeu_si128((__m128i *)(dst + x + 0), fill);
+        _mm_storeu_si128((__m128i *)(dst + x + 16), fill);
+        _mm_storeu_si128((__m128i *)(dst + x + 32), fill);
+        _mm_storeu_si128((__m128i *)(dst + x + 48), fill);
+    }
+
+    __no_unroll
+    for (; x + 16 <= width; x += 16)
+        _mm_storeu_si128((__m128i *)(dst + x), fill);
+
+    if (x < width)
+        _mm_storeu_si128((__m128i *)(dst + width - 16), fill);
+}
+
+// the interleave kernels do 16 sample pairs per iteration and leave the tail to the c rows, an
+// overlapping store would read back samples that swap_uv_row has already swapped in place.
+void interleave_row_ssse3(const unsigned char *src_u, const unsigned char *src_v, unsigned char *dst, const int width)
+{
+    const int block_width = simd::align_down(width, 16);
+
+    __no_unroll
+    for (int x = 0; x < block_width; x += 16)
+    {
+        const auto u = _mm_loadu_si128((const __m128i *)(src_u + x));
+        const auto v = _mm_loadu_si128((const __m128i *)(src_v + x));
+        _mm_storeu_si128((__m128i *)(dst + x * 2 + 0), _mm_unpacklo_epi8(u, v));
+        _mm_storeu_si128((__m128i *)(dst + x * 2 + 16), _mm_unpackhi_epi8(u, v));
+    }
+
+    interleave_row_c(src_u + block_width, src_v + block_width, dst + block_width * 2, width - block_width);
+}
+
+void deinterleave_row_ssse3(const unsigned char *src, unsigned char *dst_u, unsigned char *dst_v, const int width)
+{
+    const int block_width = simd::align_down(width, 16);
+
+    // u0 v0 u1 v1 ... -> u0 .. u7 v0 .. v7
+    const auto split = _mm_setr_epi8(0, 2, 4, 6, 8, 10, 12, 14, 1, 3, 5, 7, 9, 11, 13, 15);
+
+    __no_unroll
+    for (int x = 0; x < block_width; x += 16)
+    {
+        const auto a = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)(src + x * 2 + 0)), split);
+        const auto b = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)(src + x * 2 + 16)), split);
+        _mm_storeu_si128((__m128i *)(dst_u + x), _mm_unpacklo_epi64(a, b));
+        _mm_storeu_si128((__m128i *)(dst_v + x), _mm_unpackhi_epi64(a, b));
+    }
+
+    deinterleave_row_c(src + block_width * 2, dst_u + block_width, dst_v + block_width, width - block_width);
+}
+
+void swap_uv_row_ssse3(const unsigned char *src, unsigned char *dst, const int width)
+{
+    const int block_width = simd::align_down(width, 16);
+    const auto swap = _mm_setr_epi8(1, 0, 3, 2, 5, 4, 7, 6, 9, 8, 11, 10, 13, 12, 15, 14);
+
+    __no_unroll
+    for (int x = 0; x < block_width; x += 16)
+    {
+        const auto a = _mm_loadu_si128((const __m128i *)(src + x * 2 + 0));
+        const auto b = _mm_loadu_si128((const __m128i *)(src + x * 2 + 16));
+        _mm_storeu_si128((__m128i *)(dst + x * 2 + 0), _mm_shuffle_epi8(a, swap));
+        _mm_storeu_si128((__m128i *)(dst + x * 2 + 16), _mm_shuffle_epi8(b, swap));
+    }
+
+    swap_uv_row_c(src + block_width * 2, dst + block_width * 2, width - block_width);
+}
@@ -0,0 +1,183 @@
+/* Copyright(c) 2018 Steven Hoving
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "plane_c.h"
+#include "plane_ssse3.h"
+#include "plane_avx2.h"
+#include "row_converter.h"
+#include "cpu_features.h"
+#include "thread_pool.h"
+#include "yuvconvert.h"
+
+namespace yuvconvert
+{
+
+#if YUVCONVERT_X86
+static bool use_avx2(simd_mode mode)
+{
+    return mode == simd_mode::avx2 && get_cpu_features().avx2;
+}
+#endif
+
+static plane_copy_row *get_copy_row(simd_mode mode)
+{
+    // there is no avx2 copy kernel, a copy is bound by memory bandwidth.
+    return select_x86_kernel(mode, copy_row_ssse3, copy_row_c);
+}
+
+static plane_interleave_row *get_interleave_row(simd_mode mode)
+{
+#if YUVCONVERT_X86
+    if (use_x86_kernels(mode))
+        return use_avx2(mode) ? interleave_row_avx2 : interleave_row_ssse3;
+#endif
+    return interleave_row_c;
+}
+
+static plane_deinterleave_row *get_deinterleave_row(simd_mode mode)
+{
+#if YUVCONVERT_X86
+    if (use_x86_kernels(mode))
+        return use_avx2(mode) ? deinterleave_row_avx2 : deinterleave_row_ssse3;
+#endif
+    return deinterleave_row_c;
+}
+
+static plane_swap_row *get_swap_row(simd_mode mode)
+{
+#if YUVCONVERT_X86
+    if (use_x86_kernels(mode))
+        return use_avx2(mode) ? swap_uv_row_avx2 : swap_uv_row_ssse3;
+#endif
+    return swap_uv_row_c;
+}
+
+static void copy_rows(unsigned char *destination, const int dst_stride, const unsigned char *source,
+    const int src_stride, const int width, const int first_row, const int last_row, plane_copy_row *copy_row)
+{
+    if (destination == source)
+        return;
+
+    for (int line = first_row; line < last_row; ++line)
+        copy_row(source + line * src_stride, destination + line * dst_stride, width);
+}
+
+// bands are an even number of rows, so the chroma rows of a band are [first_row / 2, (last_row + 1) / 2).
+static int chroma_row(const int row)
+{
+    return (row + 1) >> 1;
+}
+
+void copy_plane(unsigned char *destination, const int dst_stride, const unsigned char *source,
+    const int src_stride, const int width, const int height, simd_mode mode)
+{
+    auto copy_row = get_copy_row(mode);
+    parallel_bands(height, default_band_height, [&](int first_row, int last_row) {
+        copy_rows(destination, dst_stride, source, src_stride, width, first_row, last_row, copy_row);
+    });
+}
+
+void i420_to_nv12(unsigned char *destination[2], const int dst_stride[2], const unsigned char *const source[3],
+    const int src_stride[3], const int width, const int height, simd_mode mode)
+{
+    auto copy_row = get_copy_row(mode);
+    auto interleave_row = get_interleave_row(mode);
+    const auto chroma_width = (width + 1) >> 1;
+
+    parallel_bands(height, default_band_height, [&](int first_row, int last_row) {
+        copy_rows(destination[0], dst_stride[0], source[0], src_stride[0], width, first_row, last_row, copy_row);
+
+        for (int line = chroma_row(first_row); line < chroma_row(last_row); ++line)
+        {
+            interleave_row(source[1] + line * src_stride[1], source[2] + line * src_stride[2],
+                destination[1] + line * dst_stride[1], chroma_width);
+        }
+    });
+}
+
+void i420_to_nv21(unsigned char *destination[2], const int dst_stride[2], const unsigned char *const source[3],
+    const int src_stride[3], const int width, const int height, simd_mode mode)
+{
+    const unsigned char *const yvu[3] = {source[0], source[2], source[1]};
+    const int yvu_stride[3] = {src_stride[0], src_stride[2], src_stride[1]};
+    i420_to_nv12(destination, dst_stride, yvu, yvu_stride, width, height, mode);
+}
+
+void nv12_to_i420(unsigned char *destination[3], const int dst_stride[3], const unsigned char *const source[2],
+    const int src_stride[2], const int width, const int height, simd_mode mode)
+{
+    auto copy_row = get_copy_row(mode);
+    auto deinterleave_row = get_deinterleave_row(mode);
+    const auto chroma_width = (width + 1) >> 1;
+
+    parallel_bands(height, default_band_height, [&](int first_row, int last_row) {
+        copy_rows(destination[0], dst_stride[0], source[0], src_stride[0], width, first_row, last_row, copy_row);
+
+        for (int line = chroma_row(first_row); line < chroma_row(last_row); ++line)
+        {
+            deinterleave_row(source[1] + line * src_stride[1], destination[1] + line * dst_stride[1],
+                destination[2] + line * dst_stride[2], chroma_width);
+        }
+    });
+}
+
+void nv21_to_i420(unsigned char *destination[3], const int dst_stride[3], const unsigned char *const source[2],
+    const int src_stride[2], const int width, const int height, simd_mode mode)
+{
+    unsigned char *yvu[3] = {destination[0], destination[2], destination[1]};
+    const int yvu_stride[3] = {dst_stride[0], dst_stride[2], dst_stride[1]};
+    nv12_to_i420(yvu, yvu_stride, source, src_stride, width, height, mode);
+}
+
+void nv12_to_nv21(unsigned char *destination[2], const int dst_stride[2], const unsigned char *const source[2],
+    const int src_stride[2], const int width, const int height, simd_mode mode)
+{
+    auto copy_row = get_copy_row(mode);
+    auto swap_row = get_swap_row(mode);
+    const auto chroma_width = (width + 1) >> 1;
+
+    parallel_bands(height, default_band_height, [&](int first_row, int last_row) {
+        copy_rows(destination[0], dst_stride[0], source[0], src_stride[0], width, first_row, last_row, copy_row);
+
+        for (int line = chroma_row(first_row); line < chroma_row(last_row); ++line)
+            swap_row(source[1] + line * src_stride[1], destination[1] + line * dst_stride[1], chroma_width);
+    });
+}
+
+void i420_to_yv12(unsigned char *destination[3], const int dst_stride[3], const unsigned char *const source[3],
+    const int src_stride[3], const int width, const int height, simd_mode mode)
+{
+    auto copy_row = get_copy_row(mode);
+    const auto chroma_width = (width + 1) >> 1;
+
+    parallel_bands(height, default_band_height, [&](int first_row, int last_row) {
+        copy_rows(destination[0], dst_stride[0], source[0], src_stride[0], width, first_row, last_row, copy_row);
+
+        const auto first_chroma_row = chroma_row(first_row);
+        const auto last_chroma_row = chroma_row(last_row);
+        copy_rows(destination[1], dst_stride[1], source[2], src_stride[2], chroma_width, first_chroma_row,
+            last_chroma_row, copy_row);
+        copy_rows(destination[2], dst_stride[2], source[1], src_stride[1], chroma_width, first_chroma_row,
+            last_chroma_row, copy_row);
+    });
+}
+
+} // namespace yuvconvert
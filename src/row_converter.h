@@ -0,0 +1,42 @@
+/* Copyright(c) 2018 Steven Hoving
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+namespace yuvconvert
+{
+// row converter signatures shared by the dispatch code of all output formats.
+using bgrx_row_to_y_row = void(const unsigned char *src, unsigned char *dst, const int width);
+using bgrx_row_to_yuv_row = void(const unsigned char *src, unsigned char *dst_y, unsigned char *dst_u, unsigned char *dst_v, const int width);
+using bgrx_row_to_packed_row = void(const unsigned char *src, unsigned char *dst, const int width);
+using plane_copy_row = void(const unsigned char *src, unsigned char *dst, const int width);
+using plane_fill_row = void(unsigned char *dst, const unsigned char value, const int width);
+using plane_interleave_row = void(const unsigned char *src_u, const unsigned char *src_v, unsigned char *dst, const int width);
+using plane_deinterleave_row = void(const unsigned char *src, unsigned char *dst_u, unsigned char *dst_v, const int width);
+using plane_swap_row = void(const unsigned char *src, unsigned char *dst, const int width);
+
+// 16 bit per channel rows, the thresholds are the 4 columns of a row of the dither matrix.
+using deep_row_to_y_row = void(const unsigned short *src, unsigned char *dst, const int width, const int bit_depth,
+    const int *luma_thresholds);
+using deep_row_to_yuv_row = void(const unsigned short *src, unsigned char *dst_y, unsigned char *dst_u,
+    unsigned char *dst_v, const int width, const int bit_depth, const int *luma_thresholds,
+    const int *chroma_thresholds);
+} // namespace yuvconvert
@@ -0,0 +1,188 @@
+/* Copyright(c) 2018 Steven Hoving
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include "simd_vec.h"
+#include "simd_common.h"
+
+#include <tmmintrin.h>
+
+// shared ssse3 building blocks for the bgr(a) row kernels. A block is always 16 pixels, which are
+// unpacked into 2x vec3 of 8 pixels with 16 bit lanes. After the unpack stage the bgr and bgra
+// paths are identical.
+namespace simd
+{
+namespace bgra
+{
+// \note rename shuffle to unpack
+static const auto shuffle_lo_odd = vec3_set_shuffle_lo(12, 8, 4, 0);
+static const auto shuffle_hi_odd = vec3_set_shuffle_hi(12, 8, 4, 0);
+} // namespace bgra
+
+namespace bgr
+{
+static const auto shuffle_lo_odd = vec3_set_shuffle_lo(9, 6, 3, 0);
+static const auto shuffle_hi_odd = vec3_set_shuffle_hi(9, 6, 3, 0);
+
+// the last 4 pixels of a block are loaded from offset 32 instead of 36, so we never read beyond
+// the 48 bytes of the block.
+static const auto shuffle_hi_tail = vec3_set_shuffle_hi(13, 10, 7, 4);
+} // namespace bgr
+
+// takes the high byte of every 16 bit lane.
+static const auto y_shuffle = vec2_set_pack(15, 13, 11, 9, 7, 5, 3, 1);
+
+// takes the low byte of every even 16 bit lane (every even pixel).
+static const vec2 vec2_uv_shuffle = {
+    _mm_set_epi8(
+        mask, mask, mask, mask,
+        mask, mask, mask, mask,
+        mask, mask, mask, mask,
+        12, 8, 4, 0),
+    _mm_set_epi8(
+        mask, mask, mask, mask,
+        mask, mask, mask, mask,
+        12, 8, 4, 0,
+        mask, mask, mask, mask)
+};
+
+// load 16 bytes, the aligned load is only used for rows that are known to be 16 byte aligned.
+template<bool aligned = false>
+static __forceinline __m128i block_load(const unsigned char *src)
+{
+    if constexpr (aligned)
+        return _mm_load_si128((const __m128i *)src);
+    else
+        return _mm_lddqu_si128((const __m128i *)src);
+}
+
+template<bool aligned = false>
+static __forceinline void block_store(unsigned char *dst, const __m128i value)
+{
+    if constexpr (aligned)
+        _mm_store_si128((__m128i *)dst, value);
+    else
+        _mm_storeu_si128((__m128i *)dst, value);
+}
+
+// divide the color channels of 4 premultiplied bgra pixels by their alpha, see unpremultiply in
+// yuvconvert_common.h. The alpha channel of the result is 0.
+static __forceinline __m128i unpremultiply_4(const __m128i pixels)
+{
+    const auto byte_mask = _mm_set1_epi32(0xff);
+    const auto max_value = _mm_set1_ps(255.0f);
+    const auto alpha = _mm_cvtepi32_ps(_mm_srli_epi32(pixels, 24));
+
+    // 255 / 0 is infinity, the mask turns it into a scale of 0.
+    const auto scale = _mm_and_ps(_mm_div_ps(max_value, alpha), _mm_cmpneq_ps(alpha, _mm_setzero_ps()));
+
+    const auto b = _mm_cvtepi32_ps(_mm_and_si128(pixels, byte_mask));
+    const auto g = _mm_cvtepi32_ps(_mm_and_si128(_mm_srli_epi32(pixels, 8), byte_mask));
+    const auto r = _mm_cvtepi32_ps(_mm_and_si128(_mm_srli_epi32(pixels, 16), byte_mask));
+    const auto b_int = _mm_cvtps_epi32(_mm_min_ps(_mm_mul_ps(b, scale), max_value));
+    const auto g_int = _mm_cvtps_epi32(_mm_min_ps(_mm_mul_ps(g, scale), max_value));
+    const auto r_int = _mm_cvtps_epi32(_mm_min_ps(_mm_mul_ps(r, scale), max_value));
+    return _mm_or_si128(_mm_or_si128(b_int, _mm_slli_epi32(g_int, 8)), _mm_slli_epi32(r_int, 16));
+}
+
+// load 16 bgra pixels (64 bytes) and unpack them into 2x 8 pixels. Premultiplied pixels are
+// un-premultiplied right after the load.
+template<bool aligned = false, bool premultiplied = false>
+static __forceinline void bgra_block_unpack(const unsigned char *src, vec3 &part0, vec3 &part1)
+{
+    auto pxl0 = block_load<aligned>(src +  0); // load 4 pixels
+    auto pxl1 = block_load<aligned>(src + 16); // load 4 pixels
+    auto pxl2 = block_load<aligned>(src + 32); // load 4 pixels
+    auto pxl3 = block_load<aligned>(src + 48); // load 4 pixels
+
+    if constexpr (premultiplied)
+    {
+        pxl0 = unpremultiply_4(pxl0);
+        pxl1 = unpremultiply_4(pxl1);
+        pxl2 = unpremultiply_4(pxl2);
+        pxl3 = unpremultiply_4(pxl3);
+    }
+
+    // unpack so we end up with 4x 4 pixels and interleave them into 2x 8 pixels
+    part0 = vec3_or(vec3_unpack(pxl0, bgra::shuffle_lo_odd), vec3_unpack(pxl1, bgra::shuffle_hi_odd));
+    part1 = vec3_or(vec3_unpack(pxl2, bgra::shuffle_lo_odd), vec3_unpack(pxl3, bgra::shuffle_hi_odd));
+}
+
+// load 16 bgr pixels (48 bytes) and unpack them into 2x 8 pixels.
+static __forceinline void bgr_block_unpack(const unsigned char *src, vec3 &part0, vec3 &part1)
+{
+    const auto pxl0 = _mm_lddqu_si128((const __m128i *)(src +  0)); // pixels 0..3
+    const auto pxl1 = _mm_lddqu_si128((const __m128i *)(src + 12)); // pixels 4..7
+    const auto pxl2 = _mm_lddqu_si128((const __m128i *)(src + 24)); // pixels 8..11
+    const auto pxl3 = _mm_lddqu_si128((const __m128i *)(src + 32)); // pixels 12..15 (at offset 4)
+
+    part0 = vec3_or(vec3_unpack(pxl0, bgr::shuffle_lo_odd), vec3_unpack(pxl1, bgr::shuffle_hi_odd));
+    part1 = vec3_or(vec3_unpack(pxl2, bgr::shuffle_lo_odd), vec3_unpack(pxl3, bgr::shuffle_hi_tail));
+}
+
+template<int pixel_width, bool aligned = false>
+static __forceinline void bgrx_block_unpack(const unsigned char *src, vec3 &part0, vec3 &part1)
+{
+    static_assert(pixel_width == 3 || pixel_width == 4, "only bgr and bgra are supported");
+    if constexpr (pixel_width == 4)
+        bgra_block_unpack<aligned>(src, part0, part1);
+    else
+        bgr_block_unpack(src, part0, part1);
+}
+
+// calculate the luma of 16 unpacked pixels, returns 16 y values.
+static __forceinline __m128i block_to_y(const vec3 &part0, const vec3 &part1)
+{
+    // multiply the 2x 8 pixels
+    const auto vec_y_part0 = vec3_mullo(part0, y_mul);
+    const auto vec_y_part1 = vec3_mullo(part1, y_mul);
+
+    // vertical sum the vec3 so we end up with 1 object that contains 2x 8 pixels.
+    auto vec_y_part = vec3_vsum_vec2(vec_y_part0, vec_y_part1);
+    vec_y_part = vec2_add(vec_y_part, uv_add); // abuse uv_add to + 128
+
+    const auto vec_result = vec2_shuffle(vec_y_part, y_shuffle);
+    return _mm_add_epi8(vec2_pack_interleave(vec_result), y_add);
+}
+
+// calculate the chroma of 16 unpacked pixels, returns 2x 8 values in 16 bit lanes.
+static __forceinline vec2 block_to_chroma(const vec3 &part0, const vec3 &part1, const vec3 &mul)
+{
+    auto chroma = vec3_vsum_vec2(vec3_mullo(part0, mul), vec3_mullo(part1, mul));
+    chroma = vec2_add(chroma, uv_add);
+    chroma = vec2_srai(chroma, 8);
+    return vec2_add(chroma, uv_add);
+}
+
+// pack the chroma of the 8 even pixels into the lower 64 bits (horizontal subsampling).
+static __forceinline __m128i chroma_pack_even(vec2 chroma)
+{
+    return vec2_pack_interleave(vec2_shuffle(chroma, vec2_uv_shuffle));
+}
+
+// pack the chroma of all 16 pixels.
+static __forceinline __m128i chroma_pack(vec2 chroma)
+{
+    return _mm_packus_epi16(chroma.b, chroma.g);
+}
+
+} // namespace simd
@@ -30,6 +30,7 @@ union M128 {
     __m128i i128;
 };
 
+#if defined(_MSC_VER)
 typedef union __declspec(align(16)) M128i {
     __int8 m128i_i8[16];
     __int16 m128i_i16[8];
@@ -40,6 +41,7 @@ typedef union __declspec(align(16)) M128i {
     unsigned __int32 m128i_u32[4];
     unsigned __int64 m128i_u64[2];
 } __M128i;
+#endif
 
 [[maybe_unused]] static void print_x8(__m128i value, const char *section)
 {
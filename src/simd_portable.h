@@ -0,0 +1,132 @@
+/* Copyright(c) 2018 Steven Hoving
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+// the portable counterpart of simd_vec.h, written with the gcc / clang vector extensions instead of
+// intrinsics so it builds for any target. Everything is 128 bits wide and only uses operations every
+// simd instruction set has (16 bit multiplies, shifts and masks), the channels of a pixel are taken
+// apart with shifts instead of byte shuffles. Only included where YUVCONVERT_VECTOR_EXTENSIONS is set.
+
+#include <cstdint>
+#include <cstring>
+
+namespace simd::portable
+{
+typedef uint8_t u8x8 __attribute__((vector_size(8)));
+typedef uint8_t u8x16 __attribute__((vector_size(16)));
+typedef uint16_t u16x8 __attribute__((vector_size(16)));
+typedef int16_t i16x8 __attribute__((vector_size(16)));
+typedef uint32_t u32x4 __attribute__((vector_size(16)));
+typedef int32_t i32x4 __attribute__((vector_size(16)));
+
+template <typename T>
+static inline T load(const void *src)
+{
+    T result;
+    std::memcpy(&result, src, sizeof(result));
+    return result;
+}
+
+template <typename T>
+static inline void store(void *dst, const T &value)
+{
+    std::memcpy(dst, &value, sizeof(value));
+}
+
+// 16 pixels as 4 vectors of 4 bgrx pixels, the x byte is undefined for bgr.
+struct bgrx16
+{
+    u32x4 pixels[4];
+};
+
+// 4 bgr pixels (12 bytes) as bgrx. Two 64 bit loads hold 2 pixels each, the second one ends on the
+// last byte so nothing past the pixels is read. Byte shuffles are left out, the sse2 baseline has no
+// pshufb and the compiler would fall back to scalar code for them.
+static inline u32x4 load_4_bgr_pixels(const unsigned char *src)
+{
+    typedef uint64_t u64x2 __attribute__((vector_size(16)));
+    const u64x2 pairs = {load<uint64_t>(src), load<uint64_t>(src + 4) >> 16};
+    const u64x2 even = pairs & 0xffffff;
+    const u64x2 odd = (pairs >> 24) & 0xffffff;
+    return (u32x4)(even | (odd << 32));
+}
+
+template <int pixel_width>
+static inline bgrx16 load_16_pixels(const unsigned char *src)
+{
+    if constexpr (pixel_width == 4)
+    {
+        return {load<u32x4>(src), load<u32x4>(src + 16), load<u32x4>(src + 32), load<u32x4>(src + 48)};
+    }
+    else
+    {
+        return {load_4_bgr_pixels(src), load_4_bgr_pixels(src + 12), load_4_bgr_pixels(src + 24),
+            load_4_bgr_pixels(src + 36)};
+    }
+}
+
+// the even pixels of two vectors, the pixels that carry chroma.
+static inline u32x4 even_pixels(const u32x4 a, const u32x4 b)
+{
+    return __builtin_shufflevector(a, b, 0, 2, 4, 6);
+}
+
+// b * b_factor + g * g_factor + r * r_factor of 4 bgrx pixels. As 16 bit lanes a pixel is (b | g << 8)
+// and (r | x << 8), the low bytes are multiplied by (b_factor, r_factor) and the high bytes by
+// (g_factor, 0), then the two lanes of every pixel are added. The multiply-add is done on unsigned
+// lanes where it wraps, the lane sums of the 8 bit bt.601 matrix fit in 16 bits: unsigned for luma
+// (at most 25 * 255 + 129 * 255 = 39270) and signed for chroma (within +-28560). So the lanes are
+// zero extended when all factors are positive and sign extended otherwise.
+template <int b_factor, int g_factor, int r_factor>
+static inline i32x4 weighted_sum(const u32x4 pixels)
+{
+    const auto lanes = (u16x8)pixels;
+    const u16x8 low = lanes & 0xff;
+    const u16x8 high = lanes >> 8;
+    constexpr auto b = static_cast<uint16_t>(b_factor);
+    constexpr auto g = static_cast<uint16_t>(g_factor);
+    constexpr auto r = static_cast<uint16_t>(r_factor);
+    const u16x8 low_factor = {b, r, b, r, b, r, b, r};
+    const u16x8 high_factor = {g, 0, g, 0, g, 0, g, 0};
+    const auto sums = (u32x4)(low * low_factor + high * high_factor);
+
+    if constexpr (b_factor < 0 || g_factor < 0 || r_factor < 0)
+        return ((i32x4)(sums << 16) >> 16) + ((i32x4)sums >> 16);
+    else
+        return (i32x4)((sums & 0xffff) + (sums >> 16));
+}
+
+// narrow 4 vectors of values in [0, 255] to bytes.
+static inline u8x16 narrow(const i32x4 a, const i32x4 b, const i32x4 c, const i32x4 d)
+{
+    const i16x8 ab = __builtin_shufflevector((i16x8)a, (i16x8)b, 0, 2, 4, 6, 8, 10, 12, 14);
+    const i16x8 cd = __builtin_shufflevector((i16x8)c, (i16x8)d, 0, 2, 4, 6, 8, 10, 12, 14);
+    return __builtin_shufflevector((u8x16)ab, (u8x16)cd, 0, 2, 4, 6, 8, 10, 12, 14, 16, 18, 20, 22, 24, 26, 28, 30);
+}
+
+static inline u8x8 narrow(const i32x4 a, const i32x4 b)
+{
+    const i16x8 ab = __builtin_shufflevector((i16x8)a, (i16x8)b, 0, 2, 4, 6, 8, 10, 12, 14);
+    return __builtin_shufflevector((u8x16)ab, (u8x16)ab, 0, 2, 4, 6, 8, 10, 12, 14);
+}
+
+} // namespace simd::portable
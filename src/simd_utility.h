@@ -21,7 +21,30 @@
 
 #pragma once
 
+#include <cstdint>
+
+// the x86 kernels (ssse3 and avx2) and the cpuid detection are only built for x86 targets.
+#if !defined(YUVCONVERT_X86)
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define YUVCONVERT_X86 1
+#else
+#define YUVCONVERT_X86 0
+#endif
+#endif
+
+// the portable kernels need the gcc / clang vector extensions with __builtin_shufflevector, clang
+// and gcc 12 or later.
+#if !defined(YUVCONVERT_VECTOR_EXTENSIONS)
+#if defined(__clang__) || (defined(__GNUC__) && __GNUC__ >= 12)
+#define YUVCONVERT_VECTOR_EXTENSIONS 1
+#else
+#define YUVCONVERT_VECTOR_EXTENSIONS 0
+#endif
+#endif
+
+#if YUVCONVERT_X86
 #include <emmintrin.h>
+#endif
 
 #if defined(__clang__)
 #define COMPILER_CLANG 1
@@ -41,6 +64,18 @@
 #define __no_unroll _Pragma("nounroll")
 #endif
 
+#if !defined(_MSC_VER)
+#define __forceinline inline __attribute__((always_inline))
+#endif
+
+// lets the compiler build a plain c function for several instruction sets, the loader picks the
+// best one for the cpu. Only enabled where the toolchain supports it, see YUVCONVERT_TARGET_CLONES.
+#if defined(YUVCONVERT_TARGET_CLONES)
+#define __target_clones __attribute__((target_clones("avx2", "sse4.1", "default")))
+#else
+#define __target_clones
+#endif
+
 #if 0
 #if defined(_MSC_VER) && !defined(__clang__)
 #define __packed_struct(x) __pragma(pack(push, 1)) struct x
@@ -69,4 +104,9 @@ static inline T align_down(const T size, const T align) noexcept
     return size & ~(align - 1);
 }
 
+static inline bool is_aligned(const void *pointer, const uintptr_t align) noexcept
+{
+    return (reinterpret_cast<uintptr_t>(pointer) & (align - 1)) == 0;
+}
+
 } // namespace simd
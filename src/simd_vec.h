@@ -21,6 +21,8 @@
 
 #pragma once
 
+#include "simd_utility.h"
+
 #include <xmmintrin.h>
 #include <emmintrin.h>
 #include <immintrin.h>
@@ -0,0 +1,147 @@
+/* Copyright(c) 2018 Steven Hoving
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "thread_pool.h"
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+
+namespace yuvconvert
+{
+
+thread_pool::thread_pool(unsigned int thread_count)
+{
+    workers_.reserve(thread_count);
+    for (unsigned int i = 0; i < thread_count; ++i)
+        workers_.emplace_back([this] { worker_main(); });
+}
+
+thread_pool::~thread_pool()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stop_ = true;
+    }
+    condition_.notify_all();
+
+    for (auto &worker : workers_)
+        worker.join();
+}
+
+thread_pool &thread_pool::instance()
+{
+    // the calling thread always helps out, so one worker less than there are hardware threads.
+    static thread_pool pool(std::max(1u, std::thread::hardware_concurrency()) - 1);
+    return pool;
+}
+
+void thread_pool::submit(std::function<void()> task)
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        tasks_.push_back(std::move(task));
+    }
+    condition_.notify_one();
+}
+
+void thread_pool::worker_main()
+{
+    for (;;)
+    {
+        std::function<void()> task;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            condition_.wait(lock, [this] { return stop_ || !tasks_.empty(); });
+            if (stop_ && tasks_.empty())
+                return;
+
+            task = std::move(tasks_.front());
+            tasks_.pop_front();
+        }
+        task();
+    }
+}
+
+void thread_pool::parallel_for(int count, const std::function<void(int)> &job)
+{
+    if (count <= 0)
+        return;
+
+    const auto helpers = std::min<int>(static_cast<int>(size()), count - 1);
+    if (helpers == 0)
+    {
+        for (int i = 0; i < count; ++i)
+            job(i);
+        return;
+    }
+
+    // the state is shared with the helper tasks, a helper that only gets scheduled after all work
+    // is done still finds it alive.
+    struct shared_state
+    {
+        std::atomic<int> next{0};
+        int remaining{0};
+        std::mutex mutex;
+        std::condition_variable done;
+    };
+
+    auto state = std::make_shared<shared_state>();
+    state->remaining = count;
+
+    const auto run = [state, count, &job] {
+        int finished = 0;
+        for (int i = state->next++; i < count; i = state->next++)
+        {
+            job(i);
+            ++finished;
+        }
+
+        if (finished == 0)
+            return;
+
+        std::lock_guard<std::mutex> lock(state->mutex);
+        state->remaining -= finished;
+        if (state->remaining == 0)
+            state->done.notify_all();
+    };
+
+    for (int i = 0; i < helpers; ++i)
+        submit(run);
+
+    run();
+
+    std::unique_lock<std::mutex> lock(state->mutex);
+    state->done.wait(lock, [&state] { return state->remaining == 0; });
+}
+
+void parallel_bands(int height, int band_height, const std::function<void(int, int)> &job)
+{
+    band_height = std::max(2, (band_height + 1) & ~1);
+    const auto band_count = (height + band_height - 1) / band_height;
+
+    thread_pool::instance().parallel_for(band_count, [&](int band) {
+        const auto first_row = band * band_height;
+        job(first_row, std::min(height, first_row + band_height));
+    });
+}
+
+} // namespace yuvconvert
@@ -0,0 +1,77 @@
+/* Copyright(c) 2018 Steven Hoving
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace yuvconvert
+{
+
+// a small worker pool used to split a frame into bands of rows. The thread calling
+// parallel_for always takes part in the work, so it is safe to call it from inside a job.
+class thread_pool
+{
+public:
+    explicit thread_pool(unsigned int thread_count);
+    ~thread_pool();
+
+    thread_pool(const thread_pool &) = delete;
+    thread_pool &operator=(const thread_pool &) = delete;
+
+    // the library wide pool, sized to the number of hardware threads.
+    static thread_pool &instance();
+
+    // queue a task, it is run by one of the workers at some point.
+    void submit(std::function<void()> task);
+
+    // run job(index) for every index in [0, count) and wait until all of them are done.
+    void parallel_for(int count, const std::function<void(int)> &job);
+
+    unsigned int size() const noexcept
+    {
+        return static_cast<unsigned int>(workers_.size());
+    }
+
+private:
+    void worker_main();
+
+    std::vector<std::thread> workers_;
+    std::deque<std::function<void()>> tasks_;
+    std::mutex mutex_;
+    std::condition_variable condition_;
+    bool stop_{false};
+};
+
+// split [0, height) into bands of band_height rows and run job(first_row, last_row) for each of
+// them on the library pool. band_height is rounded up to an even number so a band never splits a
+// 4:2:0 row pair.
+void parallel_bands(int height, int band_height, const std::function<void(int, int)> &job);
+
+// the band height used when the caller has no preference.
+constexpr auto default_band_height = 64;
+
+} // namespace yuvconvert
@@ -22,144 +22,279 @@
 #include "to_420.h"
 #include "to_420_c.h"
 #include "to_420_ssse3.h"
+#include "to_420_portable.h"
+#include "to_420_float_c.h"
+#include "to_420_float_ssse3.h"
+#include "to_420_float_avx2.h"
+#include "row_converter.h"
+#include "cpu_features.h"
+#include "simd_utility.h"
 #include "yuvconvert.h"
 
+#include <algorithm>
+
 namespace yuvconvert
 {
-using bgrx_row_to_y_row = void(const unsigned char *src, unsigned char *dst, const int width);
-using bgrx_row_to_yuv_row = void(const unsigned char *src, unsigned char *dst_y, unsigned char *dst_u, unsigned char *dst_v, const int width);
-
 
 void bgra_to_420(unsigned char *destination[3], const int dst_stride[3],
                  const unsigned char *const source[3], const int width, const int height,
                  const int src_stride[3])
 {
-    auto src = source[0];
-    auto y = destination[0];
-    auto u = destination[1];
-    auto v = destination[2];
+    bgra_to_420(destination, dst_stride, source, width, height, src_stride, simd_mode::plain_c);
+}
 
-    const auto raw_stride = src_stride[0];
-    const auto y_stride = dst_stride[0];
-    const auto u_stride = dst_stride[1];
-    const auto v_stride = dst_stride[2];
+void bgr_to_420(unsigned char *destination[3], const int dst_stride[3],
+                const unsigned char *const source[3], const int width, const int height,
+                const int src_stride[3])
+{
+    bgr_to_420(destination, dst_stride, source, width, height, src_stride, simd_mode::plain_c);
+}
 
-    for (int line = 0; line < height; line += 2)
+static row_converters_420 get_float_row_converters_420(pixel_format format, simd_mode mode)
+{
+#if YUVCONVERT_X86
+    if (use_x86_kernels(mode))
     {
-        bgra_row_to_yuv_row_c(src, y, u, v, width);
-        src += raw_stride;
-        y += y_stride;
-        u += u_stride;
-        v += v_stride;
-        bgra_row_to_y_row_c(src, y, width);
-        src += raw_stride;
-        y += y_stride;
+        const auto &features = get_cpu_features();
+        const auto avx2 = mode == simd_mode::avx2 && features.avx2;
+
+        if (format == pixel_format::bgra)
+        {
+            if (avx2)
+                return {bgra_row_to_yuv_row_float_avx2, bgra_row_to_y_row_float_avx2};
+            return {bgra_row_to_yuv_row_float_ssse3, bgra_row_to_y_row_float_ssse3};
+        }
+
+        if (avx2)
+            return {bgr_row_to_yuv_row_float_avx2, bgr_row_to_y_row_float_avx2};
+        return {bgr_row_to_yuv_row_float_ssse3, bgr_row_to_y_row_float_ssse3};
     }
+#endif
+
+    // there are no portable floating point kernels.
+    if (format == pixel_format::bgra)
+        return {bgra_row_to_yuv_row_float_c, bgra_row_to_y_row_float_c};
+    return {bgr_row_to_yuv_row_float_c, bgr_row_to_y_row_float_c};
 }
 
-void bgr_to_420(unsigned char *destination[3], const int dst_stride[3],
-                const unsigned char *const source[3], const int width, const int height,
-                const int src_stride[3])
+row_converters_420 get_row_converters_420(pixel_format format, simd_mode mode, bool aligned,
+    conversion_precision precision)
 {
-    auto src = source[0];
-    auto y = destination[0];
-    auto u = destination[1];
-    auto v = destination[2];
+    mode = supported_simd_mode(mode);
+    if (precision == conversion_precision::floating_point)
+        return get_float_row_converters_420(format, mode);
+
+#if YUVCONVERT_X86
+    if (use_x86_kernels(mode))
+    {
+        if (format == pixel_format::bgra)
+        {
+            if (aligned)
+                return {bgra_row_to_yuv_row_ssse3_aligned, bgra_row_to_y_row_ssse3_aligned};
+            return {bgra_row_to_yuv_row_ssse3, bgra_row_to_y_row_ssse3};
+        }
+
+        if (aligned)
+            return {bgr_row_to_yuv_row_ssse3_aligned, bgr_row_to_y_row_ssse3_aligned};
+        return {bgr_row_to_yuv_row_ssse3, bgr_row_to_y_row_ssse3};
+    }
+#endif
+
+    if (mode == simd_mode::portable)
+    {
+        if (format == pixel_format::bgra)
+            return {bgra_row_to_yuv_row_portable, bgra_row_to_y_row_portable};
+        return {bgr_row_to_yuv_row_portable, bgr_row_to_y_row_portable};
+    }
+
+    if (format == pixel_format::bgra)
+        return {bgra_row_to_yuv_row_c, bgra_row_to_y_row_c};
+    return {bgr_row_to_yuv_row_c, bgr_row_to_y_row_c};
+}
+
+bool is_aligned_420(unsigned char *const destination[3], const int dst_stride[3],
+    const unsigned char *source, const int src_stride)
+{
+    constexpr auto alignment = 16;
+    return simd::is_aligned(source, alignment) && (src_stride % alignment) == 0 &&
+        simd::is_aligned(destination[0], alignment) && (dst_stride[0] % alignment) == 0;
+}
+
+void convert_rows_420(const row_converters_420 &converters, unsigned char *const destination[3],
+    const int dst_stride[3], const unsigned char *source, const int src_stride, const int width,
+    const int first_row, const int last_row)
+{
+    auto src = source + first_row * src_stride;
+    auto y = destination[0] + first_row * dst_stride[0];
+    auto u = destination[1] + (first_row >> 1) * dst_stride[1];
+    auto v = destination[2] + (first_row >> 1) * dst_stride[2];
 
-    const auto raw_stride = src_stride[0];
     const auto y_stride = dst_stride[0];
     const auto u_stride = dst_stride[1];
     const auto v_stride = dst_stride[2];
 
-    for (int line = 0; line < height; line += 2)
+    for (int line = first_row; line < last_row; line += 2)
     {
-        bgr_row_to_yuv_row_c(src, y, u, v, width);
-        src += raw_stride;
+        converters.yuv_row(src, y, u, v, width);
+
+        // an odd height ends with a single chroma carrying row.
+        if (line + 1 == last_row)
+            break;
+
+        src += src_stride;
         y += y_stride;
         u += u_stride;
         v += v_stride;
-        bgr_row_to_y_row_c(src, y, width);
-        src += raw_stride;
+        converters.y_row(src, y, width);
+        src += src_stride;
         y += y_stride;
     }
 }
 
-void bgr_to_420(unsigned char *destination[3], const int dst_stride[3], const unsigned char *const source[3],
-    const int width, const int height, const int src_stride[3], simd_mode mode /*= simd_mode::plain_c*/)
+void convert_rows_420_tiled(const row_converters_420 &converters, pixel_format format,
+    unsigned char *const destination[3], const int dst_stride[3], const unsigned char *source,
+    const int src_stride, const int width, const int first_row, const int last_row, int tile_width)
 {
-    auto src = source[0];
-    auto y = destination[0];
-    auto u = destination[1];
-    auto v = destination[2];
-
-    const auto raw_stride = src_stride[0];
-    const auto y_stride = dst_stride[0];
-    const auto u_stride = dst_stride[1];
-    const auto v_stride = dst_stride[2];
+    constexpr auto tile_height = 16;
 
-    bgrx_row_to_yuv_row *yuv_row_converter = nullptr;
-    bgrx_row_to_y_row *y_row_converter = nullptr;
-    if (mode == simd_mode::plain_c)
-    {
-        yuv_row_converter = bgr_row_to_yuv_row_c;
-        y_row_converter = bgr_row_to_y_row_c;
-    }
-    else if (mode == simd_mode::ssse3)
+    tile_width = std::max(16, simd::align_down(tile_width, 16));
+    if (tile_width >= width)
     {
-        yuv_row_converter = bgr_row_to_yuv_row_ssse3;
-        y_row_converter = bgr_row_to_y_row_ssse3;
+        convert_rows_420(converters, destination, dst_stride, source, src_stride, width, first_row, last_row);
+        return;
     }
 
-    for (int line = 0; line < height; line += 2)
+    const auto pixel_width = (format == pixel_format::bgra) ? 4 : 3;
+    for (int row = first_row; row < last_row; row += tile_height)
     {
-        yuv_row_converter(src, y, u, v, width);
-        src += raw_stride;
-        y += y_stride;
-        u += u_stride;
-        v += v_stride;
-        y_row_converter(src, y, width);
-        src += raw_stride;
-        y += y_stride;
+        const auto tile_last_row = std::min(last_row, row + tile_height);
+        for (int x = 0; x < width; x += tile_width)
+        {
+            // x is even, so the chroma of a tile starts at x / 2.
+            unsigned char *const dst[3] = {destination[0] + x, destination[1] + (x >> 1), destination[2] + (x >> 1)};
+            convert_rows_420(converters, dst, dst_stride, source + x * pixel_width, src_stride,
+                std::min(tile_width, width - x), row, tile_last_row);
+        }
     }
 }
 
+void bgr_to_420(unsigned char *destination[3], const int dst_stride[3], const unsigned char *const source[3],
+    const int width, const int height, const int src_stride[3], simd_mode mode /*= simd_mode::plain_c*/)
+{
+    const auto aligned = is_aligned_420(destination, dst_stride, source[0], src_stride[0]);
+    const auto converters = get_row_converters_420(pixel_format::bgr, mode, aligned);
+    convert_rows_420(converters, destination, dst_stride, source[0], src_stride[0], width, 0, height);
+}
+
 void bgra_to_420(unsigned char *destination[3], const int dst_stride[3], const unsigned char *const source[3],
     const int width, const int height, const int src_stride[3], simd_mode mode /*= simd_mode::plain_c*/)
 {
-    auto src = source[0];
-    auto y = destination[0];
-    auto u = destination[1];
-    auto v = destination[2];
+    const auto aligned = is_aligned_420(destination, dst_stride, source[0], src_stride[0]);
+    const auto converters = get_row_converters_420(pixel_format::bgra, mode, aligned);
+    convert_rows_420(converters, destination, dst_stride, source[0], src_stride[0], width, 0, height);
+}
 
-    const auto raw_stride = src_stride[0];
-    const auto y_stride = dst_stride[0];
-    const auto u_stride = dst_stride[1];
-    const auto v_stride = dst_stride[2];
+void bgr_to_420(unsigned char *destination[3], const int dst_stride[3], const unsigned char *const source[3],
+    const int width, const int height, const int src_stride[3], simd_mode mode, conversion_precision precision)
+{
+    const auto aligned = is_aligned_420(destination, dst_stride, source[0], src_stride[0]);
+    const auto converters = get_row_converters_420(pixel_format::bgr, mode, aligned, precision);
+    convert_rows_420(converters, destination, dst_stride, source[0], src_stride[0], width, 0, height);
+}
 
-    bgrx_row_to_yuv_row *yuv_row_converter = nullptr;
-    bgrx_row_to_y_row *y_row_converter = nullptr;
-    if (mode == simd_mode::plain_c)
-    {
-        yuv_row_converter = bgra_row_to_yuv_row_c;
-        y_row_converter = bgra_row_to_y_row_c;
-    }
-    else if (mode == simd_mode::ssse3)
+void bgra_to_420(unsigned char *destination[3], const int dst_stride[3], const unsigned char *const source[3],
+    const int width, const int height, const int src_stride[3], simd_mode mode, conversion_precision precision)
+{
+    const auto aligned = is_aligned_420(destination, dst_stride, source[0], src_stride[0]);
+    const auto converters = get_row_converters_420(pixel_format::bgra, mode, aligned, precision);
+    convert_rows_420(converters, destination, dst_stride, source[0], src_stride[0], width, 0, height);
+}
+
+static void bgrx_to_420_padded(pixel_format format, unsigned char *destination[3], const int dst_stride[3],
+    const unsigned char *const source[3], const int width, const int height, const int src_stride[3], simd_mode mode,
+    const output_padding &padding)
+{
+    const auto aligned = is_aligned_420(destination, dst_stride, source[0], src_stride[0]);
+    const auto converters = get_row_converters_420(format, mode, aligned);
+    for (int row = 0; row < height; row += padding_chunk_height)
     {
-        yuv_row_converter = bgra_row_to_yuv_row_ssse3;
-        y_row_converter = bgra_row_to_y_row_ssse3;
+        const auto last_row = std::min(height, row + padding_chunk_height);
+        convert_rows_420(converters, destination, dst_stride, source[0], src_stride[0], width, row, last_row);
+        pad_rows_420(destination, dst_stride, width, height, padding, row, last_row, mode);
     }
+}
+
+void bgr_to_420_padded(unsigned char *destination[3], const int dst_stride[3], const unsigned char *const source[3],
+    const int width, const int height, const int src_stride[3], simd_mode mode, const output_padding &padding)
+{
+    bgrx_to_420_padded(pixel_format::bgr, destination, dst_stride, source, width, height, src_stride, mode, padding);
+}
 
-    for (int line = 0; line < height; line += 2)
+void bgra_to_420_padded(unsigned char *destination[3], const int dst_stride[3], const unsigned char *const source[3],
+    const int width, const int height, const int src_stride[3], simd_mode mode, const output_padding &padding)
+{
+    bgrx_to_420_padded(pixel_format::bgra, destination, dst_stride, source, width, height, src_stride, mode, padding);
+}
+
+void bgra_premultiplied_to_420(unsigned char *destination[3], const int dst_stride[3],
+    const unsigned char *const source[3], const int width, const int height, const int src_stride[3], simd_mode mode)
+{
+    row_converters_420 converters{bgra_premultiplied_row_to_yuv_row_c, bgra_premultiplied_row_to_y_row_c};
+#if YUVCONVERT_X86
+    if (use_x86_kernels(mode))
+        converters = {bgra_premultiplied_row_to_yuv_row_ssse3, bgra_premultiplied_row_to_y_row_ssse3};
+#endif
+    convert_rows_420(converters, destination, dst_stride, source[0], src_stride[0], width, 0, height);
+}
+
+field_420 get_field_420(unsigned char *const destination[3], const int dst_stride[3],
+    const unsigned char *source, const int src_stride, const int height, const int field)
+{
+    const auto chroma_height = (height + 1) >> 1;
+    const auto field_height = (height - field + 1) >> 1;
+    const auto field_chroma_height = (chroma_height - field + 1) >> 1;
+
+    field_420 result;
+    for (int plane = 0; plane < 3; ++plane)
     {
-        yuv_row_converter(src, y, u, v, width);
-        src += raw_stride;
-        y += y_stride;
-        u += u_stride;
-        v += v_stride;
-        y_row_converter(src, y, width);
-        src += raw_stride;
-        y += y_stride;
+        result.destination[plane] = destination[plane] + field * dst_stride[plane];
+        result.dst_stride[plane] = dst_stride[plane] * 2;
     }
+    result.source = source + field * src_stride;
+    result.src_stride = src_stride * 2;
+    result.height = field_height;
+    result.paired_height = std::min(field_height, field_chroma_height * 2);
+    return result;
+}
+
+void convert_field_420(const row_converters_420 &converters, const field_420 &field, const int width)
+{
+    convert_rows_420(converters, field.destination, field.dst_stride, field.source, field.src_stride, width, 0,
+        field.paired_height);
+
+    for (int row = field.paired_height; row < field.height; ++row)
+        converters.y_row(field.source + row * field.src_stride, field.destination[0] + row * field.dst_stride[0], width);
+}
+
+static void bgrx_to_420_interlaced(pixel_format format, unsigned char *destination[3], const int dst_stride[3],
+    const unsigned char *const source[3], const int width, const int height, const int src_stride[3], simd_mode mode)
+{
+    const auto aligned = is_aligned_420(destination, dst_stride, source[0], src_stride[0]);
+    const auto converters = get_row_converters_420(format, mode, aligned);
+    for (int field = 0; field < 2; ++field)
+        convert_field_420(converters, get_field_420(destination, dst_stride, source[0], src_stride[0], height, field), width);
+}
+
+void bgr_to_420_interlaced(unsigned char *destination[3], const int dst_stride[3], const unsigned char *const source[3],
+    const int width, const int height, const int src_stride[3], simd_mode mode)
+{
+    bgrx_to_420_interlaced(pixel_format::bgr, destination, dst_stride, source, width, height, src_stride, mode);
+}
+
+void bgra_to_420_interlaced(unsigned char *destination[3], const int dst_stride[3], const unsigned char *const source[3],
+    const int width, const int height, const int src_stride[3], simd_mode mode)
+{
+    bgrx_to_420_interlaced(pixel_format::bgra, destination, dst_stride, source, width, height, src_stride, mode);
 }
 
 } // namespace yuvconvert
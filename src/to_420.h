@@ -20,3 +20,70 @@
  */
 
 #pragma once
+
+#include "row_converter.h"
+#include "yuvconvert.h"
+
+namespace yuvconvert
+{
+
+struct row_converters_420
+{
+    bgrx_row_to_yuv_row *yuv_row;
+    bgrx_row_to_y_row *y_row;
+};
+
+// aligned picks the converters that use aligned loads and stores, see is_aligned_420. There are no
+// aligned floating point converters, aligned is ignored for those.
+row_converters_420 get_row_converters_420(pixel_format format, simd_mode mode, bool aligned = false,
+    conversion_precision precision = conversion_precision::fixed_point);
+
+// true if every row of the source and the luma plane starts on a 16 byte boundary, which is always
+// the case for frames from the frame pool.
+bool is_aligned_420(unsigned char *const destination[3], const int dst_stride[3],
+    const unsigned char *source, const int src_stride);
+
+// convert the rows [first_row, last_row) of a frame, first_row has to be even. destination and
+// source point to the top left of the frame, so a frame can be converted in independent bands.
+void convert_rows_420(const row_converters_420 &converters, unsigned char *const destination[3],
+    const int dst_stride[3], const unsigned char *source, const int src_stride, const int width,
+    const int first_row, const int last_row);
+
+// the same, but the rows are converted in chunks of a few rows that are walked in column tiles of
+// tile_width pixels, so the rows of a tile stay in the l1 cache on very wide frames. tile_width is
+// rounded down to a multiple of 16, so every tile but the last runs on whole simd blocks.
+void convert_rows_420_tiled(const row_converters_420 &converters, pixel_format format,
+    unsigned char *const destination[3], const int dst_stride[3], const unsigned char *source,
+    const int src_stride, const int width, const int first_row, const int last_row, int tile_width);
+
+// the rows that are converted between two calls of pad_rows_420 when a frame is padded in one pass.
+constexpr auto padding_chunk_height = 16;
+
+// replicate the edges of the converted rows [first_row, last_row) into the padding and the left and
+// right border, first_row has to be even. The band that holds the first row also fills the top border,
+// the band that holds the last row fills the bottom padding and border.
+void pad_rows_420(unsigned char *const destination[3], const int dst_stride[3], const int width, const int height,
+    const output_padding &padding, const int first_row, const int last_row, simd_mode mode);
+
+// one field of an interlaced frame: every other row of the source and the luma plane, and every
+// other row of the chroma planes. Chroma row 2k + field comes from the row pair k of the field.
+// When the frame height is not a multiple of 4 the frame has no chroma row left for the last row
+// of a field, the rows from paired_height on are converted as luma only.
+struct field_420
+{
+    unsigned char *destination[3];
+    int dst_stride[3];
+    const unsigned char *source;
+    int src_stride;
+    int height;
+    int paired_height;
+};
+
+// field 0 starts at the first row of the frame, field 1 at the second.
+field_420 get_field_420(unsigned char *const destination[3], const int dst_stride[3],
+    const unsigned char *source, const int src_stride, const int height, const int field);
+
+// convert a whole field on the calling thread.
+void convert_field_420(const row_converters_420 &converters, const field_420 &field, const int width);
+
+} // namespace yuvconvert
@@ -21,61 +21,92 @@
 
 #include "to_420_c.h"
 #include "yuvconvert_common.h"
+#include "simd_utility.h"
+
+// read the color of a pixel, premultiplied pixels are divided by their alpha.
+template<int pixel_width, bool premultiplied>
+static inline void bgrx_pixel(const unsigned char *src, uint8_t &r, uint8_t &g, uint8_t &b)
+{
+    r = src[2];
+    g = src[1];
+    b = src[0];
+    if constexpr (premultiplied)
+    {
+        r = unpremultiply(r, src[3]);
+        g = unpremultiply(g, src[3]);
+        b = unpremultiply(b, src[3]);
+    }
+}
 
 // c implementation for converting a rgbx row to y
-template<int pixel_width>
+template<int pixel_width, bool premultiplied = false>
 constexpr void bgrx_row_to_y_row(const unsigned char *src, unsigned char *dst, const int width)
 {
     for (int x = 0; x < width; ++x)
     {
-        *dst++ = rgb2y(
-            src[2], // r
-            src[1], // g
-            src[0]);// b
+        uint8_t r, g, b;
+        bgrx_pixel<pixel_width, premultiplied>(src, r, g, b);
+        *dst++ = rgb2y(r, g, b);
         src += pixel_width;
     }
 }
 
-template<int pixel_width>
+template<int pixel_width, bool premultiplied = false>
 constexpr void bgrx_row_to_yuv_row(const unsigned char *src, unsigned char *dst_y,
                                    unsigned char *dst_u, unsigned char *dst_v, const int width)
 {
     for (int x = 0; x < width; x += 2)
     {
-        auto r = src[2];
-        auto g = src[1];
-        auto b = src[0];
+        uint8_t r, g, b;
+        bgrx_pixel<pixel_width, premultiplied>(src, r, g, b);
         *dst_y++ = rgb2y(r, g, b);
         *dst_u++ = rgb2u(r, g, b);
         *dst_v++ = rgb2v(r, g, b);
         src += pixel_width;
 
-        r = src[2];
-        g = src[1];
-        b = src[0];
+        // an odd width ends with a single chroma carrying pixel.
+        if (x + 1 == width)
+            break;
+
+        bgrx_pixel<pixel_width, premultiplied>(src, r, g, b);
         *dst_y++ = rgb2y(r, g, b);
         src += pixel_width;
     }
 }
 
+__target_clones
 void bgra_row_to_y_row_c(const unsigned char *src, unsigned char *dst, const int width)
 {
     bgrx_row_to_y_row<4>(src, dst, width);
 }
 
+__target_clones
 void bgra_row_to_yuv_row_c(const unsigned char *src, unsigned char *dst_y, unsigned char *dst_u,
                            unsigned char *dst_v, const int width)
 {
     bgrx_row_to_yuv_row<4>(src, dst_y, dst_u, dst_v, width);
 }
 
+__target_clones
 void bgr_row_to_y_row_c(const unsigned char *src, unsigned char *dst, const int width)
 {
     bgrx_row_to_y_row<3>(src, dst, width);
 }
 
+__target_clones
 void bgr_row_to_yuv_row_c(const unsigned char *src, unsigned char *dst_y, unsigned char *dst_u,
                           unsigned char *dst_v, const int width)
 {
     bgrx_row_to_yuv_row<3>(src, dst_y, dst_u, dst_v, width);
 }
+
+void bgra_premultiplied_row_to_y_row_c(const unsigned char *src, unsigned char *dst, const int width)
+{
+    bgrx_row_to_y_row<4, true>(src, dst, width);
+}
+
+void bgra_premultiplied_row_to_yuv_row_c(const unsigned char *src, unsigned char *dst_y, unsigned char *dst_u,
+    unsigned char *dst_v, const int width)
+{
+    bgrx_row_to_yuv_row<4, true>(src, dst_y, dst_u, dst_v, width);
+}
@@ -27,3 +27,8 @@ void bgra_row_to_yuv_row_c(const unsigned char *src, unsigned char *dst_y, unsig
 void bgr_row_to_y_row_c(const unsigned char *src, unsigned char *dst, const int width);
 void bgr_row_to_yuv_row_c(const unsigned char *src, unsigned char *dst_y, unsigned char *dst_u,
     unsigned char *dst_v, const int width);
+
+// premultiplied bgra, the color is divided by alpha first.
+void bgra_premultiplied_row_to_y_row_c(const unsigned char *src, unsigned char *dst, const int width);
+void bgra_premultiplied_row_to_yuv_row_c(const unsigned char *src, unsigned char *dst_y, unsigned char *dst_u,
+    unsigned char *dst_v, const int width);
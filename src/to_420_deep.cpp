@@ -0,0 +1,113 @@
+/* Copyright(c) 2018 Steven Hoving
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "to_420_deep_c.h"
+#include "to_420_deep_ssse3.h"
+#include "row_converter.h"
+#include "cpu_features.h"
+#include "yuvconvert.h"
+#include "yuvconvert_common.h"
+
+namespace yuvconvert
+{
+
+// a 4x4 ordered (bayer) dither matrix.
+static constexpr int bayer_4x4[4][4] = {
+    {0, 8, 2, 10},
+    {12, 4, 14, 6},
+    {3, 11, 1, 9},
+    {15, 7, 13, 5}};
+
+// the thresholds of one row, in units of 1 / (1 << deep_fixed_point_precision) of an 8 bit step.
+// The dither thresholds are the centers of 16 equal steps, so they average to deep_half and the
+// dither does not shift the mean.
+static void get_thresholds(const bool dither, const int row, int thresholds[4])
+{
+    constexpr auto step = 1 << (deep_fixed_point_precision - 4);
+    for (int x = 0; x < 4; ++x)
+        thresholds[x] = dither ? bayer_4x4[row & 3][x] * step + step / 2 : deep_half;
+}
+
+static void deep_to_420(unsigned char *destination[3], const int dst_stride[3], const unsigned short *source,
+    const int src_stride, const int width, const int height, const int bit_depth, const bool dither,
+    deep_row_to_yuv_row *yuv_row_converter, deep_row_to_y_row *y_row_converter)
+{
+    auto src = reinterpret_cast<const unsigned char *>(source);
+    auto y = destination[0];
+    auto u = destination[1];
+    auto v = destination[2];
+
+    int luma_thresholds[4];
+    int chroma_thresholds[4];
+    for (int line = 0; line < height; line += 2)
+    {
+        get_thresholds(dither, line, luma_thresholds);
+        get_thresholds(dither, line >> 1, chroma_thresholds);
+        yuv_row_converter(reinterpret_cast<const unsigned short *>(src), y, u, v, width, bit_depth,
+            luma_thresholds, chroma_thresholds);
+
+        // an odd height ends with a single chroma carrying row.
+        if (line + 1 == height)
+            break;
+
+        src += src_stride;
+        y += dst_stride[0];
+        get_thresholds(dither, line + 1, luma_thresholds);
+        y_row_converter(reinterpret_cast<const unsigned short *>(src), y, width, bit_depth, luma_thresholds);
+
+        src += src_stride;
+        y += dst_stride[0];
+        u += dst_stride[1];
+        v += dst_stride[2];
+    }
+}
+
+void bgr48_to_420(unsigned char *destination[3], const int dst_stride[3], const unsigned short *source,
+    const int src_stride, const int width, const int height, const int bit_depth, const bool dither, simd_mode mode)
+{
+#if YUVCONVERT_X86
+    if (use_x86_kernels(mode))
+    {
+        deep_to_420(destination, dst_stride, source, src_stride, width, height, bit_depth, dither,
+            bgr48_row_to_yuv_row_ssse3, bgr48_row_to_y_row_ssse3);
+        return;
+    }
+#endif
+    deep_to_420(destination, dst_stride, source, src_stride, width, height, bit_depth, dither,
+        bgr48_row_to_yuv_row_c, bgr48_row_to_y_row_c);
+}
+
+void bgra64_to_420(unsigned char *destination[3], const int dst_stride[3], const unsigned short *source,
+    const int src_stride, const int width, const int height, const int bit_depth, const bool dither, simd_mode mode)
+{
+#if YUVCONVERT_X86
+    if (use_x86_kernels(mode))
+    {
+        deep_to_420(destination, dst_stride, source, src_stride, width, height, bit_depth, dither,
+            bgra64_row_to_yuv_row_ssse3, bgra64_row_to_y_row_ssse3);
+        return;
+    }
+#endif
+    deep_to_420(destination, dst_stride, source, src_stride, width, height, bit_depth, dither,
+        bgra64_row_to_yuv_row_c, bgra64_row_to_y_row_c);
+}
+
+} // namespace yuvconvert
@@ -0,0 +1,86 @@
+/* Copyright(c) 2018 Steven Hoving
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "to_420_deep_c.h"
+#include "yuvconvert_common.h"
+
+template<int pixel_width>
+static void deep_row_to_y_row(const unsigned short *src, unsigned char *dst, const int width, const int bit_depth,
+    const int *luma_thresholds)
+{
+    for (int x = 0; x < width; ++x)
+    {
+        const auto r = deep_normalize(src[2], bit_depth);
+        const auto g = deep_normalize(src[1], bit_depth);
+        const auto b = deep_normalize(src[0], bit_depth);
+        *dst++ = deep2y(r, g, b, luma_thresholds[x & 3]);
+        src += pixel_width;
+    }
+}
+
+template<int pixel_width>
+static void deep_row_to_yuv_row(const unsigned short *src, unsigned char *dst_y, unsigned char *dst_u,
+    unsigned char *dst_v, const int width, const int bit_depth, const int *luma_thresholds,
+    const int *chroma_thresholds)
+{
+    for (int x = 0; x < width; ++x)
+    {
+        const auto r = deep_normalize(src[2], bit_depth);
+        const auto g = deep_normalize(src[1], bit_depth);
+        const auto b = deep_normalize(src[0], bit_depth);
+        *dst_y++ = deep2y(r, g, b, luma_thresholds[x & 3]);
+
+        // chroma is taken from the even pixels.
+        if ((x & 1) == 0)
+        {
+            const auto threshold = chroma_thresholds[(x >> 1) & 3];
+            *dst_u++ = deep2u(r, g, b, threshold);
+            *dst_v++ = deep2v(r, g, b, threshold);
+        }
+        src += pixel_width;
+    }
+}
+
+void bgr48_row_to_y_row_c(const unsigned short *src, unsigned char *dst, const int width, const int bit_depth,
+    const int *luma_thresholds)
+{
+    deep_row_to_y_row<3>(src, dst, width, bit_depth, luma_thresholds);
+}
+
+void bgr48_row_to_yuv_row_c(const unsigned short *src, unsigned char *dst_y, unsigned char *dst_u,
+    unsigned char *dst_v, const int width, const int bit_depth, const int *luma_thresholds,
+    const int *chroma_thresholds)
+{
+    deep_row_to_yuv_row<3>(src, dst_y, dst_u, dst_v, width, bit_depth, luma_thresholds, chroma_thresholds);
+}
+
+void bgra64_row_to_y_row_c(const unsigned short *src, unsigned char *dst, const int width, const int bit_depth,
+    const int *luma_thresholds)
+{
+    deep_row_to_y_row<4>(src, dst, width, bit_depth, luma_thresholds);
+}
+
+void bgra64_row_to_yuv_row_c(const unsigned short *src, unsigned char *dst_y, unsigned char *dst_u,
+    unsigned char *dst_v, const int width, const int bit_depth, const int *luma_thresholds,
+    const int *chroma_thresholds)
+{
+    deep_row_to_yuv_row<4>(src, dst_y, dst_u, dst_v, width, bit_depth, luma_thresholds, chroma_thresholds);
+}
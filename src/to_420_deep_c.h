@@ -0,0 +1,34 @@
+/* Copyright(c) 2018 Steven Hoving
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+// bgr48 and bgra64 rows, samples of bit_depth bits in the low bits of every 16 bit channel.
+void bgr48_row_to_y_row_c(const unsigned short *src, unsigned char *dst, const int width, const int bit_depth,
+    const int *luma_thresholds);
+void bgr48_row_to_yuv_row_c(const unsigned short *src, unsigned char *dst_y, unsigned char *dst_u,
+    unsigned char *dst_v, const int width, const int bit_depth, const int *luma_thresholds,
+    const int *chroma_thresholds);
+void bgra64_row_to_y_row_c(const unsigned short *src, unsigned char *dst, const int width, const int bit_depth,
+    const int *luma_thresholds);
+void bgra64_row_to_yuv_row_c(const unsigned short *src, unsigned char *dst_y, unsigned char *dst_u,
+    unsigned char *dst_v, const int width, const int bit_depth, const int *luma_thresholds,
+    const int *chroma_thresholds);
@@ -0,0 +1,178 @@
+/* Copyright(c) 2018 Steven Hoving
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "to_420_deep_ssse3.h"
+#include "yuvconvert_common.h"
+#include "simd_utility.h"
+
+#include <emmintrin.h>
+#include <tmmintrin.h>
+#include <cstring>
+
+namespace
+{
+// 2 pixels in the 16 bit lanes [b g r x b g r x], the 4th channel is multiplied by 0.
+const auto y_factors = _mm_setr_epi16(25, 129, 66, 0, 25, 129, 66, 0);
+const auto u_factors = _mm_setr_epi16(112, -74, -38, 0, 112, -74, -38, 0);
+const auto v_factors = _mm_setr_epi16(-18, -94, 112, 0, -18, -94, 112, 0);
+
+// spread 2 bgr48 pixels over 2x 4 lanes. The second pair of a group of 4 pixels is loaded at byte
+// offset 8 and starts at byte 4, so we never read beyond the 24 bytes of the group.
+const auto bgr48_expand_lo = _mm_setr_epi8(0, 1, 2, 3, 4, 5, -1, -1, 6, 7, 8, 9, 10, 11, -1, -1);
+const auto bgr48_expand_hi = _mm_setr_epi8(4, 5, 6, 7, 8, 9, -1, -1, 10, 11, 12, 13, 14, 15, -1, -1);
+} // namespace
+
+// the sample shifts that normalize bit_depth bits to deep_input_bits.
+struct normalize_shift
+{
+    __m128i left;
+    __m128i right;
+};
+
+static __forceinline normalize_shift get_normalize_shift(const int bit_depth)
+{
+    return {_mm_cvtsi32_si128(bit_depth <= deep_input_bits ? deep_input_bits - bit_depth : 0),
+        _mm_cvtsi32_si128(bit_depth > deep_input_bits ? bit_depth - deep_input_bits : 0)};
+}
+
+// load 4 pixels as 2x 2 pixels, normalized to deep_input_bits.
+template<int pixel_width>
+static __forceinline void group_load(const unsigned short *src, const normalize_shift &shift, __m128i &pixels01,
+    __m128i &pixels23)
+{
+    if constexpr (pixel_width == 4)
+    {
+        pixels01 = _mm_loadu_si128((const __m128i *)src);
+        pixels23 = _mm_loadu_si128((const __m128i *)(src + 8));
+    }
+    else
+    {
+        pixels01 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)src), bgr48_expand_lo);
+        pixels23 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)(src + 4)), bgr48_expand_hi);
+    }
+
+    pixels01 = _mm_srl_epi16(_mm_sll_epi16(pixels01, shift.left), shift.right);
+    pixels23 = _mm_srl_epi16(_mm_sll_epi16(pixels23, shift.left), shift.right);
+}
+
+// the weighted sums of 4 pixels, plus the thresholds, shifted down to 8 bit steps.
+static __forceinline __m128i weighted_sum(const __m128i pixels01, const __m128i pixels23, const __m128i factors,
+    const __m128i thresholds)
+{
+    const auto sum = _mm_hadd_epi32(_mm_madd_epi16(pixels01, factors), _mm_madd_epi16(pixels23, factors));
+    return _mm_srai_epi32(_mm_add_epi32(sum, thresholds), deep_fixed_point_precision);
+}
+
+static __forceinline int pack_4_bytes(const __m128i values, const __m128i offset)
+{
+    const auto words = _mm_add_epi16(_mm_packs_epi32(values, values), offset);
+    return _mm_cvtsi128_si32(_mm_packus_epi16(words, words));
+}
+
+// 8 pixels per iteration. The dither matrix is 4 columns wide, so every group of 4 luma samples and
+// the 4 chroma samples of a block use the same thresholds.
+template<int pixel_width, bool chroma>
+static void deep_row_to_yuv_row(const unsigned short *src, unsigned char *dst_y, unsigned char *dst_u,
+    unsigned char *dst_v, const int width, const int bit_depth, const int *luma_thresholds,
+    const int *chroma_thresholds)
+{
+    const auto shift = get_normalize_shift(bit_depth);
+    const auto luma = _mm_loadu_si128((const __m128i *)luma_thresholds);
+    const auto luma_offset = _mm_set1_epi16(16);
+    const auto chroma_offset = _mm_set1_epi16(128);
+
+    const int simd_width = simd::align_down(width, 8);
+
+    int x = 0;
+    for (; x < simd_width; x += 8)
+    {
+        __m128i pixels01;
+        __m128i pixels23;
+        __m128i pixels45;
+        __m128i pixels67;
+        group_load<pixel_width>(src, shift, pixels01, pixels23);
+        group_load<pixel_width>(src + 4 * pixel_width, shift, pixels45, pixels67);
+
+        const auto y_lo = weighted_sum(pixels01, pixels23, y_factors, luma);
+        const auto y_hi = weighted_sum(pixels45, pixels67, y_factors, luma);
+        const auto y_words = _mm_add_epi16(_mm_packs_epi32(y_lo, y_hi), luma_offset);
+        _mm_storel_epi64((__m128i *)dst_y, _mm_packus_epi16(y_words, y_words));
+
+        if constexpr (chroma)
+        {
+            const auto thresholds = _mm_loadu_si128((const __m128i *)chroma_thresholds);
+
+            // chroma is taken from the even pixels, the low half of every pair.
+            const auto even02 = _mm_unpacklo_epi64(pixels01, pixels23);
+            const auto even46 = _mm_unpacklo_epi64(pixels45, pixels67);
+            const auto u = pack_4_bytes(weighted_sum(even02, even46, u_factors, thresholds), chroma_offset);
+            const auto v = pack_4_bytes(weighted_sum(even02, even46, v_factors, thresholds), chroma_offset);
+            std::memcpy(dst_u, &u, 4);
+            std::memcpy(dst_v, &v, 4);
+            dst_u += 4;
+            dst_v += 4;
+        }
+
+        src += 8 * pixel_width;
+        dst_y += 8;
+    }
+
+    for (; x < width; ++x)
+    {
+        const auto r = deep_normalize(src[2], bit_depth);
+        const auto g = deep_normalize(src[1], bit_depth);
+        const auto b = deep_normalize(src[0], bit_depth);
+        *dst_y++ = deep2y(r, g, b, luma_thresholds[x & 3]);
+        if (chroma && (x & 1) == 0)
+        {
+            const auto threshold = chroma_thresholds[(x >> 1) & 3];
+            *dst_u++ = deep2u(r, g, b, threshold);
+            *dst_v++ = deep2v(r, g, b, threshold);
+        }
+        src += pixel_width;
+    }
+}
+
+void bgr48_row_to_y_row_ssse3(const unsigned short *src, unsigned char *dst, const int width, const int bit_depth,
+    const int *luma_thresholds)
+{
+    deep_row_to_yuv_row<3, false>(src, dst, nullptr, nullptr, width, bit_depth, luma_thresholds, nullptr);
+}
+
+void bgr48_row_to_yuv_row_ssse3(const unsigned short *src, unsigned char *dst_y, unsigned char *dst_u,
+    unsigned char *dst_v, const int width, const int bit_depth, const int *luma_thresholds,
+    const int *chroma_thresholds)
+{
+    deep_row_to_yuv_row<3, true>(src, dst_y, dst_u, dst_v, width, bit_depth, luma_thresholds, chroma_thresholds);
+}
+
+void bgra64_row_to_y_row_ssse3(const unsigned short *src, unsigned char *dst, const int width, const int bit_depth,
+    const int *luma_thresholds)
+{
+    deep_row_to_yuv_row<4, false>(src, dst, nullptr, nullptr, width, bit_depth, luma_thresholds, nullptr);
+}
+
+void bgra64_row_to_yuv_row_ssse3(const unsigned short *src, unsigned char *dst_y, unsigned char *dst_u,
+    unsigned char *dst_v, const int width, const int bit_depth, const int *luma_thresholds,
+    const int *chroma_thresholds)
+{
+    deep_row_to_yuv_row<4, true>(src, dst_y, dst_u, dst_v, width, bit_depth, luma_thresholds, chroma_thresholds);
+}
@@ -0,0 +1,107 @@
+/* Copyright(c) 2018 Steven Hoving
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "to_420_fixed_ssse3.h"
+#include "simd_bgrx.h"
+
+#include <tmmintrin.h>
+
+using namespace simd;
+
+namespace yuvconvert
+{
+
+// every row of the frame is converted in width / 16 whole blocks, the trip count is a compile time
+// constant so the compiler is free to unroll, and there is no tail to handle.
+template<int pixel_width, int width, bool aligned>
+static void rows_to_420_fixed(unsigned char *const destination[3], const int dst_stride[3],
+    const unsigned char *source, const int src_stride, const int first_row, const int last_row)
+{
+    static_assert(width % 16 == 0, "a specialized width has to be a multiple of the block size");
+    constexpr auto block_count = width / 16;
+    constexpr auto block_size = 16 * pixel_width;
+
+    auto src = source + first_row * src_stride;
+    auto y = destination[0] + first_row * dst_stride[0];
+    auto u = destination[1] + (first_row >> 1) * dst_stride[1];
+    auto v = destination[2] + (first_row >> 1) * dst_stride[2];
+
+    for (int line = first_row; line < last_row; line += 2)
+    {
+        for (int block = 0; block < block_count; ++block)
+        {
+            vec3 vec_part0;
+            vec3 vec_part1;
+            bgrx_block_unpack<pixel_width, aligned>(src + block * block_size, vec_part0, vec_part1);
+            block_store<aligned>(y + block * 16, block_to_y(vec_part0, vec_part1));
+
+            // calculate uv, we only keep every even pixel
+            const auto u_0 = chroma_pack_even(block_to_chroma(vec_part0, vec_part1, u_mul));
+            const auto v_0 = chroma_pack_even(block_to_chroma(vec_part0, vec_part1, v_mul));
+            _mm_storel_epi64((__m128i *)(u + block * 8), u_0);
+            _mm_storel_epi64((__m128i *)(v + block * 8), v_0);
+        }
+
+        // an odd height ends with a single chroma carrying row.
+        if (line + 1 == last_row)
+            break;
+
+        src += src_stride;
+        y += dst_stride[0];
+        for (int block = 0; block < block_count; ++block)
+        {
+            vec3 vec_part0;
+            vec3 vec_part1;
+            bgrx_block_unpack<pixel_width, aligned>(src + block * block_size, vec_part0, vec_part1);
+            block_store<aligned>(y + block * 16, block_to_y(vec_part0, vec_part1));
+        }
+
+        src += src_stride;
+        y += dst_stride[0];
+        u += dst_stride[1];
+        v += dst_stride[2];
+    }
+}
+
+template<int width>
+static fixed_rows_420 *get_fixed_rows_420(pixel_format format, bool aligned)
+{
+    if (format == pixel_format::bgra)
+        return aligned ? rows_to_420_fixed<4, width, true> : rows_to_420_fixed<4, width, false>;
+    return aligned ? rows_to_420_fixed<3, width, true> : rows_to_420_fixed<3, width, false>;
+}
+
+fixed_rows_420 *get_fixed_rows_420_ssse3(pixel_format format, int width, bool aligned)
+{
+    switch (width)
+    {
+    case 1280:
+        return get_fixed_rows_420<1280>(format, aligned);
+    case 1920:
+        return get_fixed_rows_420<1920>(format, aligned);
+    case 3840:
+        return get_fixed_rows_420<3840>(format, aligned);
+    default:
+        return nullptr;
+    }
+}
+
+} // namespace yuvconvert
@@ -0,0 +1,38 @@
+/* Copyright(c) 2018 Steven Hoving
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include "yuvconvert.h"
+
+namespace yuvconvert
+{
+
+// converts the rows [first_row, last_row) of a frame, like convert_rows_420, for one compile time
+// width.
+using fixed_rows_420 = void(unsigned char *const destination[3], const int dst_stride[3],
+    const unsigned char *source, const int src_stride, const int first_row, const int last_row);
+
+// the ssse3 converter specialized for this width, or nullptr. Only the common video widths (1280,
+// 1920 and 3840) are specialized, they are all a multiple of 16 so the rows have no scalar tail.
+fixed_rows_420 *get_fixed_rows_420_ssse3(pixel_format format, int width, bool aligned);
+
+} // namespace yuvconvert
@@ -0,0 +1,179 @@
+/* Copyright(c) 2018 Steven Hoving
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "to_420_float_avx2.h"
+#include "to_420_float_c.h"
+#include "yuvconvert_common.h"
+#include "simd_utility.h"
+
+#include <immintrin.h>
+#include <array>
+#include <cstring>
+
+namespace
+{
+// one row of the matrix and its offset, broadcast.
+struct factors
+{
+    __m256d r;
+    __m256d g;
+    __m256d b;
+    __m256d offset;
+};
+} // namespace
+
+// the coefficients are read in constant expressions, so no std::array accessor is instantiated in
+// this object.
+template<const std::array<double, 3> &factor>
+static __forceinline factors broadcast(const double offset)
+{
+    constexpr auto r = factor[0];
+    constexpr auto g = factor[1];
+    constexpr auto b = factor[2];
+    return {_mm256_set1_pd(r), _mm256_set1_pd(g), _mm256_set1_pd(b), _mm256_set1_pd(offset)};
+}
+
+// load 8 pixels (a block) in 32 bit lanes.
+template<int pixel_width>
+static __forceinline __m256i block_load(const unsigned char *src, const __m256i bgr_expand)
+{
+    if constexpr (pixel_width == 4)
+        return _mm256_loadu_si256((const __m256i *)src);
+
+    const auto lo = _mm_loadu_si128((const __m128i *)src);
+    const auto hi = _mm_loadu_si128((const __m128i *)(src + 8));
+    return _mm256_shuffle_epi8(_mm256_inserti128_si256(_mm256_castsi128_si256(lo), hi, 1), bgr_expand);
+}
+
+static __forceinline __m256i channel(const __m256i pixels, const int shift, const __m256i byte_mask)
+{
+    return _mm256_and_si256(_mm256_srli_epi32(pixels, shift), byte_mask);
+}
+
+// the sum of 4 pixels in the order rgbconvert<floating_point> evaluates it, so every sample is bit
+// exact with the c reference. Clamped and truncated to 32 bits.
+static __forceinline __m128i weighted_sum(const __m128i r, const __m128i g, const __m128i b, const factors &factor)
+{
+    auto sum = _mm256_mul_pd(_mm256_cvtepi32_pd(r), factor.r);
+    sum = _mm256_add_pd(sum, _mm256_mul_pd(_mm256_cvtepi32_pd(g), factor.g));
+    sum = _mm256_add_pd(sum, _mm256_mul_pd(_mm256_cvtepi32_pd(b), factor.b));
+    sum = _mm256_add_pd(sum, factor.offset);
+    sum = _mm256_min_pd(_mm256_max_pd(sum, _mm256_setzero_pd()), _mm256_set1_pd(255.0));
+    return _mm256_cvttpd_epi32(sum);
+}
+
+template<int pixel_width, bool chroma>
+static void bgrx_row_to_yuv_row_float(const unsigned char *src, unsigned char *dst_y, unsigned char *dst_u,
+    unsigned char *dst_v, const int width)
+{
+    // the constants are built here instead of at namespace scope, a dynamic initializer of this
+    // translation unit would run avx2 code at startup, before the cpu check.
+    const auto byte_mask = _mm256_set1_epi32(0xff);
+
+    // spread 8 bgr pixels over the 32 bit lanes, the upper 4 pixels are loaded at offset 8 and start
+    // at byte 4, so we never read beyond the 24 bytes of the block.
+    const auto bgr_expand = _mm256_setr_epi8(
+        0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11, -1,
+        4, 5, 6, -1, 7, 8, 9, -1, 10, 11, 12, -1, 13, 14, 15, -1);
+
+    // the even pixels of a block, in the lower 4 lanes.
+    const auto even_pixels = _mm256_setr_epi32(0, 2, 4, 6, 0, 2, 4, 6);
+
+    const auto luma = broadcast<luma_factor>(16.5);
+    const auto chroma_u = broadcast<chroma_u_factor>(128.5);
+    const auto chroma_v = broadcast<chroma_v_factor>(128.5);
+
+    const int simd_width = simd::align_down(width, 8);
+
+    int x = 0;
+    for (; x < simd_width; x += 8)
+    {
+        const auto pixels = block_load<pixel_width>(src, bgr_expand);
+        const auto b = channel(pixels, 0, byte_mask);
+        const auto g = channel(pixels, 8, byte_mask);
+        const auto r = channel(pixels, 16, byte_mask);
+
+        const auto y_lo = weighted_sum(_mm256_castsi256_si128(r), _mm256_castsi256_si128(g),
+            _mm256_castsi256_si128(b), luma);
+        const auto y_hi = weighted_sum(_mm256_extracti128_si256(r, 1), _mm256_extracti128_si256(g, 1),
+            _mm256_extracti128_si256(b, 1), luma);
+        const auto y_words = _mm_packs_epi32(y_lo, y_hi);
+        _mm_storel_epi64((__m128i *)dst_y, _mm_packus_epi16(y_words, y_words));
+
+        if constexpr (chroma)
+        {
+            // chroma is taken from the even pixels.
+            const auto b_even = _mm256_castsi256_si128(_mm256_permutevar8x32_epi32(b, even_pixels));
+            const auto g_even = _mm256_castsi256_si128(_mm256_permutevar8x32_epi32(g, even_pixels));
+            const auto r_even = _mm256_castsi256_si128(_mm256_permutevar8x32_epi32(r, even_pixels));
+
+            const auto u = weighted_sum(r_even, g_even, b_even, chroma_u);
+            const auto v = weighted_sum(r_even, g_even, b_even, chroma_v);
+            const auto uv_words = _mm_packs_epi32(u, v);
+            const auto uv_bytes = _mm_packus_epi16(uv_words, uv_words);
+            const auto u_bytes = _mm_cvtsi128_si32(uv_bytes);
+            const auto v_bytes = _mm_cvtsi128_si32(_mm_srli_si128(uv_bytes, 4));
+            std::memcpy(dst_u, &u_bytes, 4);
+            std::memcpy(dst_v, &v_bytes, 4);
+            dst_u += 4;
+            dst_v += 4;
+        }
+
+        src += 8 * pixel_width;
+        dst_y += 8;
+    }
+
+    // the tail starts on an even pixel and goes through the c kernels, inline helpers would be
+    // instantiated in this object with its code generation flags.
+    if (x == width)
+        return;
+
+    if constexpr (pixel_width == 4 && chroma)
+        bgra_row_to_yuv_row_float_c(src, dst_y, dst_u, dst_v, width - x);
+    else if constexpr (pixel_width == 4)
+        bgra_row_to_y_row_float_c(src, dst_y, width - x);
+    else if constexpr (chroma)
+        bgr_row_to_yuv_row_float_c(src, dst_y, dst_u, dst_v, width - x);
+    else
+        bgr_row_to_y_row_float_c(src, dst_y, width - x);
+}
+
+void bgra_row_to_y_row_float_avx2(const unsigned char *src, unsigned char *dst, const int width)
+{
+    bgrx_row_to_yuv_row_float<4, false>(src, dst, nullptr, nullptr, width);
+}
+
+void bgra_row_to_yuv_row_float_avx2(const unsigned char *src, unsigned char *dst_y, unsigned char *dst_u,
+    unsigned char *dst_v, const int width)
+{
+    bgrx_row_to_yuv_row_float<4, true>(src, dst_y, dst_u, dst_v, width);
+}
+
+void bgr_row_to_y_row_float_avx2(const unsigned char *src, unsigned char *dst, const int width)
+{
+    bgrx_row_to_yuv_row_float<3, false>(src, dst, nullptr, nullptr, width);
+}
+
+void bgr_row_to_yuv_row_float_avx2(const unsigned char *src, unsigned char *dst_y, unsigned char *dst_u,
+    unsigned char *dst_v, const int width)
+{
+    bgrx_row_to_yuv_row_float<3, true>(src, dst_y, dst_u, dst_v, width);
+}
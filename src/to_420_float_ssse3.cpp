@@ -0,0 +1,208 @@
+/* Copyright(c) 2018 Steven Hoving
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "to_420_float_ssse3.h"
+#include "to_420_float_c.h"
+#include "yuvconvert_common.h"
+#include "simd_utility.h"
+
+#include <emmintrin.h>
+#include <tmmintrin.h>
+#include <array>
+#include <cstring>
+
+namespace
+{
+// the channels of 4 pixels in 32 bit lanes.
+struct channels
+{
+    __m128i b;
+    __m128i g;
+    __m128i r;
+};
+
+// one row of the matrix and its offset, broadcast.
+struct factors
+{
+    __m128d r;
+    __m128d g;
+    __m128d b;
+    __m128d offset;
+};
+} // namespace
+
+// the coefficients are read in constant expressions, so no std::array accessor is instantiated in
+// this object.
+template<const std::array<double, 3> &factor>
+static __forceinline factors broadcast(const double offset)
+{
+    constexpr auto r = factor[0];
+    constexpr auto g = factor[1];
+    constexpr auto b = factor[2];
+    return {_mm_set1_pd(r), _mm_set1_pd(g), _mm_set1_pd(b), _mm_set1_pd(offset)};
+}
+
+// load 8 pixels (a block) as 2x 4 pixels in 32 bit lanes.
+template<int pixel_width>
+static __forceinline void block_load(const unsigned char *src, __m128i &lo, __m128i &hi)
+{
+    if constexpr (pixel_width == 4)
+    {
+        lo = _mm_loadu_si128((const __m128i *)src);
+        hi = _mm_loadu_si128((const __m128i *)(src + 16));
+    }
+    else
+    {
+        // spread 4 bgr pixels over the 32 bit lanes, the pixels of the second half of a block are
+        // loaded at offset 8 and start at byte 4, so we never read beyond the 24 bytes of the block.
+        const auto bgr_expand_lo = _mm_setr_epi8(0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11, -1);
+        const auto bgr_expand_hi = _mm_setr_epi8(4, 5, 6, -1, 7, 8, 9, -1, 10, 11, 12, -1, 13, 14, 15, -1);
+        lo = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)src), bgr_expand_lo);
+        hi = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)(src + 8)), bgr_expand_hi);
+    }
+}
+
+static __forceinline channels split_channels(const __m128i pixels)
+{
+    const auto byte_mask = _mm_set1_epi32(0xff);
+    return {
+        _mm_and_si128(pixels, byte_mask),
+        _mm_and_si128(_mm_srli_epi32(pixels, 8), byte_mask),
+        _mm_and_si128(_mm_srli_epi32(pixels, 16), byte_mask)};
+}
+
+// the sum of 2 pixels (the lower lanes of the channels) in the order rgbconvert<floating_point>
+// evaluates it, so every sample is bit exact with the c reference. Clamped and truncated to 32 bits,
+// in the lower half of the result.
+static __forceinline __m128i weighted_sum(const __m128i r, const __m128i g, const __m128i b, const factors &factor)
+{
+    auto sum = _mm_mul_pd(_mm_cvtepi32_pd(r), factor.r);
+    sum = _mm_add_pd(sum, _mm_mul_pd(_mm_cvtepi32_pd(g), factor.g));
+    sum = _mm_add_pd(sum, _mm_mul_pd(_mm_cvtepi32_pd(b), factor.b));
+    sum = _mm_add_pd(sum, factor.offset);
+    sum = _mm_min_pd(_mm_max_pd(sum, _mm_setzero_pd()), _mm_set1_pd(255.0));
+    return _mm_cvttpd_epi32(sum);
+}
+
+// the sums of 4 pixels.
+static __forceinline __m128i weighted_sum(const channels &pixels, const factors &factor)
+{
+    const auto lo = weighted_sum(pixels.r, pixels.g, pixels.b, factor);
+    const auto hi = weighted_sum(_mm_srli_si128(pixels.r, 8), _mm_srli_si128(pixels.g, 8),
+        _mm_srli_si128(pixels.b, 8), factor);
+    return _mm_unpacklo_epi64(lo, hi);
+}
+
+// pack 4 or 8 values of 32 bits to bytes.
+static __forceinline __m128i pack_bytes(const __m128i lo, const __m128i hi)
+{
+    return _mm_packus_epi16(_mm_packs_epi32(lo, hi), _mm_setzero_si128());
+}
+
+// the even pixels of 2x 4 pixels.
+static __forceinline __m128i even_pixels(const __m128i lo, const __m128i hi)
+{
+    constexpr auto even = _MM_SHUFFLE(2, 0, 2, 0);
+    return _mm_castps_si128(_mm_shuffle_ps(_mm_castsi128_ps(lo), _mm_castsi128_ps(hi), even));
+}
+
+template<int pixel_width, bool chroma>
+static void bgrx_row_to_yuv_row_float(const unsigned char *src, unsigned char *dst_y, unsigned char *dst_u,
+    unsigned char *dst_v, const int width)
+{
+    // the factors are built here instead of at namespace scope, so this object has no static initializer.
+    const auto luma = broadcast<luma_factor>(16.5);
+    const auto chroma_u = broadcast<chroma_u_factor>(128.5);
+    const auto chroma_v = broadcast<chroma_v_factor>(128.5);
+
+    const int simd_width = simd::align_down(width, 8);
+
+    int x = 0;
+    for (; x < simd_width; x += 8)
+    {
+        __m128i lo;
+        __m128i hi;
+        block_load<pixel_width>(src, lo, hi);
+        const auto pixels_lo = split_channels(lo);
+        const auto pixels_hi = split_channels(hi);
+
+        const auto y_lo = weighted_sum(pixels_lo, luma);
+        const auto y_hi = weighted_sum(pixels_hi, luma);
+        _mm_storel_epi64((__m128i *)dst_y, pack_bytes(y_lo, y_hi));
+
+        if constexpr (chroma)
+        {
+            // chroma is taken from the even pixels.
+            const channels pixels = {
+                even_pixels(pixels_lo.b, pixels_hi.b),
+                even_pixels(pixels_lo.g, pixels_hi.g),
+                even_pixels(pixels_lo.r, pixels_hi.r)};
+
+            const auto u = weighted_sum(pixels, chroma_u);
+            const auto v = weighted_sum(pixels, chroma_v);
+            const auto u_bytes = _mm_cvtsi128_si32(pack_bytes(u, u));
+            const auto v_bytes = _mm_cvtsi128_si32(pack_bytes(v, v));
+            std::memcpy(dst_u, &u_bytes, 4);
+            std::memcpy(dst_v, &v_bytes, 4);
+            dst_u += 4;
+            dst_v += 4;
+        }
+
+        src += 8 * pixel_width;
+        dst_y += 8;
+    }
+
+    // the tail starts on an even pixel and goes through the c kernels, inline helpers would be
+    // instantiated in this object with its code generation flags.
+    if (x == width)
+        return;
+
+    if constexpr (pixel_width == 4 && chroma)
+        bgra_row_to_yuv_row_float_c(src, dst_y, dst_u, dst_v, width - x);
+    else if constexpr (pixel_width == 4)
+        bgra_row_to_y_row_float_c(src, dst_y, width - x);
+    else if constexpr (chroma)
+        bgr_row_to_yuv_row_float_c(src, dst_y, dst_u, dst_v, width - x);
+    else
+        bgr_row_to_y_row_float_c(src, dst_y, width - x);
+}
+
+void bgra_row_to_y_row_float_ssse3(const unsigned char *src, unsigned char *dst, const int width)
+{
+    bgrx_row_to_yuv_row_float<4, false>(src, dst, nullptr, nullptr, width);
+}
+
+void bgra_row_to_yuv_row_float_ssse3(const unsigned char *src, unsigned char *dst_y, unsigned char *dst_u,
+    unsigned char *dst_v, const int width)
+{
+    bgrx_row_to_yuv_row_float<4, true>(src, dst_y, dst_u, dst_v, width);
+}
+
+void bgr_row_to_y_row_float_ssse3(const unsigned char *src, unsigned char *dst, const int width)
+{
+    bgrx_row_to_yuv_row_float<3, false>(src, dst, nullptr, nullptr, width);
+}
+
+void bgr_row_to_yuv_row_float_ssse3(const unsigned char *src, unsigned char *dst_y, unsigned char *dst_u,
+    unsigned char *dst_v, const int width)
+{
+    bgrx_row_to_yuv_row_float<3, true>(src, dst_y, dst_u, dst_v, width);
+}
@@ -0,0 +1,100 @@
+/* Copyright(c) 2018 Steven Hoving
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "to_420.h"
+#include "yuvconvert.h"
+
+#include <cstring>
+#include <vector>
+
+namespace yuvconvert
+{
+
+// the y plane ends at row * width, always behind the source row pair that is being read. The u
+// and v rows of a pair can only be written in place once they end before the first source row of
+// that pair, until then they are kept in scratch and copied to their place at the end.
+static void bgrx_to_420_inplace(pixel_format format, unsigned char *buffer, const int width, const int height,
+    const int src_stride, unsigned char *destination[3], int dst_stride[3], simd_mode mode)
+{
+    const auto chroma_width = (width + 1) >> 1;
+    const auto chroma_height = (height + 1) >> 1;
+    const auto luma_size = static_cast<std::size_t>(width) * height;
+    const auto chroma_size = static_cast<std::size_t>(chroma_width) * chroma_height;
+
+    destination[0] = buffer;
+    destination[1] = buffer + luma_size;
+    destination[2] = buffer + luma_size + chroma_size;
+    dst_stride[0] = width;
+    dst_stride[1] = chroma_width;
+    dst_stride[2] = chroma_width;
+
+    // the number of leading chroma rows of a plane that have to go through scratch.
+    const auto scratch_rows = [&](const unsigned char *plane) {
+        int rows = 0;
+        while (rows < chroma_height &&
+            plane + static_cast<std::size_t>(rows + 1) * chroma_width > buffer + static_cast<std::size_t>(rows) * 2 * src_stride)
+            ++rows;
+        return rows;
+    };
+
+    const auto u_scratch_rows = scratch_rows(destination[1]);
+    const auto v_scratch_rows = scratch_rows(destination[2]);
+    std::vector<unsigned char> scratch(static_cast<std::size_t>(u_scratch_rows + v_scratch_rows) * chroma_width);
+    const auto u_scratch = scratch.data();
+    const auto v_scratch = scratch.data() + static_cast<std::size_t>(u_scratch_rows) * chroma_width;
+
+    // the kernels load a whole block before they store it, and the stores always land behind the
+    // loads, so the unaligned converters are safe to use on overlapping rows.
+    const auto converters = get_row_converters_420(format, mode);
+
+    for (int pair = 0; pair < chroma_height; ++pair)
+    {
+        const auto line = pair * 2;
+        const auto src = buffer + static_cast<std::size_t>(line) * src_stride;
+        const auto y = buffer + static_cast<std::size_t>(line) * width;
+        const auto u = (pair < u_scratch_rows) ? u_scratch + static_cast<std::size_t>(pair) * chroma_width
+                                               : destination[1] + static_cast<std::size_t>(pair) * chroma_width;
+        const auto v = (pair < v_scratch_rows) ? v_scratch + static_cast<std::size_t>(pair) * chroma_width
+                                               : destination[2] + static_cast<std::size_t>(pair) * chroma_width;
+
+        converters.yuv_row(src, y, u, v, width);
+        if (line + 1 < height)
+            converters.y_row(src + src_stride, y + width, width);
+    }
+
+    // all source rows are consumed, so the scratch rows can go to their place.
+    std::memcpy(destination[1], u_scratch, static_cast<std::size_t>(u_scratch_rows) * chroma_width);
+    std::memcpy(destination[2], v_scratch, static_cast<std::size_t>(v_scratch_rows) * chroma_width);
+}
+
+void bgr_to_420_inplace(unsigned char *buffer, const int width, const int height, const int src_stride,
+    unsigned char *destination[3], int dst_stride[3], simd_mode mode)
+{
+    bgrx_to_420_inplace(pixel_format::bgr, buffer, width, height, src_stride, destination, dst_stride, mode);
+}
+
+void bgra_to_420_inplace(unsigned char *buffer, const int width, const int height, const int src_stride,
+    unsigned char *destination[3], int dst_stride[3], simd_mode mode)
+{
+    bgrx_to_420_inplace(pixel_format::bgra, buffer, width, height, src_stride, destination, dst_stride, mode);
+}
+
+} // namespace yuvconvert
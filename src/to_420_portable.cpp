@@ -0,0 +1,140 @@
+/* Copyright(c) 2018 Steven Hoving
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "to_420_portable.h"
+#include "to_420_c.h"
+#include "row_converter.h"
+#include "simd_utility.h"
+
+#if YUVCONVERT_VECTOR_EXTENSIONS
+
+#include "simd_portable.h"
+
+using namespace simd::portable;
+
+// the same 8 bit coefficients as rgb2y, rgb2u and rgb2v, the offsets are folded into the rounding:
+// ((x + 128) >> 8) + 16 is (x + 128 + (16 << 8)) >> 8.
+static inline i32x4 to_y(const u32x4 pixels)
+{
+    return (weighted_sum<25, 129, 66>(pixels) + (128 + (16 << 8))) >> 8;
+}
+
+static inline i32x4 to_u(const u32x4 pixels)
+{
+    return (weighted_sum<112, -74, -38>(pixels) + (128 + (128 << 8))) >> 8;
+}
+
+static inline i32x4 to_v(const u32x4 pixels)
+{
+    return (weighted_sum<-18, -94, 112>(pixels) + (128 + (128 << 8))) >> 8;
+}
+
+static inline u8x16 to_y(const bgrx16 &block)
+{
+    return narrow(to_y(block.pixels[0]), to_y(block.pixels[1]), to_y(block.pixels[2]), to_y(block.pixels[3]));
+}
+
+template <int pixel_width>
+static void convert_y_row(const unsigned char *src, unsigned char *dst, const int width, yuvconvert::bgrx_row_to_y_row *tail)
+{
+    const int block_width = simd::align_down(width, 16);
+
+    __no_unroll
+    for (int x = 0; x < block_width; x += 16)
+    {
+        store(dst + x, to_y(load_16_pixels<pixel_width>(src + x * pixel_width)));
+    }
+
+    tail(src + block_width * pixel_width, dst + block_width, width - block_width);
+}
+
+template <int pixel_width>
+static void convert_yuv_row(const unsigned char *src, unsigned char *dst_y, unsigned char *dst_u,
+    unsigned char *dst_v, const int width, yuvconvert::bgrx_row_to_yuv_row *tail)
+{
+    const int block_width = simd::align_down(width, 16);
+
+    __no_unroll
+    for (int x = 0; x < block_width; x += 16)
+    {
+        const auto block = load_16_pixels<pixel_width>(src + x * pixel_width);
+        store(dst_y + x, to_y(block));
+
+        const auto even_0 = even_pixels(block.pixels[0], block.pixels[1]);
+        const auto even_1 = even_pixels(block.pixels[2], block.pixels[3]);
+        store(dst_u + x / 2, narrow(to_u(even_0), to_u(even_1)));
+        store(dst_v + x / 2, narrow(to_v(even_0), to_v(even_1)));
+    }
+
+    // block_width is even, so the tail starts on a chroma carrying pixel.
+    tail(src + block_width * pixel_width, dst_y + block_width, dst_u + block_width / 2, dst_v + block_width / 2,
+        width - block_width);
+}
+
+void bgra_row_to_y_row_portable(const unsigned char *src, unsigned char *dst, const int width)
+{
+    convert_y_row<4>(src, dst, width, bgra_row_to_y_row_c);
+}
+
+void bgra_row_to_yuv_row_portable(const unsigned char *src, unsigned char *dst_y, unsigned char *dst_u,
+    unsigned char *dst_v, const int width)
+{
+    convert_yuv_row<4>(src, dst_y, dst_u, dst_v, width, bgra_row_to_yuv_row_c);
+}
+
+void bgr_row_to_y_row_portable(const unsigned char *src, unsigned char *dst, const int width)
+{
+    convert_y_row<3>(src, dst, width, bgr_row_to_y_row_c);
+}
+
+void bgr_row_to_yuv_row_portable(const unsigned char *src, unsigned char *dst_y, unsigned char *dst_u,
+    unsigned char *dst_v, const int width)
+{
+    convert_yuv_row<3>(src, dst_y, dst_u, dst_v, width, bgr_row_to_yuv_row_c);
+}
+
+#else
+
+// without vector extensions supported_simd_mode never picks portable, these only keep the dispatch
+// free of preprocessor checks.
+void bgra_row_to_y_row_portable(const unsigned char *src, unsigned char *dst, const int width)
+{
+    bgra_row_to_y_row_c(src, dst, width);
+}
+
+void bgra_row_to_yuv_row_portable(const unsigned char *src, unsigned char *dst_y, unsigned char *dst_u,
+    unsigned char *dst_v, const int width)
+{
+    bgra_row_to_yuv_row_c(src, dst_y, dst_u, dst_v, width);
+}
+
+void bgr_row_to_y_row_portable(const unsigned char *src, unsigned char *dst, const int width)
+{
+    bgr_row_to_y_row_c(src, dst, width);
+}
+
+void bgr_row_to_yuv_row_portable(const unsigned char *src, unsigned char *dst_y, unsigned char *dst_u,
+    unsigned char *dst_v, const int width)
+{
+    bgr_row_to_yuv_row_c(src, dst_y, dst_u, dst_v, width);
+}
+
+#endif
@@ -24,6 +24,7 @@
 
 #include "simd_vec.h"
 #include "simd_common.h"
+#include "simd_bgrx.h"
 #include "simd_debug.h"
 
 #include <xmmintrin.h>
@@ -32,204 +33,57 @@
 #include <tmmintrin.h>
 #include <cstdio>
 
-namespace simd
-{
-namespace bgra
-{
-
-// \note rename shuffle to unpack
-static const auto shuffle_lo_odd = vec3_set_shuffle_lo(12, 8, 4, 0);
-static const auto shuffle_hi_odd = vec3_set_shuffle_hi(12, 8, 4, 0);
-
-static const auto y_shuffle = vec2_set_pack(15, 13, 11, 9, 7, 5, 3, 1);
-
-static const auto uv_shuffle0 = _mm_set_epi8(
-    mask, mask, mask, mask,
-    mask, mask, mask, mask,
-    mask, mask, mask, mask,
-    12, 8, 4, 0
-);
-
-static const auto uv_shuffle1 = _mm_set_epi8(
-    mask, mask, mask, mask,
-    mask, mask, mask, mask,
-    12, 8, 4, 0,
-    mask, mask, mask, mask
-);
-
-static const auto uv_shuffle2 = _mm_set_epi8(
-    mask, mask, mask, mask,
-    12, 8, 4, 0,
-    mask, mask, mask, mask,
-    mask, mask, mask, mask
-);
-
-static const vec2 vec2_uv_shuffle = { uv_shuffle0, uv_shuffle1 };
-} // namespace bgra
-
-namespace bgr
-{
-static const auto shuffle_lo_odd = vec3_set_shuffle_lo(9, 6, 3, 0);
-static const auto shuffle_hi_odd = vec3_set_shuffle_hi(9, 6, 3, 0);
-
-static const auto y_shuffle0 = _mm_set_epi8(mask,
-    mask, mask, mask, mask, mask,
-    mask, mask, mask, mask, mask,
-    9, 7, 5, 3, 1);
-
-static const auto y_shuffle1 = _mm_set_epi8(mask,
-    mask, mask, mask, mask, mask,
-    9, 7, 5, 3, 1,
-    mask, mask, mask, mask, mask);
-
-static const auto y_shuffle2 = _mm_set_epi8(mask,
-    9, 7, 5, 3, 1,
-    mask, mask, mask, mask, mask,
-    mask, mask, mask, mask, mask);
-
-static const auto y_shuffle0_lo_odd = _mm_set_epi8(
-    mask, mask, mask, mask, mask, mask, mask, mask,
-    15, 13, 11, 9, 7, 5, 3, 1);
-
-static const auto y_shuffle1_lo_odd = _mm_set_epi8(
-    15, 13, 11, 9, 7, 5, 3, 1,
-    mask, mask, mask, mask, mask, mask, mask, mask
-);
-
-static const auto y_shuffle2_lo_odd = _mm_set_epi8(
-    mask, mask, mask, mask, mask, mask, mask, mask,
-    15, 13, 11, 9, 7, 5, 3, 1);
-
-static const vec2 vec2_y_shuffle_lo_odd = { y_shuffle0_lo_odd, y_shuffle1_lo_odd };
-
-static const auto y_shuffle0_hi_odd = _mm_set_epi8(
-    mask, mask, mask, mask,
-    mask, mask, mask, mask,
-    mask, mask, mask, mask,
-    15, 12, 11, 9);
-
-static const auto y_shuffle1_hi_odd = _mm_set_epi8(
-    mask, mask, mask, mask,
-    mask, mask, mask, mask,
-    15, 12, 11, 9,
-    mask, mask, mask, mask);
-
-static const auto y_shuffle2_hi_odd = _mm_set_epi8(
-    mask, mask, mask, mask,
-    15, 12, 11, 9,
-    mask, mask, mask, mask,
-    mask, mask, mask, mask);
-
-static const auto uv_shuffle0 = _mm_set_epi8(
-    mask, mask, mask, mask,
-    mask, mask, mask, mask,
-    mask, mask, mask, mask,
-    12, 8, 4, 0
-);
-
-static const auto uv_shuffle1 = _mm_set_epi8(
-    mask, mask, mask, mask,
-    mask, mask, mask, mask,
-    12, 8, 4, 0,
-    mask, mask, mask, mask
-);
-
-static const auto uv_shuffle2 = _mm_set_epi8(
-    mask, mask, mask, mask,
-    12, 8, 4, 0,
-    mask, mask, mask, mask,
-    mask, mask, mask, mask
-);
-
-static const vec2 vec2_uv_shuffle = { uv_shuffle0, uv_shuffle1 };
-
-static const auto uv_shuffle_interleave0 = _mm_set_epi8(
-    mask, mask, mask, mask, mask, mask, mask, mask,
-    mask, mask, mask, mask, mask, 4, mask, 0);
-
-static const auto uv_shuffle_interleave1 = _mm_set_epi8(
-    mask, mask, mask, mask, mask, mask, mask, mask,
-    mask, 4, mask, 0, mask, mask, mask, mask);
-
-static const auto uv_shuffle_interleave2 = _mm_set_epi8(
-    mask, 12, mask, 8, mask, 4, mask, 0,
-    mask, mask, mask, mask, mask, mask, mask, mask);
-
-} // namespace bgr
-} // namespace simd
-
 using namespace simd;
 
-
-
-
 // this function processes 16 pixels (64 bytes) at the same time.
+template<bool aligned, bool premultiplied = false>
 __forceinline void brga_block_to_yuv_ssse3(const unsigned char *src, unsigned char *dst_y,
     unsigned char *dst_u, unsigned char *dst_v)
 {
-    const auto pxl0 = _mm_lddqu_si128((__m128i *)(src +  0)); // load 4 pixels
-    const auto pxl1 = _mm_lddqu_si128((__m128i *)(src + 16)); // load 4 pixels
-    const auto pxl2 = _mm_lddqu_si128((__m128i *)(src + 32)); // load 4 pixels
-    const auto pxl3 = _mm_lddqu_si128((__m128i *)(src + 48)); // load 4 pixels
-
-    // unpack so we end up with 4x 4 pixels
-    auto vec_data0 = vec3_unpack(pxl0, bgra::shuffle_lo_odd);
-    auto vec_data1 = vec3_unpack(pxl1, bgra::shuffle_hi_odd);
-    auto vec_data2 = vec3_unpack(pxl2, bgra::shuffle_lo_odd);
-    auto vec_data3 = vec3_unpack(pxl3, bgra::shuffle_hi_odd);
-
-    // interleave so we end up with 2x 8 pixels
-    auto vec_part0 = vec3_or(vec_data0, vec_data1);
-    auto vec_part1 = vec3_or(vec_data2, vec_data3);
-
-    // multiply the 2x 8 pixels
-    auto vec_y_part0 = vec3_mullo(vec_part0, y_mul);
-    auto vec_y_part1 = vec3_mullo(vec_part1, y_mul);
-
-    // vertical sum the vec3 so we end up with 1 object that contains 2x 8 pixels.
-    auto vec_y_part = vec3_vsum_vec2(vec_y_part0, vec_y_part1);
-
-    vec_y_part = vec2_add(vec_y_part, uv_add);
-
-    auto vec_result = vec2_shuffle(vec_y_part, bgra::y_shuffle);
-
-    auto y_result0 = _mm_or_si128(vec_result.b, vec_result.g);
-
-    y_result0 = _mm_add_epi8(y_result0, y_add);
+    vec3 vec_part0;
+    vec3 vec_part1;
+    bgra_block_unpack<aligned, premultiplied>(src, vec_part0, vec_part1);
 
     // store 16 y pixels
-    _mm_store_si128((__m128i *)dst_y, y_result0);
-
-    // calculate uv
-    auto u_vec_part0 = vec3_mullo(vec_part0, u_mul); // contains 4 pixels (we skip every odd pixel)
-    auto u_vec_part1 = vec3_mullo(vec_part1, u_mul); // contains 4 pixels
-
-    auto v_vec_part0 = vec3_mullo(vec_part0, v_mul); // contains 4 pixels
-    auto v_vec_part1 = vec3_mullo(vec_part1, v_mul); // contains 4 pixels
+    block_store<aligned>(dst_y, block_to_y(vec_part0, vec_part1));
 
-    auto u_part0 = vec3_vsum_vec2(u_vec_part0, u_vec_part1);
-    auto v_part0 = vec3_vsum_vec2(v_vec_part0, v_vec_part1);
+    // calculate uv, we only keep every even pixel
+    const auto u_0 = chroma_pack_even(block_to_chroma(vec_part0, vec_part1, u_mul));
+    const auto v_0 = chroma_pack_even(block_to_chroma(vec_part0, vec_part1, v_mul));
 
-    u_part0 = vec2_add(u_part0, uv_add);
-    v_part0 = vec2_add(v_part0, uv_add);
-
-    u_part0 = vec2_srai(u_part0, 8);
-    v_part0 = vec2_srai(v_part0, 8);
-
-    u_part0 = vec2_add(u_part0, uv_add);
-    v_part0 = vec2_add(v_part0, uv_add);
+    _mm_storel_epi64((__m128i *)dst_u, u_0);
+    _mm_storel_epi64((__m128i *)dst_v, v_0);
+}
 
-    u_part0 = vec2_shuffle(u_part0, bgra::vec2_uv_shuffle);
-    v_part0 = vec2_shuffle(v_part0, bgra::vec2_uv_shuffle);
+// this function processes 16 pixels (64 bytes) at the same time.
+template<bool aligned, bool premultiplied = false>
+__forceinline void brga_block_to_y_ssse3(const unsigned char *src, unsigned char *dst_y)
+{
+    vec3 vec_part0;
+    vec3 vec_part1;
+    bgra_block_unpack<aligned, premultiplied>(src, vec_part0, vec_part1);
 
-    auto u_0 = vec2_pack_interleave(u_part0);
-    auto v_0 = vec2_pack_interleave(v_part0);
+    // store 16 y pixels
+    block_store<aligned>(dst_y, block_to_y(vec_part0, vec_part1));
+}
 
-    _mm_storel_epi64((__m128i *)dst_u, u_0);
-    _mm_storel_epi64((__m128i *)dst_v, v_0);
+// read the color of a bgra pixel for the scalar tails.
+template<bool premultiplied>
+static __forceinline void bgra_pixel(const unsigned char *src, uint8_t &r, uint8_t &g, uint8_t &b)
+{
+    r = src[2];
+    g = src[1];
+    b = src[0];
+    if constexpr (premultiplied)
+    {
+        r = unpremultiply(r, src[3]);
+        g = unpremultiply(g, src[3]);
+        b = unpremultiply(b, src[3]);
+    }
 }
 
-void bgra_row_to_y_row_ssse3(const unsigned char *src, unsigned char *dst, const int width)
+template<bool aligned, bool premultiplied = false>
+static void bgra_row_to_y_row(const unsigned char *src, unsigned char *dst, const int width)
 {
     const int sse_aligned_width = simd::align_down(width, 16);
 
@@ -238,54 +92,23 @@ void bgra_row_to_y_row_ssse3(const unsigned char *src, unsigned char *dst, const
     __no_unroll
     for (; x < sse_aligned_width; x += 16)
     {
-        const auto pxl0 = _mm_lddqu_si128((__m128i *)(src +  0)); // load 4 pixels
-        const auto pxl1 = _mm_lddqu_si128((__m128i *)(src + 16)); // load 4 pixels
-        const auto pxl2 = _mm_lddqu_si128((__m128i *)(src + 32)); // load 4 pixels
-        const auto pxl3 = _mm_lddqu_si128((__m128i *)(src + 48)); // load 4 pixels
-        src += 64;
-
-        // unpack so we end up with 4x 4 pixels
-        auto vec_data0 = vec3_unpack(pxl0, bgra::shuffle_lo_odd);
-        auto vec_data1 = vec3_unpack(pxl1, bgra::shuffle_hi_odd);
-        auto vec_data2 = vec3_unpack(pxl2, bgra::shuffle_lo_odd);
-        auto vec_data3 = vec3_unpack(pxl3, bgra::shuffle_hi_odd);
-
-        // interleave so we end up with 2x 8 pixels
-        auto vec_part0 = vec3_or(vec_data0, vec_data1);
-        auto vec_part1 = vec3_or(vec_data2, vec_data3);
-
-        // multiply the 2x 8 pixels
-        auto vec_y_part0 = vec3_mullo(vec_part0, y_mul);
-        auto vec_y_part1 = vec3_mullo(vec_part1, y_mul);
-
-        // vertical sum the vec3 so we end up with 1 object that contains 2x 8 pixels.
-        auto vec_y_part = vec3_vsum_vec2(vec_y_part0, vec_y_part1);
-        vec_y_part.b = _mm_add_epi16(vec_y_part.b, uv_add);// abuse uv_add to + 128
-        vec_y_part.g = _mm_add_epi16(vec_y_part.g, uv_add);
-
-        auto vec_result = vec2_shuffle(vec_y_part, bgra::y_shuffle);
-
-        auto y_result0 = _mm_or_si128(vec_result.b, vec_result.g);
-
-        y_result0 = _mm_add_epi8(y_result0, y_add);
-
-        // store 16 y pixels
-        _mm_store_si128((__m128i *)dst, y_result0);
+        brga_block_to_y_ssse3<aligned, premultiplied>(src, dst);
+        src += 64; // we process 64 bytes (16 pixels) per block
         dst += 16;
     }
 
     __no_unroll
     for (; x < width; ++x)
     {
-        *dst++ = rgb2y(
-            src[2], // r
-            src[1], // g
-            src[0]);// b
+        uint8_t r, g, b;
+        bgra_pixel<premultiplied>(src, r, g, b);
+        *dst++ = rgb2y(r, g, b);
         src += 4;//pixel_width;
     }
 }
 
-void bgra_row_to_yuv_row_ssse3(const unsigned char *src, unsigned char *dst_y,
+template<bool aligned, bool premultiplied = false>
+static void bgra_row_to_yuv_row(const unsigned char *src, unsigned char *dst_y,
     unsigned char *dst_u, unsigned char *dst_v, const int width)
 {
     const int aligned_width = simd::align_down(width, 16);
@@ -294,7 +117,7 @@ void bgra_row_to_yuv_row_ssse3(const unsigned char *src, unsigned char *dst_y,
     __no_unroll
     for (x = 0; x < aligned_width; x += 16) // we are processing 32 pixels per iteration
     {
-        brga_block_to_yuv_ssse3(src, dst_y, dst_u, dst_v);
+        brga_block_to_yuv_ssse3<aligned, premultiplied>(src, dst_y, dst_u, dst_v);
         src += 64; // we process 64 bytes (16 pixels) per block
         dst_y += 16;
         dst_u += 8;
@@ -304,17 +127,18 @@ void bgra_row_to_yuv_row_ssse3(const unsigned char *src, unsigned char *dst_y,
     __no_unroll
     for (; x < width; x += 2)
     {
-        auto r = src[2];
-        auto g = src[1];
-        auto b = src[0];
+        uint8_t r, g, b;
+        bgra_pixel<premultiplied>(src, r, g, b);
         *dst_y++ = rgb2y(r, g, b);
         *dst_u++ = rgb2u(r, g, b);
         *dst_v++ = rgb2v(r, g, b);
         src += 4;//pixel_width;
 
-        r = src[2];
-        g = src[1];
-        b = src[0];
+        // an odd width ends with a single chroma carrying pixel.
+        if (x + 1 == width)
+            break;
+
+        bgra_pixel<premultiplied>(src, r, g, b);
         *dst_y++ = rgb2y(r, g, b);
         src += 4;//pixel_width;
     }
@@ -501,109 +325,40 @@ void bgr2yuv420p_sse(uint8_t *destination[8], const int dst_stride[3], const uin
 #endif
 
 // this function processes 16 pixels (48 bytes) at the same time.
+// the 48 byte blocks are never all aligned, so only the luma store uses the row alignment.
+template<bool aligned>
 __forceinline void brg_block_to_yuv_ssse3(const unsigned char *src, unsigned char *dst_y,
     unsigned char *dst_u, unsigned char *dst_v)
 {
-    const auto pxl0 = _mm_lddqu_si128((__m128i *)(src + 0)); // load 4 pixels
-    const auto pxl1 = _mm_lddqu_si128((__m128i *)(src + 16)); // load 4 pixels
-    const auto pxl2 = _mm_lddqu_si128((__m128i *)(src + 32)); // load 4 pixels
-    const auto pxl3 = _mm_lddqu_si128((__m128i *)(src + 48)); // load 4 pixels
-
-    // unpack so we end up with 4x 4 pixels
-    auto vec_data0 = vec3_unpack(pxl0, bgr::shuffle_lo_odd);
-    auto vec_data1 = vec3_unpack(pxl1, bgr::shuffle_hi_odd);
-    auto vec_data2 = vec3_unpack(pxl2, bgr::shuffle_lo_odd);
-    auto vec_data3 = vec3_unpack(pxl3, bgr::shuffle_hi_odd);
-
-    // interleave so we end up with 2x 8 pixels
-    auto vec_part0 = vec3_or(vec_data0, vec_data1);
-    auto vec_part1 = vec3_or(vec_data2, vec_data3);
-
-    // multiply the 2x 8 pixels
-    auto vec_y_part0 = vec3_mullo(vec_part0, y_mul);
-    auto vec_y_part1 = vec3_mullo(vec_part1, y_mul);
-
-    // vertical sum the vec3 so we end up with 1 object that contains 2x 8 pixels.
-    auto vec_y_part = vec3_vsum_vec2(vec_y_part0, vec_y_part1);
-
-    vec_y_part = vec2_add(vec_y_part, uv_add);
-
-    auto vec_result = vec2_shuffle(vec_y_part, bgr::vec2_y_shuffle_lo_odd);
-
-    auto y_result0 = _mm_or_si128(vec_result.b, vec_result.g);
-
-    y_result0 = _mm_add_epi8(y_result0, y_add);
+    vec3 vec_part0;
+    vec3 vec_part1;
+    bgr_block_unpack(src, vec_part0, vec_part1);
 
     // store 16 y pixels
-    _mm_store_si128((__m128i *)dst_y, y_result0);
-
-    // calculate uv
-    auto u_vec_part0 = vec3_mullo(vec_part0, u_mul); // contains 4 pixels (we skip every odd pixel)
-    auto u_vec_part1 = vec3_mullo(vec_part1, u_mul); // contains 4 pixels
-
-    auto v_vec_part0 = vec3_mullo(vec_part0, v_mul); // contains 4 pixels
-    auto v_vec_part1 = vec3_mullo(vec_part1, v_mul); // contains 4 pixels
-
-    auto u_part0 = vec3_vsum_vec2(u_vec_part0, u_vec_part1);
-    auto v_part0 = vec3_vsum_vec2(v_vec_part0, v_vec_part1);
-
-    u_part0 = vec2_add(u_part0, uv_add);
-    v_part0 = vec2_add(v_part0, uv_add);
-
-    u_part0 = vec2_srai(u_part0, 8);
-    v_part0 = vec2_srai(v_part0, 8);
-
-    u_part0 = vec2_add(u_part0, uv_add);
-    v_part0 = vec2_add(v_part0, uv_add);
+    block_store<aligned>(dst_y, block_to_y(vec_part0, vec_part1));
 
-    u_part0 = vec2_shuffle(u_part0, bgr::vec2_uv_shuffle);
-    v_part0 = vec2_shuffle(v_part0, bgr::vec2_uv_shuffle);
-
-    auto u_0 = vec2_pack_interleave(u_part0);
-    auto v_0 = vec2_pack_interleave(v_part0);
+    // calculate uv, we only keep every even pixel
+    const auto u_0 = chroma_pack_even(block_to_chroma(vec_part0, vec_part1, u_mul));
+    const auto v_0 = chroma_pack_even(block_to_chroma(vec_part0, vec_part1, v_mul));
 
     _mm_storel_epi64((__m128i *)dst_u, u_0);
     _mm_storel_epi64((__m128i *)dst_v, v_0);
 }
 
 // this function processes 16 pixels (48 bytes) at the same time.
+template<bool aligned>
 __forceinline void brg_block_to_y_ssse3(const unsigned char *src, unsigned char *dst_y)
 {
-    const auto pxl0 = _mm_lddqu_si128((__m128i *)(src + 0)); // load 4 pixels
-    const auto pxl1 = _mm_lddqu_si128((__m128i *)(src + 16)); // load 4 pixels
-    const auto pxl2 = _mm_lddqu_si128((__m128i *)(src + 32)); // load 4 pixels
-    const auto pxl3 = _mm_lddqu_si128((__m128i *)(src + 48)); // load 4 pixels
-
-    // unpack so we end up with 4x 4 pixels
-    auto vec_data0 = vec3_unpack(pxl0, bgr::shuffle_lo_odd);
-    auto vec_data1 = vec3_unpack(pxl1, bgr::shuffle_hi_odd);
-    auto vec_data2 = vec3_unpack(pxl2, bgr::shuffle_lo_odd);
-    auto vec_data3 = vec3_unpack(pxl3, bgr::shuffle_hi_odd);
-
-    // interleave so we end up with 2x 8 pixels
-    auto vec_part0 = vec3_or(vec_data0, vec_data1);
-    auto vec_part1 = vec3_or(vec_data2, vec_data3);
-
-    // multiply the 2x 8 pixels
-    auto vec_y_part0 = vec3_mullo(vec_part0, y_mul);
-    auto vec_y_part1 = vec3_mullo(vec_part1, y_mul);
-
-    // vertical sum the vec3 so we end up with 1 object that contains 2x 8 pixels.
-    auto vec_y_part = vec3_vsum_vec2(vec_y_part0, vec_y_part1);
-
-    vec_y_part = vec2_add(vec_y_part, uv_add);
-
-    auto vec_result = vec2_shuffle(vec_y_part, bgr::vec2_y_shuffle_lo_odd);
-
-    auto y_result0 = _mm_or_si128(vec_result.b, vec_result.g);
-
-    y_result0 = _mm_add_epi8(y_result0, y_add);
+    vec3 vec_part0;
+    vec3 vec_part1;
+    bgr_block_unpack(src, vec_part0, vec_part1);
 
     // store 16 y pixels
-    _mm_store_si128((__m128i *)dst_y, y_result0);
+    block_store<aligned>(dst_y, block_to_y(vec_part0, vec_part1));
 }
 
-void bgr_row_to_yuv_row_ssse3(const unsigned char *src, unsigned char *dst_y, unsigned char *dst_u,
+template<bool aligned>
+static void bgr_row_to_yuv_row(const unsigned char *src, unsigned char *dst_y, unsigned char *dst_u,
     unsigned char *dst_v, const int width)
 {
     const int aligned_width = simd::align_down(width, 16);
@@ -612,7 +367,7 @@ void bgr_row_to_yuv_row_ssse3(const unsigned char *src, unsigned char *dst_y, un
     __no_unroll
     for (x = 0; x < aligned_width; x += 16) // we are processing 32 pixels per iteration
     {
-        brg_block_to_yuv_ssse3(src, dst_y, dst_u, dst_v);
+        brg_block_to_yuv_ssse3<aligned>(src, dst_y, dst_u, dst_v);
         src += 48; // we process 48 bytes (16 pixels) per block
         dst_y += 16;
         dst_u += 8;
@@ -630,6 +385,10 @@ void bgr_row_to_yuv_row_ssse3(const unsigned char *src, unsigned char *dst_y, un
         *dst_v++ = rgb2v(r, g, b);
         src += 3;//pixel_width;
 
+        // an odd width ends with a single chroma carrying pixel.
+        if (x + 1 == width)
+            break;
+
         r = src[2];
         g = src[1];
         b = src[0];
@@ -638,7 +397,8 @@ void bgr_row_to_yuv_row_ssse3(const unsigned char *src, unsigned char *dst_y, un
     }
 }
 
-void bgr_row_to_y_row_ssse3(const unsigned char *src, unsigned char *dst_y, const int width)
+template<bool aligned>
+static void bgr_row_to_y_row(const unsigned char *src, unsigned char *dst_y, const int width)
 {
     const int aligned_width = simd::align_down(width, 16);
 
@@ -646,7 +406,7 @@ void bgr_row_to_y_row_ssse3(const unsigned char *src, unsigned char *dst_y, cons
     __no_unroll
     for (x = 0; x < aligned_width; x += 16) // we are processing 32 pixels per iteration
     {
-        brg_block_to_y_ssse3(src, dst_y);
+        brg_block_to_y_ssse3<aligned>(src, dst_y);
         src += 48; // we process 48 bytes (16 pixels) per block
         dst_y += 16;
     }
@@ -661,3 +421,58 @@ void bgr_row_to_y_row_ssse3(const unsigned char *src, unsigned char *dst_y, cons
         src += 3;//pixel_width;
     }
 }
+
+void bgra_row_to_y_row_ssse3(const unsigned char *src, unsigned char *dst, const int width)
+{
+    bgra_row_to_y_row<false>(src, dst, width);
+}
+
+void bgra_row_to_yuv_row_ssse3(const unsigned char *src, unsigned char *dst_y, unsigned char *dst_u,
+    unsigned char *dst_v, const int width)
+{
+    bgra_row_to_yuv_row<false>(src, dst_y, dst_u, dst_v, width);
+}
+
+void bgr_row_to_y_row_ssse3(const unsigned char *src, unsigned char *dst, const int width)
+{
+    bgr_row_to_y_row<false>(src, dst, width);
+}
+
+void bgr_row_to_yuv_row_ssse3(const unsigned char *src, unsigned char *dst_y, unsigned char *dst_u,
+    unsigned char *dst_v, const int width)
+{
+    bgr_row_to_yuv_row<false>(src, dst_y, dst_u, dst_v, width);
+}
+
+void bgra_row_to_y_row_ssse3_aligned(const unsigned char *src, unsigned char *dst, const int width)
+{
+    bgra_row_to_y_row<true>(src, dst, width);
+}
+
+void bgra_row_to_yuv_row_ssse3_aligned(const unsigned char *src, unsigned char *dst_y,
+    unsigned char *dst_u, unsigned char *dst_v, const int width)
+{
+    bgra_row_to_yuv_row<true>(src, dst_y, dst_u, dst_v, width);
+}
+
+void bgr_row_to_y_row_ssse3_aligned(const unsigned char *src, unsigned char *dst, const int width)
+{
+    bgr_row_to_y_row<true>(src, dst, width);
+}
+
+void bgr_row_to_yuv_row_ssse3_aligned(const unsigned char *src, unsigned char *dst_y,
+    unsigned char *dst_u, unsigned char *dst_v, const int width)
+{
+    bgr_row_to_yuv_row<true>(src, dst_y, dst_u, dst_v, width);
+}
+
+void bgra_premultiplied_row_to_y_row_ssse3(const unsigned char *src, unsigned char *dst, const int width)
+{
+    bgra_row_to_y_row<false, true>(src, dst, width);
+}
+
+void bgra_premultiplied_row_to_yuv_row_ssse3(const unsigned char *src, unsigned char *dst_y,
+    unsigned char *dst_u, unsigned char *dst_v, const int width)
+{
+    bgra_row_to_yuv_row<false, true>(src, dst_y, dst_u, dst_v, width);
+}
@@ -27,3 +27,17 @@ void bgra_row_to_yuv_row_ssse3(const unsigned char *src, unsigned char *dst_y, u
 void bgr_row_to_y_row_ssse3(const unsigned char *src, unsigned char *dst, const int width);
 void bgr_row_to_yuv_row_ssse3(const unsigned char *src, unsigned char *dst_y, unsigned char *dst_u,
     unsigned char *dst_v, const int width);
+
+// the same converters for rows that start on a 16 byte boundary in both the source and the luma
+// plane, as handed out by the frame pool.
+void bgra_row_to_y_row_ssse3_aligned(const unsigned char *src, unsigned char *dst, const int width);
+void bgra_row_to_yuv_row_ssse3_aligned(const unsigned char *src, unsigned char *dst_y,
+    unsigned char *dst_u, unsigned char *dst_v, const int width);
+void bgr_row_to_y_row_ssse3_aligned(const unsigned char *src, unsigned char *dst, const int width);
+void bgr_row_to_yuv_row_ssse3_aligned(const unsigned char *src, unsigned char *dst_y,
+    unsigned char *dst_u, unsigned char *dst_v, const int width);
+
+// premultiplied bgra, the color is divided by alpha while the pixels are unpacked.
+void bgra_premultiplied_row_to_y_row_ssse3(const unsigned char *src, unsigned char *dst, const int width);
+void bgra_premultiplied_row_to_yuv_row_ssse3(const unsigned char *src, unsigned char *dst_y,
+    unsigned char *dst_u, unsigned char *dst_v, const int width);
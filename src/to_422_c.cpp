@@ -0,0 +1,81 @@
+/* Copyright(c) 2018 Steven Hoving
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "to_422_c.h"
+#include "yuvconvert_common.h"
+
+// c implementation for converting a rgbx row to a packed 4:2:2 row. The chroma of a macro pixel
+// is taken from its first pixel, the same as the planar converters do.
+template<int pixel_width, int y_offset, int u_offset, int v_offset>
+constexpr void bgrx_row_to_packed_row(const unsigned char *src, unsigned char *dst, const int width)
+{
+    const int even_width = width & ~1;
+
+    int x = 0;
+    for (; x < even_width; x += 2)
+    {
+        auto r = src[2];
+        auto g = src[1];
+        auto b = src[0];
+        dst[y_offset] = rgb2y(r, g, b);
+        dst[u_offset] = rgb2u(r, g, b);
+        dst[v_offset] = rgb2v(r, g, b);
+        src += pixel_width;
+
+        r = src[2];
+        g = src[1];
+        b = src[0];
+        dst[y_offset + 2] = rgb2y(r, g, b);
+        src += pixel_width;
+        dst += 4;
+    }
+
+    // odd width, the last macro pixel repeats its only luma sample.
+    if (x < width)
+    {
+        const auto r = src[2];
+        const auto g = src[1];
+        const auto b = src[0];
+        dst[y_offset] = dst[y_offset + 2] = rgb2y(r, g, b);
+        dst[u_offset] = rgb2u(r, g, b);
+        dst[v_offset] = rgb2v(r, g, b);
+    }
+}
+
+void bgra_row_to_yuy2_row_c(const unsigned char *src, unsigned char *dst, const int width)
+{
+    bgrx_row_to_packed_row<4, 0, 1, 3>(src, dst, width);
+}
+
+void bgra_row_to_uyvy_row_c(const unsigned char *src, unsigned char *dst, const int width)
+{
+    bgrx_row_to_packed_row<4, 1, 0, 2>(src, dst, width);
+}
+
+void bgr_row_to_yuy2_row_c(const unsigned char *src, unsigned char *dst, const int width)
+{
+    bgrx_row_to_packed_row<3, 0, 1, 3>(src, dst, width);
+}
+
+void bgr_row_to_uyvy_row_c(const unsigned char *src, unsigned char *dst, const int width)
+{
+    bgrx_row_to_packed_row<3, 1, 0, 2>(src, dst, width);
+}
@@ -0,0 +1,102 @@
+/* Copyright(c) 2018 Steven Hoving
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "to_422_ssse3.h"
+#include "to_422_c.h"
+#include "yuvconvert_common.h"
+
+#include "simd_vec.h"
+#include "simd_common.h"
+#include "simd_bgrx.h"
+#include "simd_utility.h"
+
+#include <emmintrin.h>
+#include <tmmintrin.h>
+
+using namespace simd;
+
+// this function processes 16 pixels (64 or 48 bytes) at the same time and stores 8 macro pixels
+// (32 bytes).
+template<int pixel_width, bool uyvy>
+__forceinline void bgrx_block_to_packed_ssse3(const unsigned char *src, unsigned char *dst)
+{
+    vec3 vec_part0;
+    vec3 vec_part1;
+    bgrx_block_unpack<pixel_width>(src, vec_part0, vec_part1);
+
+    const auto y = block_to_y(vec_part0, vec_part1);
+    const auto u = chroma_pack_even(block_to_chroma(vec_part0, vec_part1, u_mul));
+    const auto v = chroma_pack_even(block_to_chroma(vec_part0, vec_part1, v_mul));
+
+    // u0 v0 u1 v1 ... u7 v7
+    const auto uv = _mm_unpacklo_epi8(u, v);
+
+    if constexpr (uyvy)
+    {
+        _mm_storeu_si128((__m128i *)(dst +  0), _mm_unpacklo_epi8(uv, y));
+        _mm_storeu_si128((__m128i *)(dst + 16), _mm_unpackhi_epi8(uv, y));
+    }
+    else
+    {
+        _mm_storeu_si128((__m128i *)(dst +  0), _mm_unpacklo_epi8(y, uv));
+        _mm_storeu_si128((__m128i *)(dst + 16), _mm_unpackhi_epi8(y, uv));
+    }
+}
+
+template<int pixel_width, bool uyvy>
+__forceinline int bgrx_row_to_packed_row_ssse3(const unsigned char *src, unsigned char *dst, const int width)
+{
+    const int aligned_width = simd::align_down(width, 16);
+
+    int x = 0;
+    __no_unroll
+    for (; x < aligned_width; x += 16)
+    {
+        bgrx_block_to_packed_ssse3<pixel_width, uyvy>(src, dst);
+        src += 16 * pixel_width;
+        dst += 32; // 8 macro pixels
+    }
+    return x;
+}
+
+void bgra_row_to_yuy2_row_ssse3(const unsigned char *src, unsigned char *dst, const int width)
+{
+    const auto x = bgrx_row_to_packed_row_ssse3<4, false>(src, dst, width);
+    bgra_row_to_yuy2_row_c(src + x * 4, dst + x * 2, width - x);
+}
+
+void bgra_row_to_uyvy_row_ssse3(const unsigned char *src, unsigned char *dst, const int width)
+{
+    const auto x = bgrx_row_to_packed_row_ssse3<4, true>(src, dst, width);
+    bgra_row_to_uyvy_row_c(src + x * 4, dst + x * 2, width - x);
+}
+
+void bgr_row_to_yuy2_row_ssse3(const unsigned char *src, unsigned char *dst, const int width)
+{
+    const auto x = bgrx_row_to_packed_row_ssse3<3, false>(src, dst, width);
+    bgr_row_to_yuy2_row_c(src + x * 3, dst + x * 2, width - x);
+}
+
+void bgr_row_to_uyvy_row_ssse3(const unsigned char *src, unsigned char *dst, const int width)
+{
+    const auto x = bgrx_row_to_packed_row_ssse3<3, true>(src, dst, width);
+    bgr_row_to_uyvy_row_c(src + x * 3, dst + x * 2, width - x);
+}
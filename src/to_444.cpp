@@ -0,0 +1,69 @@
+/* Copyright(c) 2018 Steven Hoving
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "to_444_c.h"
+#include "to_444_ssse3.h"
+#include "row_converter.h"
+#include "cpu_features.h"
+#include "yuvconvert.h"
+
+namespace yuvconvert
+{
+
+static void bgrx_to_444(unsigned char *destination[3], const int dst_stride[3],
+    const unsigned char *const source[3], const int width, const int height, const int src_stride[3],
+    bgrx_row_to_yuv_row *yuv_row_converter)
+{
+    auto src = source[0];
+    auto y = destination[0];
+    auto u = destination[1];
+    auto v = destination[2];
+
+    const auto raw_stride = src_stride[0];
+    const auto y_stride = dst_stride[0];
+    const auto u_stride = dst_stride[1];
+    const auto v_stride = dst_stride[2];
+
+    for (int line = 0; line < height; ++line)
+    {
+        yuv_row_converter(src, y, u, v, width);
+        src += raw_stride;
+        y += y_stride;
+        u += u_stride;
+        v += v_stride;
+    }
+}
+
+void bgr_to_444(unsigned char *destination[3], const int dst_stride[3], const unsigned char *const source[3],
+    const int width, const int height, const int src_stride[3], simd_mode mode)
+{
+    auto yuv_row_converter = select_x86_kernel(mode, bgr_row_to_yuv444_row_ssse3, bgr_row_to_yuv444_row_c);
+    bgrx_to_444(destination, dst_stride, source, width, height, src_stride, yuv_row_converter);
+}
+
+void bgra_to_444(unsigned char *destination[3], const int dst_stride[3], const unsigned char *const source[3],
+    const int width, const int height, const int src_stride[3], simd_mode mode)
+{
+    auto yuv_row_converter = select_x86_kernel(mode, bgra_row_to_yuv444_row_ssse3, bgra_row_to_yuv444_row_c);
+    bgrx_to_444(destination, dst_stride, source, width, height, src_stride, yuv_row_converter);
+}
+
+} // namespace yuvconvert
@@ -0,0 +1,87 @@
+/* Copyright(c) 2018 Steven Hoving
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "to_444_ssse3.h"
+#include "to_444_c.h"
+#include "yuvconvert_common.h"
+
+#include "simd_vec.h"
+#include "simd_common.h"
+#include "simd_bgrx.h"
+#include "simd_utility.h"
+
+#include <emmintrin.h>
+#include <tmmintrin.h>
+
+using namespace simd;
+
+// this function processes 16 pixels (64 or 48 bytes) at the same time.
+template<int pixel_width>
+__forceinline void bgrx_block_to_yuv444_ssse3(const unsigned char *src, unsigned char *dst_y,
+    unsigned char *dst_u, unsigned char *dst_v)
+{
+    vec3 vec_part0;
+    vec3 vec_part1;
+    bgrx_block_unpack<pixel_width>(src, vec_part0, vec_part1);
+
+    // store 16 y, u and v pixels
+    _mm_storeu_si128((__m128i *)dst_y, block_to_y(vec_part0, vec_part1));
+    _mm_storeu_si128((__m128i *)dst_u, chroma_pack(block_to_chroma(vec_part0, vec_part1, u_mul)));
+    _mm_storeu_si128((__m128i *)dst_v, chroma_pack(block_to_chroma(vec_part0, vec_part1, v_mul)));
+}
+
+void bgra_row_to_yuv444_row_ssse3(const unsigned char *src, unsigned char *dst_y, unsigned char *dst_u,
+    unsigned char *dst_v, const int width)
+{
+    const int aligned_width = simd::align_down(width, 16);
+
+    int x = 0;
+    __no_unroll
+    for (; x < aligned_width; x += 16)
+    {
+        bgrx_block_to_yuv444_ssse3<4>(src, dst_y, dst_u, dst_v);
+        src += 64; // we process 64 bytes (16 pixels) per block
+        dst_y += 16;
+        dst_u += 16;
+        dst_v += 16;
+    }
+
+    bgra_row_to_yuv444_row_c(src, dst_y, dst_u, dst_v, width - x);
+}
+
+void bgr_row_to_yuv444_row_ssse3(const unsigned char *src, unsigned char *dst_y, unsigned char *dst_u,
+    unsigned char *dst_v, const int width)
+{
+    const int aligned_width = simd::align_down(width, 16);
+
+    int x = 0;
+    __no_unroll
+    for (; x < aligned_width; x += 16)
+    {
+        bgrx_block_to_yuv444_ssse3<3>(src, dst_y, dst_u, dst_v);
+        src += 48; // we process 48 bytes (16 pixels) per block
+        dst_y += 16;
+        dst_u += 16;
+        dst_v += 16;
+    }
+
+    bgr_row_to_yuv444_row_c(src, dst_y, dst_u, dst_v, width - x);
+}
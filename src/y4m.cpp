@@ -0,0 +1,469 @@
+/* Copyright(c) 2018 Steven Hoving
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "yuvconvert_y4m.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <sstream>
+#include <stdexcept>
+
+#if defined(_WIN32)
+#include <fcntl.h>
+#include <io.h>
+#include <sys/stat.h>
+#else
+#include <climits>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#endif
+
+namespace yuvconvert
+{
+
+static const char y4m_magic[] = "YUV4MPEG2";
+static const char frame_magic[] = "FRAME";
+
+// a few thin wrappers, so the rest of the file does not care about the platform.
+#if defined(_WIN32)
+struct io_part
+{
+    void *iov_base;
+    std::size_t iov_len;
+};
+
+static int open_for_read(const std::string &path)
+{
+    return _open(path.c_str(), _O_RDONLY | _O_BINARY);
+}
+
+static int open_for_write(const std::string &path)
+{
+    return _open(path.c_str(), _O_WRONLY | _O_CREAT | _O_TRUNC | _O_BINARY, _S_IREAD | _S_IWRITE);
+}
+
+static long long read_some(int fd, void *data, std::size_t size)
+{
+    return _read(fd, data, static_cast<unsigned int>(std::min<std::size_t>(size, 1u << 30)));
+}
+
+// there is no writev, the parts go out one by one.
+static long long write_parts(int fd, io_part *parts, int /*count*/)
+{
+    return _write(fd, parts[0].iov_base, static_cast<unsigned int>(std::min<std::size_t>(parts[0].iov_len, 1u << 30)));
+}
+
+static void close_file(int fd)
+{
+    _close(fd);
+}
+
+constexpr int stdin_fd = 0;
+constexpr int stdout_fd = 1;
+constexpr int max_io_parts = 1;
+#else
+using io_part = iovec;
+
+static int open_for_read(const std::string &path)
+{
+    return ::open(path.c_str(), O_RDONLY);
+}
+
+static int open_for_write(const std::string &path)
+{
+    return ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+}
+
+static long long read_some(int fd, void *data, std::size_t size)
+{
+    return ::read(fd, data, size);
+}
+
+static long long write_parts(int fd, io_part *parts, int count)
+{
+    return ::writev(fd, parts, count);
+}
+
+static void close_file(int fd)
+{
+    ::close(fd);
+}
+
+constexpr int stdin_fd = STDIN_FILENO;
+constexpr int stdout_fd = STDOUT_FILENO;
+constexpr int max_io_parts = IOV_MAX;
+#endif
+
+static std::runtime_error io_error(const std::string &what)
+{
+    return std::runtime_error(what + ": " + std::strerror(errno));
+}
+
+// write all parts, continuing after short writes. At most max_io_parts go out per call.
+static void write_all(int fd, io_part *parts, int count)
+{
+    while (count > 0)
+    {
+        auto result = write_parts(fd, parts, std::min(count, max_io_parts));
+        if (result < 0 && errno == EINTR)
+            continue;
+        if (result < 0)
+            throw io_error("can not write y4m stream");
+
+        while (count > 0 && static_cast<std::size_t>(result) >= parts->iov_len)
+        {
+            result -= static_cast<long long>(parts->iov_len);
+            ++parts;
+            --count;
+        }
+
+        if (count > 0)
+        {
+            parts->iov_base = static_cast<char *>(parts->iov_base) + result;
+            parts->iov_len -= static_cast<std::size_t>(result);
+        }
+    }
+}
+
+static bool parse_ratio(const std::string &value, int &numerator, int &denominator)
+{
+    const auto separator = value.find(':');
+    if (separator == std::string::npos)
+        return false;
+    numerator = std::atoi(value.substr(0, separator).c_str());
+    denominator = std::atoi(value.substr(separator + 1).c_str());
+    return true;
+}
+
+static y4m_header parse_header(const std::string &line)
+{
+    std::istringstream tokens(line);
+    std::string token;
+    if (!(tokens >> token) || token != y4m_magic)
+        throw std::runtime_error("not a y4m stream");
+
+    y4m_header header;
+    header.colorspace = "420jpeg";
+    while (tokens >> token)
+    {
+        const auto value = token.substr(1);
+        switch (token[0])
+        {
+        case 'W':
+            header.width = std::atoi(value.c_str());
+            break;
+        case 'H':
+            header.height = std::atoi(value.c_str());
+            break;
+        case 'F':
+            parse_ratio(value, header.fps_numerator, header.fps_denominator);
+            break;
+        case 'I':
+            header.interlace = value.empty() ? 'p' : value[0];
+            break;
+        case 'A':
+            parse_ratio(value, header.aspect_numerator, header.aspect_denominator);
+            break;
+        case 'C':
+            header.colorspace = value;
+            break;
+        default: // X comments and unknown parameters are skipped.
+            break;
+        }
+    }
+
+    if (header.width <= 0 || header.height <= 0)
+        throw std::runtime_error("y4m header without a valid size");
+
+    return header;
+}
+
+void y4m_chroma_size(const y4m_header &header, int &chroma_width, int &chroma_height)
+{
+    // only 8 bit samples are supported, so the tags are matched exactly: C420p10, C444alpha and the
+    // like have other sample sizes or an extra plane.
+    const auto &colorspace = header.colorspace;
+    if (colorspace == "444")
+    {
+        chroma_width = header.width;
+        chroma_height = header.height;
+    }
+    else if (colorspace == "422")
+    {
+        chroma_width = (header.width + 1) >> 1;
+        chroma_height = header.height;
+    }
+    else if (colorspace == "mono")
+    {
+        chroma_width = 0;
+        chroma_height = 0;
+    }
+    else if (colorspace == "420" || colorspace == "420jpeg" || colorspace == "420paldv" || colorspace == "420mpeg2")
+    {
+        chroma_width = (header.width + 1) >> 1;
+        chroma_height = (header.height + 1) >> 1;
+    }
+    else
+    {
+        throw std::runtime_error("unsupported y4m colorspace: " + colorspace);
+    }
+}
+
+y4m_reader::y4m_reader(const std::string &path, y4m_read_mode mode, int ring_size)
+{
+    if (path == "-")
+    {
+        fd_ = stdin_fd;
+        mode = y4m_read_mode::stream;
+    }
+    else
+    {
+        fd_ = open_for_read(path);
+        if (fd_ < 0)
+            throw io_error("can not open " + path);
+        owns_fd_ = true;
+    }
+
+#if defined(_WIN32)
+    mode = y4m_read_mode::stream;
+#else
+    if (mode == y4m_read_mode::mmap)
+    {
+        struct stat info;
+        if (::fstat(fd_, &info) == 0 && S_ISREG(info.st_mode) && info.st_size > 0)
+        {
+            size_ = static_cast<std::size_t>(info.st_size);
+            const auto data = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd_, 0);
+            if (data != MAP_FAILED)
+            {
+                data_ = static_cast<const unsigned char *>(data);
+                ::madvise(const_cast<void *>(data), size_, MADV_SEQUENTIAL);
+            }
+        }
+    }
+#endif
+
+    try
+    {
+        std::string line;
+        if (!read_line(line))
+            throw std::runtime_error("empty y4m stream");
+
+        header_ = parse_header(line);
+        int chroma_height = 0;
+        y4m_chroma_size(header_, chroma_width_, chroma_height);
+        plane_size_[0] = static_cast<std::size_t>(header_.width) * header_.height;
+        plane_size_[1] = static_cast<std::size_t>(chroma_width_) * chroma_height;
+        plane_size_[2] = plane_size_[1];
+        frame_size_ = plane_size_[0] + plane_size_[1] + plane_size_[2];
+    }
+    catch (...)
+    {
+        close();
+        throw;
+    }
+
+    if (!data_)
+        ring_.assign(std::max(1, ring_size), std::vector<unsigned char>(frame_size_));
+}
+
+y4m_reader::~y4m_reader()
+{
+    close();
+}
+
+void y4m_reader::close() noexcept
+{
+#if !defined(_WIN32)
+    if (data_)
+        ::munmap(const_cast<unsigned char *>(data_), size_);
+#endif
+    data_ = nullptr;
+
+    if (owns_fd_)
+        close_file(fd_);
+    owns_fd_ = false;
+}
+
+bool y4m_reader::next(y4m_frame_view &frame)
+{
+    return data_ ? next_mapped(frame) : next_streamed(frame);
+}
+
+bool y4m_reader::next_mapped(y4m_frame_view &frame)
+{
+    std::string line;
+    if (!read_line(line) || line.compare(0, sizeof(frame_magic) - 1, frame_magic) != 0)
+        return false;
+
+    if (size_ - offset_ < frame_size_)
+        return false;
+
+    set_planes(data_ + offset_, frame);
+    offset_ += frame_size_;
+    return true;
+}
+
+bool y4m_reader::next_streamed(y4m_frame_view &frame)
+{
+    // the frame header is almost always just "FRAME\n", so that is read in one go.
+    unsigned char frame_header[sizeof(frame_magic)];
+    if (!read_exact(frame_header, sizeof(frame_header)) ||
+        std::memcmp(frame_header, frame_magic, sizeof(frame_magic) - 1) != 0)
+        return false;
+
+    if (frame_header[sizeof(frame_magic) - 1] != '\n')
+    {
+        std::string parameters;
+        if (!read_line(parameters))
+            return false;
+    }
+
+    auto &slot = ring_[next_index_ % ring_.size()];
+    if (!read_exact(slot.data(), frame_size_))
+        return false;
+
+    set_planes(slot.data(), frame);
+    return true;
+}
+
+void y4m_reader::set_planes(const unsigned char *data, y4m_frame_view &frame) noexcept
+{
+    frame.planes[0] = data;
+    frame.planes[1] = plane_size_[1] ? data + plane_size_[0] : nullptr;
+    frame.planes[2] = plane_size_[2] ? data + plane_size_[0] + plane_size_[1] : nullptr;
+    frame.stride[0] = header_.width;
+    frame.stride[1] = chroma_width_;
+    frame.stride[2] = chroma_width_;
+    frame.index = next_index_++;
+}
+
+bool y4m_reader::read_line(std::string &line)
+{
+    line.clear();
+    if (data_)
+    {
+        const auto begin = data_ + offset_;
+        const auto end = static_cast<const unsigned char *>(std::memchr(begin, '\n', size_ - offset_));
+        if (!end)
+            return false;
+        line.assign(begin, end);
+        offset_ += static_cast<std::size_t>(end - begin) + 1;
+        return true;
+    }
+
+    // headers are short and only read once, byte by byte is fine.
+    unsigned char value;
+    while (read_exact(&value, 1))
+    {
+        if (value == '\n')
+            return true;
+        line.push_back(static_cast<char>(value));
+    }
+    return false;
+}
+
+bool y4m_reader::read_exact(unsigned char *data, std::size_t size)
+{
+    while (size > 0)
+    {
+        const auto result = read_some(fd_, data, size);
+        if (result < 0 && errno == EINTR)
+            continue;
+        if (result < 0)
+            throw io_error("can not read y4m stream");
+        if (result == 0)
+            return false;
+
+        data += result;
+        size -= static_cast<std::size_t>(result);
+    }
+    return true;
+}
+
+y4m_writer::y4m_writer(const std::string &path, const y4m_header &header)
+    : header_(header)
+{
+    y4m_chroma_size(header_, chroma_width_, chroma_height_);
+
+    if (path == "-")
+    {
+        fd_ = stdout_fd;
+    }
+    else
+    {
+        fd_ = open_for_write(path);
+        if (fd_ < 0)
+            throw io_error("can not create " + path);
+        owns_fd_ = true;
+    }
+
+    std::ostringstream line;
+    line << y4m_magic << " W" << header_.width << " H" << header_.height << " F" << header_.fps_numerator << ':'
+         << header_.fps_denominator << " I" << header_.interlace << " A" << header_.aspect_numerator << ':'
+         << header_.aspect_denominator << " C" << header_.colorspace << '\n';
+    const auto text = line.str();
+
+    io_part part{const_cast<char *>(text.data()), text.size()};
+    write_all(fd_, &part, 1);
+}
+
+y4m_writer::~y4m_writer()
+{
+    if (owns_fd_)
+        close_file(fd_);
+}
+
+void y4m_writer::write(const unsigned char *const planes[3], const int stride[3])
+{
+    static const char frame_header[] = "FRAME\n";
+
+    const int widths[3] = {header_.width, chroma_width_, chroma_width_};
+    const int heights[3] = {header_.height, chroma_height_, chroma_height_};
+
+    std::vector<io_part> parts;
+    parts.push_back({const_cast<char *>(frame_header), sizeof(frame_header) - 1});
+    for (int plane = 0; plane < 3; ++plane)
+    {
+        if (widths[plane] == 0)
+            continue;
+
+        // an unpadded plane goes out as a whole, a padded one row by row.
+        const auto data = const_cast<unsigned char *>(planes[plane]);
+        if (stride[plane] == widths[plane])
+        {
+            parts.push_back({data, static_cast<std::size_t>(widths[plane]) * heights[plane]});
+            continue;
+        }
+
+        for (int row = 0; row < heights[plane]; ++row)
+            parts.push_back({data + static_cast<std::ptrdiff_t>(row) * stride[plane], static_cast<std::size_t>(widths[plane])});
+    }
+
+    write_all(fd_, parts.data(), static_cast<int>(parts.size()));
+}
+
+} // namespace yuvconvert
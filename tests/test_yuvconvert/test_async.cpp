@@ -0,0 +1,140 @@
+/* Copyright(c) 2018 Steven Hoving
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <gtest/gtest.h>
+#include <yuvconvert.h>
+#include <yuvconvert/yuvconvert_async.h>
+#include "test_frame.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+constexpr auto frame_width = 322;
+constexpr auto frame_height = 98;
+constexpr auto frame_count = 12;
+
+// a source and the frame it is converted into.
+struct async_frame : frame_420
+{
+    explicit async_frame(unsigned int seed)
+        : frame_420(frame_width, frame_height)
+        , source(random_bytes(frame_width * frame_height * 4, seed))
+    {
+    }
+
+    std::vector<uint8_t> expected() const
+    {
+        frame_420 result(frame_width, frame_height);
+        const unsigned char *src[3] = {source.data(), nullptr, nullptr};
+        const int src_stride[3] = {frame_width * 4, 0, 0};
+        yuvconvert::bgra_to_420(result.planes, result.stride, src, frame_width, frame_height, src_stride,
+            yuvconvert::simd_mode::plain_c);
+        return result.buffer;
+    }
+
+    std::vector<uint8_t> source;
+};
+
+static std::vector<async_frame> create_frames()
+{
+    std::vector<async_frame> frames;
+    for (int i = 0; i < frame_count; ++i)
+        frames.emplace_back(i + 1);
+    return frames;
+}
+
+static yuvconvert::converter create_converter(int band_height)
+{
+    return yuvconvert::converter(yuvconvert::pixel_format::bgra, frame_width, frame_height,
+        {yuvconvert::simd_mode::ssse3, band_height, 0});
+}
+
+TEST(test_async, completion_queue)
+{
+    for (const auto band_height : {0, 16})
+    {
+        auto frames = create_frames();
+        yuvconvert::async_converter converter(create_converter(band_height));
+
+        std::vector<yuvconvert::ticket> tickets;
+        for (auto &frame : frames)
+            tickets.push_back(converter.submit(frame.planes, frame.stride, frame.source.data(), frame_width * 4));
+
+        EXPECT_EQ(tickets.front(), 1u);
+        EXPECT_TRUE(std::is_sorted(tickets.begin(), tickets.end()));
+
+        std::vector<yuvconvert::ticket> completed;
+        for (int i = 0; i < frame_count; ++i)
+            completed.push_back(converter.wait_any());
+
+        EXPECT_EQ(converter.in_flight(), 0u);
+        yuvconvert::ticket extra;
+        EXPECT_FALSE(converter.poll(extra));
+
+        std::sort(completed.begin(), completed.end());
+        EXPECT_EQ(completed, tickets);
+
+        for (const auto &frame : frames)
+            EXPECT_EQ(frame.buffer, frame.expected());
+    }
+}
+
+TEST(test_async, callback)
+{
+    auto frames = create_frames();
+    std::atomic<int> callbacks{0};
+    {
+        yuvconvert::async_converter converter(create_converter(32));
+        for (auto &frame : frames)
+            converter.submit(frame.planes, frame.stride, frame.source.data(), frame_width * 4,
+                [&](yuvconvert::ticket) { ++callbacks; });
+
+        converter.wait_all();
+        EXPECT_EQ(callbacks, frame_count);
+
+        // a conversion with a callback does not show up in the completion queue.
+        yuvconvert::ticket completed;
+        EXPECT_FALSE(converter.poll(completed));
+    }
+
+    for (const auto &frame : frames)
+        EXPECT_EQ(frame.buffer, frame.expected());
+}
+
+TEST(test_async, wait_for_ticket_and_destruction)
+{
+    auto frames = create_frames();
+    {
+        yuvconvert::async_converter converter(create_converter(0));
+        const auto first = converter.submit(frames[0].planes, frames[0].stride, frames[0].source.data(), frame_width * 4);
+        converter.wait(first);
+        EXPECT_EQ(frames[0].buffer, frames[0].expected());
+
+        // the destructor waits for the rest.
+        for (int i = 1; i < frame_count; ++i)
+            converter.submit(frames[i].planes, frames[i].stride, frames[i].source.data(), frame_width * 4);
+    }
+
+    for (const auto &frame : frames)
+        EXPECT_EQ(frame.buffer, frame.expected());
+}
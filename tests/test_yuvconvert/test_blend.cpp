@@ -0,0 +1,131 @@
+/* Copyright(c) 2018 Steven Hoving
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <gtest/gtest.h>
+#include <yuvconvert.h>
+
+#include "test_utilities.h"
+#include "test_frame.h"
+#include <vector>
+#include <cstdint>
+#include <algorithm>
+
+static void fill_random(frame_420 &frame, unsigned int seed)
+{
+    const auto bytes = random_bytes(frame.buffer.size(), seed);
+    std::copy(bytes.begin(), bytes.end(), frame.buffer.begin());
+}
+
+struct blend_param
+{
+    int x;
+    int y;
+    int overlay_width;
+    int overlay_height;
+};
+
+class blend_fixture : public testing::TestWithParam<blend_param>
+{
+};
+
+TEST_P(blend_fixture, ssse3_matches_c)
+{
+    const auto param = GetParam();
+    const auto overlay = random_bytes(param.overlay_width * param.overlay_height * 4, 7);
+    const unsigned char *src[3] = {overlay.data(), nullptr, nullptr};
+    const int src_stride[3] = {param.overlay_width * 4, 0, 0};
+
+    frame_420 frame_c(100, 60);
+    frame_420 frame_sse(100, 60);
+    fill_random(frame_c, 3);
+    fill_random(frame_sse, 3);
+
+    yuvconvert::bgra_blend_to_420(frame_c.planes, frame_c.stride, frame_c.width, frame_c.height, src,
+        param.overlay_width, param.overlay_height, src_stride, param.x, param.y, yuvconvert::simd_mode::plain_c);
+    yuvconvert::bgra_blend_to_420(frame_sse.planes, frame_sse.stride, frame_sse.width, frame_sse.height, src,
+        param.overlay_width, param.overlay_height, src_stride, param.x, param.y, yuvconvert::simd_mode::ssse3);
+    EXPECT_EQ(frame_c.buffer, frame_sse.buffer);
+}
+
+INSTANTIATE_TEST_CASE_P(blend_test_sequence, blend_fixture, ::testing::ValuesIn(std::vector<blend_param>{
+    {0, 0, 100, 60},
+    {4, 2, 64, 32},
+    {5, 3, 48, 33},
+    {-7, -5, 50, 20},
+    {70, 50, 64, 32},
+    {99, 59, 16, 16},
+}));
+
+TEST(test_blend, alpha_extremes)
+{
+    const auto width = 64;
+    const auto height = 32;
+    auto overlay = random_bytes(width * height * 4, 11);
+    const unsigned char *src[3] = {overlay.data(), nullptr, nullptr};
+    const int src_stride[3] = {width * 4, 0, 0};
+
+    frame_420 original(width * 2, height * 2);
+    frame_420 frame(width * 2, height * 2);
+    fill_random(original, 5);
+    fill_random(frame, 5);
+
+    // fully transparent leaves the frame alone.
+    for (int i = 0; i < width * height; ++i)
+        overlay[i * 4 + 3] = 0;
+    yuvconvert::bgra_blend_to_420(frame.planes, frame.stride, frame.width, frame.height, src, width, height,
+        src_stride, 16, 8, yuvconvert::simd_mode::ssse3);
+    EXPECT_EQ(frame.buffer, original.buffer);
+
+    // fully opaque is the same as converting the overlay.
+    for (int i = 0; i < width * height; ++i)
+        overlay[i * 4 + 3] = 255;
+    yuvconvert::bgra_blend_to_420(frame.planes, frame.stride, frame.width, frame.height, src, width, height,
+        src_stride, 16, 8, yuvconvert::simd_mode::ssse3);
+
+    frame_420 converted(width, height);
+    yuvconvert::bgra_to_420(converted.planes, converted.stride, src, width, height, src_stride,
+        yuvconvert::simd_mode::plain_c);
+
+    for (int line = 0; line < frame.height; ++line)
+    {
+        for (int x = 0; x < frame.width; ++x)
+        {
+            const auto inside = x >= 16 && x < 16 + width && line >= 8 && line < 8 + height;
+            const auto expected = inside ? converted.planes[0][(line - 8) * converted.stride[0] + x - 16]
+                                         : original.planes[0][line * original.stride[0] + x];
+            ASSERT_EQ(frame.planes[0][line * frame.stride[0] + x], expected);
+        }
+    }
+
+    for (int line = 0; line < frame.height / 2; ++line)
+    {
+        for (int x = 0; x < frame.width / 2; ++x)
+        {
+            const auto inside = x >= 8 && x < 8 + width / 2 && line >= 4 && line < 4 + height / 2;
+            const auto expected_u = inside ? converted.planes[1][(line - 4) * converted.stride[1] + x - 8]
+                                           : original.planes[1][line * original.stride[1] + x];
+            const auto expected_v = inside ? converted.planes[2][(line - 4) * converted.stride[2] + x - 8]
+                                           : original.planes[2][line * original.stride[2] + x];
+            ASSERT_EQ(frame.planes[1][line * frame.stride[1] + x], expected_u);
+            ASSERT_EQ(frame.planes[2][line * frame.stride[2] + x], expected_v);
+        }
+    }
+}
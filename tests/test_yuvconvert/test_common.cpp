@@ -66,3 +66,24 @@ TEST(test_common, test_yuv_convertion_chroma_u)
 
     //EXPECT_EQ(values_incorrect, 0);
 }
+
+TEST(test_common, floating_point_matches_the_kernels)
+{
+    // the kernels use 8 bit approximations of the same bt.601 matrix.
+    int values_incorrect = 0;
+    for (int r = 0; r < 256; ++r)
+    {
+        for (int g = 0; g < 256; ++g)
+        {
+            for (int b = 0; b < 256; ++b)
+            {
+                if (abs(rgb2y(r, g, b) - rgbconvert<floating_point>::to_y(r, g, b)) > 1 ||
+                    abs(rgb2u(r, g, b) - rgbconvert<floating_point>::to_u(r, g, b)) > 1 ||
+                    abs(rgb2v(r, g, b) - rgbconvert<floating_point>::to_v(r, g, b)) > 1)
+                    values_incorrect++;
+            }
+        }
+    }
+
+    EXPECT_EQ(values_incorrect, 0);
+}
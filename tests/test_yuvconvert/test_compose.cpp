@@ -0,0 +1,91 @@
+/* Copyright(c) 2018 Steven Hoving
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <gtest/gtest.h>
+#include <yuvconvert.h>
+
+#include "test_utilities.h"
+#include "test_frame.h"
+#include <vector>
+#include <cstdint>
+#include <algorithm>
+
+// the way a video wall used to be built, convert into a temporary and copy the visible part.
+static void convert_and_copy(frame_420 &canvas, const yuvconvert::composition_source &source)
+{
+    frame_420 temporary(source.width, source.height);
+    const unsigned char *src[3] = {source.data, nullptr, nullptr};
+    const int src_stride[3] = {source.stride, 0, 0};
+    if (source.format == yuvconvert::pixel_format::bgra)
+        yuvconvert::bgra_to_420(temporary.planes, temporary.stride, src, source.width, source.height, src_stride, yuvconvert::simd_mode::plain_c);
+    else
+        yuvconvert::bgr_to_420(temporary.planes, temporary.stride, src, source.width, source.height, src_stride, yuvconvert::simd_mode::plain_c);
+
+    for (int line = 0; line < source.height; ++line)
+    {
+        for (int x = 0; x < source.width; ++x)
+        {
+            const auto canvas_x = source.x + x;
+            const auto canvas_y = source.y + line;
+            if (canvas_x < 0 || canvas_x >= canvas.width || canvas_y < 0 || canvas_y >= canvas.height)
+                continue;
+
+            canvas.planes[0][canvas_y * canvas.stride[0] + canvas_x] = temporary.planes[0][line * temporary.stride[0] + x];
+            if ((x & 1) == 0 && (line & 1) == 0)
+            {
+                for (int plane = 1; plane < 3; ++plane)
+                    canvas.planes[plane][(canvas_y >> 1) * canvas.stride[plane] + (canvas_x >> 1)] =
+                        temporary.planes[plane][(line >> 1) * temporary.stride[plane] + (x >> 1)];
+            }
+        }
+    }
+}
+
+TEST(test_compose, matches_convert_and_copy)
+{
+    const auto width = 320;
+    const auto height = 180;
+
+    const auto source0 = random_bytes(160 * 90 * 4, 1);
+    const auto source1 = random_bytes(150 * 91 * 3, 2);
+    const auto source2 = random_bytes(161 * 200 * 4, 3);
+    const auto source3 = random_bytes(64 * 64 * 4, 4);
+
+    const std::vector<yuvconvert::composition_source> sources = {
+        {source0.data(), 160 * 4, 160, 90, yuvconvert::pixel_format::bgra, 0, 0},
+        {source1.data(), 150 * 3, 150, 91, yuvconvert::pixel_format::bgr, 160, 0},
+        {source2.data(), 161 * 4, 161, 200, yuvconvert::pixel_format::bgra, 0, 92},   // clipped at the bottom
+        {source3.data(), 64 * 4, 64, 64, yuvconvert::pixel_format::bgra, 280, -20},   // clipped at the top right
+    };
+
+    for (const auto mode : {yuvconvert::simd_mode::plain_c, yuvconvert::simd_mode::ssse3})
+    {
+        frame_420 composed(width, height, 0, 0x55);
+        yuvconvert::compose_420(composed.planes, composed.stride, width, height, sources.data(),
+            static_cast<int>(sources.size()), mode);
+
+        frame_420 expected(width, height, 0, 0x55);
+        for (const auto &source : sources)
+            convert_and_copy(expected, source);
+
+        EXPECT_EQ(composed.buffer, expected.buffer);
+    }
+}
@@ -0,0 +1,184 @@
+/* Copyright(c) 2018 Steven Hoving
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <gtest/gtest.h>
+#include <yuvconvert.h>
+#include <yuvconvert/yuvconvert_converter.h>
+#include "test_frame.h"
+
+#include <cstdio>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+TEST(test_converter, matches_plain_conversion)
+{
+    constexpr auto width = 333;
+    constexpr auto height = 201;
+    const auto source = random_bytes(width * height * 4, 7);
+    const unsigned char *src[3] = {source.data(), nullptr, nullptr};
+    const int src_stride[3] = {width * 4, 0, 0};
+
+    frame_420 expected(width, height);
+    yuvconvert::bgra_to_420(expected.planes, expected.stride, src, width, height, src_stride, yuvconvert::simd_mode::plain_c);
+
+    for (const auto mode : {yuvconvert::simd_mode::plain_c, yuvconvert::simd_mode::ssse3})
+    {
+        for (const auto band_height : {0, 2, 16, 63, 1000})
+        {
+            frame_420 result(width, height);
+            const yuvconvert::converter converter(yuvconvert::pixel_format::bgra, width, height, {mode, band_height, 0});
+            converter.convert(result.planes, result.stride, source.data(), width * 4);
+            EXPECT_EQ(result.buffer, expected.buffer) << "band height " << band_height;
+        }
+    }
+}
+
+TEST(test_converter, column_tiles_match_full_rows)
+{
+    constexpr auto width = 333;
+    constexpr auto height = 41;
+
+    for (const auto format : {yuvconvert::pixel_format::bgr, yuvconvert::pixel_format::bgra})
+    {
+        const auto pixel_width = (format == yuvconvert::pixel_format::bgra) ? 4 : 3;
+        const auto source = random_bytes(width * height * pixel_width, 7);
+
+        frame_420 expected(width, height);
+        const yuvconvert::converter reference(format, width, height, {yuvconvert::simd_mode::plain_c, 0, 0});
+        reference.convert(expected.planes, expected.stride, source.data(), width * pixel_width);
+
+        // tile widths that are not a multiple of 16 are rounded down, the last tile is odd.
+        for (const auto tile_width : {1, 16, 50, 96, 332})
+        {
+            for (const auto band_height : {0, 18})
+            {
+                frame_420 result(width, height);
+                const yuvconvert::converter converter(format, width, height,
+                    {yuvconvert::simd_mode::ssse3, band_height, tile_width});
+                converter.convert(result.planes, result.stride, source.data(), width * pixel_width);
+                EXPECT_EQ(result.buffer, expected.buffer) << "tile width " << tile_width;
+            }
+        }
+    }
+}
+
+TEST(test_converter, specialized_widths_match_generic)
+{
+    constexpr auto height = 9;
+
+    for (const auto format : {yuvconvert::pixel_format::bgr, yuvconvert::pixel_format::bgra})
+    {
+        for (const auto width : {1280, 1920, 3840})
+        {
+            const auto pixel_width = (format == yuvconvert::pixel_format::bgra) ? 4 : 3;
+            const auto source = random_bytes(width * height * pixel_width + 1, 7);
+
+            // an offset of one byte moves the source off its 16 byte alignment.
+            for (const auto offset : {0, 1})
+            {
+                frame_420 expected(width, height);
+                const yuvconvert::converter reference(format, width, height, {yuvconvert::simd_mode::plain_c, 0, 0});
+                reference.convert(expected.planes, expected.stride, source.data() + offset, width * pixel_width);
+                EXPECT_FALSE(reference.specialized());
+
+                for (const auto band_height : {0, 4})
+                {
+                    frame_420 result(width, height);
+                    const yuvconvert::converter converter(format, width, height,
+                        {yuvconvert::simd_mode::ssse3, band_height, 0});
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+                    // the width specialized converters are ssse3 kernels, other targets use the generic ones.
+                    EXPECT_TRUE(converter.specialized());
+#endif
+                    converter.convert(result.planes, result.stride, source.data() + offset, width * pixel_width);
+                    EXPECT_EQ(result.buffer, expected.buffer) << "width " << width << " offset " << offset;
+                }
+            }
+        }
+    }
+
+    // other widths, column tiles and an explicit opt out use the generic kernels.
+    EXPECT_FALSE(yuvconvert::converter(yuvconvert::pixel_format::bgra, 1296, height, {}).specialized());
+    EXPECT_FALSE(yuvconvert::converter(yuvconvert::pixel_format::bgra, 1920, height,
+        {yuvconvert::simd_mode::ssse3, 0, 256}).specialized());
+    EXPECT_FALSE(yuvconvert::converter(yuvconvert::pixel_format::bgra, 1920, height,
+        {yuvconvert::simd_mode::ssse3, 0, 0, false}).specialized());
+}
+
+TEST(test_converter, default_tile_width)
+{
+    const auto bgra = yuvconvert::default_tile_width(yuvconvert::pixel_format::bgra);
+    const auto bgr = yuvconvert::default_tile_width(yuvconvert::pixel_format::bgr);
+    EXPECT_EQ(bgra % 16, 0);
+    EXPECT_GE(bgra, 16);
+    EXPECT_GE(bgr, bgra);
+}
+
+TEST(test_converter, autotune_picks_a_candidate)
+{
+    const auto config = yuvconvert::autotune(yuvconvert::pixel_format::bgr, 640, 480);
+    EXPECT_TRUE(config.mode == yuvconvert::simd_mode::plain_c || config.mode == yuvconvert::simd_mode::ssse3 ||
+        config.mode == yuvconvert::simd_mode::portable);
+    EXPECT_GE(config.band_height, 0);
+    EXPECT_LT(config.band_height, 480);
+    EXPECT_TRUE(config.tile_width == 0 || config.tile_width == yuvconvert::default_tile_width(yuvconvert::pixel_format::bgr));
+}
+
+TEST(test_converter, autotune_cache)
+{
+    const auto cache_path = ::testing::TempDir() + "yuvconvert_autotune_cache.txt";
+    std::remove(cache_path.c_str());
+
+    // the first call tunes and adds a line to the cache.
+    const auto tuned = yuvconvert::autotune(yuvconvert::pixel_format::bgra, 320, 240, cache_path);
+    std::string line;
+    {
+        std::ifstream file(cache_path);
+        ASSERT_TRUE(std::getline(file, line));
+    }
+
+    // edit the cached band height, a later call has to return it instead of tuning again.
+    const auto edited_band_height = tuned.band_height + 2;
+    const auto tile_start = line.find_last_of(' ');
+    const auto band_start = line.find_last_of(' ', tile_start - 1);
+    line = line.substr(0, band_start + 1) + std::to_string(edited_band_height) + line.substr(tile_start);
+    {
+        std::ofstream file(cache_path);
+        file << line << '\n';
+    }
+
+    const auto cached = yuvconvert::autotune(yuvconvert::pixel_format::bgra, 320, 240, cache_path);
+    EXPECT_EQ(cached.mode, tuned.mode);
+    EXPECT_EQ(cached.band_height, edited_band_height);
+    EXPECT_EQ(cached.tile_width, tuned.tile_width);
+
+    // another geometry is not in the cache yet.
+    yuvconvert::autotune(yuvconvert::pixel_format::bgra, 322, 240, cache_path);
+    std::ifstream file(cache_path);
+    int lines = 0;
+    while (std::getline(file, line))
+        ++lines;
+    EXPECT_EQ(lines, 2);
+
+    std::remove(cache_path.c_str());
+}
@@ -0,0 +1,149 @@
+/* Copyright(c) 2018 Steven Hoving
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <gtest/gtest.h>
+#include <yuvconvert.h>
+#include "test_frame.h"
+
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+namespace
+{
+// samples of bit_depth bits, built from two random bytes each.
+std::vector<uint16_t> random_samples(const int size, const int bit_depth)
+{
+    const auto bytes = random_bytes(size * 2, 3);
+    std::vector<uint16_t> result(size);
+    for (int i = 0; i < size; ++i)
+        result[i] = static_cast<uint16_t>((bytes[i * 2] | (bytes[i * 2 + 1] << 8)) & ((1u << bit_depth) - 1));
+    return result;
+}
+
+void deep_to_420(const int channels, frame_420 &frame, const uint16_t *source, const int src_stride,
+    const int width, const int height, const int bit_depth, const bool dither, yuvconvert::simd_mode mode)
+{
+    if (channels == 4)
+        yuvconvert::bgra64_to_420(frame.planes, frame.stride, source, src_stride, width, height, bit_depth, dither, mode);
+    else
+        yuvconvert::bgr48_to_420(frame.planes, frame.stride, source, src_stride, width, height, bit_depth, dither, mode);
+}
+} // namespace
+
+TEST(test_dither, without_dither_matches_8_bit)
+{
+    constexpr auto width = 45;
+    constexpr auto height = 9;
+
+    for (const auto channels : {3, 4})
+    {
+        const auto source = random_samples(width * height * channels, 8);
+        const unsigned char *src[3] = {nullptr, nullptr, nullptr};
+        const int src_stride[3] = {width * channels, 0, 0};
+        std::vector<uint8_t> source_8(source.begin(), source.end());
+        src[0] = source_8.data();
+
+        frame_420 expected(width, height);
+        if (channels == 4)
+            yuvconvert::bgra_to_420(expected.planes, expected.stride, src, width, height, src_stride, yuvconvert::simd_mode::plain_c);
+        else
+            yuvconvert::bgr_to_420(expected.planes, expected.stride, src, width, height, src_stride, yuvconvert::simd_mode::plain_c);
+
+        // the same samples with 2 (10 bit) and 8 (16 bit) extra fraction bits of 0.
+        for (const auto bit_depth : {10, 16})
+        {
+            std::vector<uint16_t> deep(source.size());
+            for (std::size_t i = 0; i < source.size(); ++i)
+                deep[i] = static_cast<uint16_t>(source[i] << (bit_depth - 8));
+
+            for (const auto mode : {yuvconvert::simd_mode::plain_c, yuvconvert::simd_mode::ssse3})
+            {
+                frame_420 result(width, height);
+                deep_to_420(channels, result, deep.data(), width * channels * 2, width, height, bit_depth, false, mode);
+                EXPECT_EQ(result.buffer, expected.buffer) << "bit depth " << bit_depth;
+            }
+        }
+    }
+}
+
+TEST(test_dither, simd_matches_plain_c)
+{
+    constexpr auto height = 11;
+
+    for (const auto channels : {3, 4})
+    {
+        for (const auto bit_depth : {10, 12, 16})
+        {
+            for (const auto width : {1, 7, 8, 9, 33, 100})
+            {
+                // padded source rows and destination planes.
+                const auto src_stride = (width + 3) * channels;
+                const auto source = random_samples(src_stride * height, bit_depth);
+
+                for (const auto dither : {false, true})
+                {
+                    frame_420 expected(width, height, 5);
+                    frame_420 result(width, height, 5);
+                    deep_to_420(channels, expected, source.data(), src_stride * 2, width, height, bit_depth, dither,
+                        yuvconvert::simd_mode::plain_c);
+                    deep_to_420(channels, result, source.data(), src_stride * 2, width, height, bit_depth, dither,
+                        yuvconvert::simd_mode::ssse3);
+                    EXPECT_EQ(result.buffer, expected.buffer) << "width " << width << " bit depth " << bit_depth;
+                }
+            }
+        }
+    }
+}
+
+TEST(test_dither, dither_keeps_the_fraction)
+{
+    constexpr auto width = 64;
+    constexpr auto height = 64;
+    constexpr auto bit_depth = 10;
+
+    // a flat gray that falls between two 8 bit luma values.
+    constexpr auto gray = 601;
+    const std::vector<uint16_t> source(width * height * 4, gray);
+    const auto exact_luma = 220.0 * (gray << 5) / 32768.0 + 16.0;
+    ASSERT_GT(std::abs(exact_luma - std::round(exact_luma)), 0.1);
+
+    for (const auto mode : {yuvconvert::simd_mode::plain_c, yuvconvert::simd_mode::ssse3})
+    {
+        frame_420 rounded(width, height);
+        frame_420 dithered(width, height);
+        deep_to_420(4, rounded, source.data(), width * 8, width, height, bit_depth, false, mode);
+        deep_to_420(4, dithered, source.data(), width * 8, width, height, bit_depth, true, mode);
+
+        double rounded_sum = 0;
+        double dithered_sum = 0;
+        for (int i = 0; i < width * height; ++i)
+        {
+            rounded_sum += rounded.planes[0][i];
+            dithered_sum += dithered.planes[0][i];
+            EXPECT_LE(std::abs(dithered.planes[0][i] - exact_luma), 1.0);
+        }
+
+        // rounding loses the fraction, the dither keeps it within a step of the 16 level matrix.
+        EXPECT_EQ(rounded_sum / (width * height), std::round(exact_luma));
+        EXPECT_NEAR(dithered_sum / (width * height), exact_luma, 1.0 / 16);
+    }
+}
@@ -0,0 +1,64 @@
+/* Copyright(c) 2018 Steven Hoving
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// pseudo random bytes from a 32 bit lcg, the same seed gives the same bytes on every platform.
+inline std::vector<uint8_t> random_bytes(const std::size_t size, unsigned int seed)
+{
+    std::vector<uint8_t> result(size);
+    for (auto &itr : result)
+    {
+        seed = seed * 1103515245u + 12345u;
+        itr = static_cast<uint8_t>(seed >> 16);
+    }
+    return result;
+}
+
+// an i420 frame in a single buffer. padding is added to every stride and the whole buffer starts out as
+// fill, so a test can check that a conversion leaves the padding alone.
+struct frame_420
+{
+    frame_420(int width, int height, int padding = 0, uint8_t fill = 0)
+        : width(width)
+        , height(height)
+    {
+        const auto chroma_width = (width + 1) >> 1;
+        const auto chroma_height = (height + 1) >> 1;
+        stride[0] = width + padding;
+        stride[1] = chroma_width + padding;
+        stride[2] = chroma_width + padding;
+        buffer.resize(stride[0] * height + stride[1] * chroma_height * 2, fill);
+        planes[0] = buffer.data();
+        planes[1] = planes[0] + stride[0] * height;
+        planes[2] = planes[1] + stride[1] * chroma_height;
+    }
+
+    int width;
+    int height;
+    std::vector<uint8_t> buffer;
+    uint8_t *planes[3]{nullptr, nullptr, nullptr};
+    int stride[3]{0, 0, 0};
+};
@@ -0,0 +1,157 @@
+/* Copyright(c) 2018 Steven Hoving
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <gtest/gtest.h>
+#include <yuvconvert.h>
+#include <yuvconvert/yuvconvert_frame_pool.h>
+
+#include "test_frame.h"
+#include <vector>
+#include <cstdint>
+#include <cstring>
+
+using yuvconvert::frame_alignment;
+using yuvconvert::frame_format;
+using yuvconvert::frame_pool;
+
+static bool is_aligned(const void *pointer)
+{
+    return (reinterpret_cast<uintptr_t>(pointer) % frame_alignment) == 0;
+}
+
+TEST(test_frame_pool, i420_layout)
+{
+    frame_pool pool(frame_format::i420, 1921, 1081);
+    const auto frame = pool.acquire();
+
+    EXPECT_EQ(frame.width, 1921);
+    EXPECT_EQ(frame.height, 1081);
+    EXPECT_EQ(frame.stride[0], 1984);
+    EXPECT_EQ(frame.stride[1], 1024);
+    EXPECT_EQ(frame.stride[2], 1024);
+    EXPECT_EQ(pool.frame_size(), 1984u * 1081 + 1024u * 541 * 2);
+    for (int i = 0; i < 3; ++i)
+    {
+        EXPECT_TRUE(is_aligned(frame.planes[i]));
+        EXPECT_EQ(frame.stride[i] % frame_alignment, 0);
+    }
+
+    // the whole frame is writable.
+    std::memset(frame.planes[0], 0, pool.frame_size());
+    pool.release(frame);
+}
+
+TEST(test_frame_pool, nv12_and_bgra_layout)
+{
+    frame_pool nv12_pool(frame_format::nv12, 641, 480);
+    const auto nv12 = nv12_pool.acquire();
+    EXPECT_EQ(nv12.stride[0], 704);
+    EXPECT_EQ(nv12.stride[1], 704);
+    EXPECT_EQ(nv12.planes[2], nullptr);
+    EXPECT_EQ(nv12.planes[1], nv12.planes[0] + 704 * 480);
+    EXPECT_TRUE(is_aligned(nv12.planes[1]));
+
+    frame_pool bgra_pool(frame_format::bgra, 100, 10);
+    const auto bgra = bgra_pool.acquire();
+    EXPECT_EQ(bgra.stride[0], 448);
+    EXPECT_EQ(bgra.planes[1], nullptr);
+    EXPECT_TRUE(is_aligned(bgra.planes[0]));
+}
+
+TEST(test_frame_pool, recycles_released_frames)
+{
+    frame_pool pool(frame_format::i420, 320, 240);
+    auto first = pool.acquire();
+    const auto first_data = first.planes[0];
+    pool.release(first);
+
+    const auto second = pool.acquire();
+    EXPECT_EQ(second.planes[0], first_data);
+    EXPECT_EQ(pool.allocated_count(), 1u);
+
+    const auto third = pool.acquire();
+    EXPECT_NE(third.planes[0], first_data);
+    EXPECT_EQ(pool.allocated_count(), 2u);
+
+    pool.reserve(3);
+    EXPECT_EQ(pool.allocated_count(), 5u);
+    for (int i = 0; i < 3; ++i)
+        pool.acquire();
+    EXPECT_EQ(pool.allocated_count(), 5u);
+}
+
+TEST(test_frame_pool, huge_pages_fall_back)
+{
+    // without reserved huge pages the pool silently uses normal pages.
+    for (const auto backing : {yuvconvert::page_backing::transparent_huge_pages, yuvconvert::page_backing::huge_pages})
+    {
+        frame_pool pool(frame_format::bgra, 1920, 1080, backing);
+        const auto frame = pool.acquire();
+        ASSERT_NE(frame.planes[0], nullptr);
+        std::memset(frame.planes[0], 0xff, pool.frame_size());
+        pool.release(frame);
+    }
+}
+
+// pool frames take the aligned kernels, the result has to match a conversion between unaligned
+// buffers.
+TEST(test_frame_pool, aligned_conversion_matches)
+{
+    constexpr auto width = 637;
+    constexpr auto height = 359;
+    const auto chroma_width = (width + 1) >> 1;
+    const auto chroma_height = (height + 1) >> 1;
+
+    frame_pool bgra_pool(frame_format::bgra, width, height);
+    frame_pool i420_pool(frame_format::i420, width, height);
+    const auto source = bgra_pool.acquire();
+    const auto result = i420_pool.acquire();
+
+    const auto packed = random_bytes(width * 4 * height + 1, 1);
+    std::vector<uint8_t> expected(width * height + chroma_width * chroma_height * 2 + 1);
+    for (int line = 0; line < height; ++line)
+        std::memcpy(source.planes[0] + line * source.stride[0], packed.data() + 1 + line * width * 4, width * 4);
+
+    // offset by one byte so the unaligned kernels are used.
+    const unsigned char *src_unaligned[3] = {packed.data() + 1, nullptr, nullptr};
+    const int src_unaligned_stride[3] = {width * 4, 0, 0};
+    unsigned char *dst_unaligned[3] = {expected.data() + 1, expected.data() + 1 + width * height,
+        expected.data() + 1 + width * height + chroma_width * chroma_height};
+    const int dst_unaligned_stride[3] = {width, chroma_width, chroma_width};
+    yuvconvert::bgra_to_420(dst_unaligned, dst_unaligned_stride, src_unaligned, width, height,
+        src_unaligned_stride, yuvconvert::simd_mode::ssse3);
+
+    const unsigned char *src[3] = {source.planes[0], nullptr, nullptr};
+    unsigned char *dst[3] = {result.planes[0], result.planes[1], result.planes[2]};
+    yuvconvert::bgra_to_420(dst, result.stride, src, width, height, source.stride, yuvconvert::simd_mode::ssse3);
+
+    for (int plane = 0; plane < 3; ++plane)
+    {
+        const auto plane_width = plane ? chroma_width : width;
+        const auto plane_height = plane ? chroma_height : height;
+        for (int line = 0; line < plane_height; ++line)
+        {
+            ASSERT_EQ(std::memcmp(dst[plane] + line * result.stride[plane],
+                dst_unaligned[plane] + line * dst_unaligned_stride[plane], plane_width), 0)
+                << "plane " << plane << " line " << line;
+        }
+    }
+}
@@ -0,0 +1,108 @@
+/* Copyright(c) 2018 Steven Hoving
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <gtest/gtest.h>
+#include <yuvconvert.h>
+#include "test_frame.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+TEST(test_gray, luma_only_matches_420)
+{
+    for (const auto pixel_width : {3, 4})
+    {
+        for (const auto width : {1, 15, 16, 67, 640})
+        {
+            constexpr auto height = 9;
+            const auto chroma_width = (width + 1) >> 1;
+            const auto source = random_bytes(width * pixel_width * height, width);
+            const unsigned char *src[3] = {source.data(), nullptr, nullptr};
+            const int src_stride[3] = {width * pixel_width, 0, 0};
+
+            std::vector<uint8_t> yuv(width * height + chroma_width * 5 * 2);
+            unsigned char *planes[3] = {yuv.data(), yuv.data() + width * height, yuv.data() + width * height + chroma_width * 5};
+            const int stride[3] = {width, chroma_width, chroma_width};
+            if (pixel_width == 4)
+                yuvconvert::bgra_to_420(planes, stride, src, width, height, src_stride, yuvconvert::simd_mode::plain_c);
+            else
+                yuvconvert::bgr_to_420(planes, stride, src, width, height, src_stride, yuvconvert::simd_mode::plain_c);
+
+            for (const auto mode : {yuvconvert::simd_mode::plain_c, yuvconvert::simd_mode::ssse3})
+            {
+                // a padded destination, the padding has to stay untouched.
+                const auto dst_stride = width + 5;
+                std::vector<uint8_t> luma(dst_stride * height, 0xee);
+                if (pixel_width == 4)
+                    yuvconvert::bgra_to_y(luma.data(), dst_stride, source.data(), width * 4, width, height, mode);
+                else
+                    yuvconvert::bgr_to_y(luma.data(), dst_stride, source.data(), width * 3, width, height, mode);
+
+                for (int line = 0; line < height; ++line)
+                {
+                    const auto row = luma.begin() + line * dst_stride;
+                    EXPECT_TRUE(std::equal(row, row + width, yuv.begin() + line * width)) << "line " << line;
+                    EXPECT_TRUE(std::all_of(row + width, row + dst_stride, [](auto value) { return value == 0xee; }));
+                }
+            }
+        }
+    }
+}
+
+TEST(test_gray, gray8_to_420)
+{
+    for (const auto mode : {yuvconvert::simd_mode::plain_c, yuvconvert::simd_mode::ssse3})
+    {
+        for (const auto width : {1, 2, 31, 33, 130, 257})
+        {
+            constexpr auto height = 7;
+            const auto chroma_width = (width + 1) >> 1;
+            const auto src_stride = width + 3;
+            const auto source = random_bytes(src_stride * height, width);
+
+            // padded planes, the padding has to stay untouched.
+            const int stride[3] = {width + 7, chroma_width + 7, chroma_width + 7};
+            std::vector<uint8_t> y(stride[0] * height, 0xee);
+            std::vector<uint8_t> u(stride[1] * 4, 0xee);
+            std::vector<uint8_t> v(stride[2] * 4, 0xee);
+            unsigned char *planes[3] = {y.data(), u.data(), v.data()};
+            yuvconvert::gray8_to_420(planes, stride, source.data(), src_stride, width, height, mode);
+
+            for (int line = 0; line < height; ++line)
+            {
+                const auto row = y.begin() + line * stride[0];
+                EXPECT_TRUE(std::equal(row, row + width, source.begin() + line * src_stride));
+                EXPECT_TRUE(std::all_of(row + width, row + stride[0], [](auto value) { return value == 0xee; }));
+            }
+
+            for (const auto *plane : {&u, &v})
+            {
+                for (int line = 0; line < 4; ++line)
+                {
+                    const auto row = plane->begin() + line * stride[1];
+                    EXPECT_TRUE(std::all_of(row, row + chroma_width, [](auto value) { return value == 128; }));
+                    EXPECT_TRUE(std::all_of(row + chroma_width, row + stride[1], [](auto value) { return value == 0xee; }));
+                }
+            }
+        }
+    }
+}
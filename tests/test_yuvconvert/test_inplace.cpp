@@ -0,0 +1,78 @@
+/* Copyright(c) 2018 Steven Hoving
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <gtest/gtest.h>
+#include <yuvconvert.h>
+#include "test_frame.h"
+
+#include <cstdint>
+#include <cstring>
+#include <tuple>
+#include <vector>
+
+using inplace_param = std::tuple<yuvconvert::pixel_format, yuvconvert::simd_mode, int, int, int>;
+
+class inplace_fixture : public ::testing::TestWithParam<inplace_param>
+{
+};
+
+TEST_P(inplace_fixture, matches_out_of_place)
+{
+    const auto [format, mode, width, height, padding] = GetParam();
+    const auto pixel_width = (format == yuvconvert::pixel_format::bgra) ? 4 : 3;
+    const auto src_stride = width * pixel_width + padding;
+    const auto chroma_width = (width + 1) >> 1;
+
+    const auto source = random_bytes(src_stride * height, width * 31 + height);
+
+    frame_420 expected(width, height);
+    const unsigned char *src[3] = {source.data(), nullptr, nullptr};
+    const int src_strides[3] = {src_stride, 0, 0};
+
+    auto buffer = source;
+    unsigned char *destination[3];
+    int dst_stride[3];
+    if (format == yuvconvert::pixel_format::bgra)
+    {
+        yuvconvert::bgra_to_420(expected.planes, expected.stride, src, width, height, src_strides, yuvconvert::simd_mode::plain_c);
+        yuvconvert::bgra_to_420_inplace(buffer.data(), width, height, src_stride, destination, dst_stride, mode);
+    }
+    else
+    {
+        yuvconvert::bgr_to_420(expected.planes, expected.stride, src, width, height, src_strides, yuvconvert::simd_mode::plain_c);
+        yuvconvert::bgr_to_420_inplace(buffer.data(), width, height, src_stride, destination, dst_stride, mode);
+    }
+
+    EXPECT_EQ(destination[0], buffer.data());
+    EXPECT_EQ(destination[1], buffer.data() + width * height);
+    EXPECT_EQ(dst_stride[0], width);
+    EXPECT_EQ(dst_stride[1], chroma_width);
+    EXPECT_EQ(dst_stride[2], chroma_width);
+    EXPECT_EQ(std::memcmp(buffer.data(), expected.buffer.data(), expected.buffer.size()), 0);
+}
+
+INSTANTIATE_TEST_CASE_P(inplace_sequence, inplace_fixture,
+    ::testing::Combine(
+        ::testing::Values(yuvconvert::pixel_format::bgr, yuvconvert::pixel_format::bgra),
+        ::testing::Values(yuvconvert::simd_mode::plain_c, yuvconvert::simd_mode::ssse3),
+        ::testing::Values(1, 16, 17, 333),
+        ::testing::Values(1, 2, 3, 64, 101),
+        ::testing::Values(0, 13)));
@@ -0,0 +1,119 @@
+/* Copyright(c) 2018 Steven Hoving
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <gtest/gtest.h>
+#include <yuvconvert.h>
+#include <yuvconvert/yuvconvert_converter.h>
+#include "test_frame.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+// the reference splits the fields into two buffers, converts them as progressive frames and weaves
+// the results back together.
+TEST(test_interlaced, matches_separate_fields)
+{
+    constexpr auto width = 37;
+
+    for (const auto height : {1, 2, 3, 4, 6, 8, 9, 11, 16})
+    {
+        const auto source = random_bytes(width * height * 4, 17);
+        const auto chroma_width = (width + 1) >> 1;
+        const auto chroma_height = (height + 1) >> 1;
+
+        frame_420 expected(width, height);
+        for (int field = 0; field < 2; ++field)
+        {
+            const auto field_height = (height - field + 1) / 2;
+            if (field_height == 0)
+                continue;
+
+            std::vector<uint8_t> field_source;
+            for (int line = field; line < height; line += 2)
+                field_source.insert(field_source.end(), source.begin() + line * width * 4, source.begin() + (line + 1) * width * 4);
+
+            frame_420 field_frame(width, field_height);
+            const unsigned char *src[3] = {field_source.data(), nullptr, nullptr};
+            const int src_stride[3] = {width * 4, 0, 0};
+            yuvconvert::bgra_to_420(field_frame.planes, field_frame.stride, src, width, field_height, src_stride,
+                yuvconvert::simd_mode::plain_c);
+
+            for (int row = 0; row < field_height; ++row)
+                std::copy_n(field_frame.planes[0] + row * width, width, expected.planes[0] + (row * 2 + field) * width);
+
+            // the chroma rows of the field go to every other chroma row, as far as the frame has them.
+            for (int row = 0; row * 2 + field < chroma_height && row < (field_height + 1) / 2; ++row)
+            {
+                for (int plane = 1; plane < 3; ++plane)
+                    std::copy_n(field_frame.planes[plane] + row * chroma_width, chroma_width,
+                        expected.planes[plane] + (row * 2 + field) * chroma_width);
+            }
+        }
+
+        for (const auto mode : {yuvconvert::simd_mode::plain_c, yuvconvert::simd_mode::ssse3})
+        {
+            frame_420 result(width, height);
+            const unsigned char *src[3] = {source.data(), nullptr, nullptr};
+            const int src_stride[3] = {width * 4, 0, 0};
+            yuvconvert::bgra_to_420_interlaced(result.planes, result.stride, src, width, height, src_stride, mode);
+            EXPECT_EQ(result.buffer, expected.buffer) << "height " << height;
+
+            for (const auto band_height : {0, 2})
+            {
+                yuvconvert::converter_config config;
+                config.mode = mode;
+                config.band_height = band_height;
+                config.interlaced = true;
+                const yuvconvert::converter converter(yuvconvert::pixel_format::bgra, width, height, config);
+
+                frame_420 converted(width, height);
+                converter.convert(converted.planes, converted.stride, source.data(), width * 4);
+                EXPECT_EQ(converted.buffer, expected.buffer) << "height " << height << " band height " << band_height;
+            }
+        }
+    }
+}
+
+TEST(test_interlaced, specialized_width)
+{
+    constexpr auto width = 1920;
+    constexpr auto height = 12;
+    const auto source = random_bytes(width * height * 3, 17);
+    const unsigned char *src[3] = {source.data(), nullptr, nullptr};
+    const int src_stride[3] = {width * 3, 0, 0};
+
+    frame_420 expected(width, height);
+    yuvconvert::bgr_to_420_interlaced(expected.planes, expected.stride, src, width, height, src_stride,
+        yuvconvert::simd_mode::plain_c);
+
+    yuvconvert::converter_config config;
+    config.interlaced = true;
+    const yuvconvert::converter converter(yuvconvert::pixel_format::bgr, width, height, config);
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+    // the width specialized converters are ssse3 kernels, other targets use the generic ones.
+    EXPECT_TRUE(converter.specialized());
+#endif
+
+    frame_420 result(width, height);
+    converter.convert(result.planes, result.stride, source.data(), width * 3);
+    EXPECT_EQ(result.buffer, expected.buffer);
+}
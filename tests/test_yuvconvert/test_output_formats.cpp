@@ -0,0 +1,185 @@
+/* Copyright(c) 2018 Steven Hoving
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <gtest/gtest.h>
+#include <yuvconvert.h>
+#include <yuvconvert/yuvconvert_common.h>
+
+#include "test_utilities.h"
+#include <vector>
+#include <cstdint>
+#include <algorithm>
+
+enum class output_format
+{
+    i422,
+    i444,
+    yuy2,
+    uyvy
+};
+
+using convert_function = void(unsigned char *destination[3], const int dst_stride[3],
+    const unsigned char *const source[3], const int width, const int height, const int src_stride[3],
+    yuvconvert::simd_mode mode);
+
+struct output_frame
+{
+    output_frame(output_format format, int width, int height)
+    {
+        const auto chroma_width = (format == output_format::i444) ? width : (width + 1) >> 1;
+        if (format == output_format::yuy2 || format == output_format::uyvy)
+        {
+            stride[0] = ((width + 1) >> 1) * 4;
+            buffer.resize(stride[0] * height);
+            planes[0] = buffer.data();
+            return;
+        }
+
+        stride[0] = width;
+        stride[1] = chroma_width;
+        stride[2] = chroma_width;
+        buffer.resize((width + chroma_width * 2) * height);
+        planes[0] = buffer.data();
+        planes[1] = planes[0] + width * height;
+        planes[2] = planes[1] + chroma_width * height;
+    }
+
+    std::vector<uint8_t> buffer;
+    uint8_t *planes[3]{nullptr, nullptr, nullptr};
+    int stride[3]{0, 0, 0};
+};
+
+static std::vector<uint8_t> create_test_pattern(const int size)
+{
+    std::vector<uint8_t> result(size);
+    int color = 0;
+    for (auto &itr : result)
+        itr = (color++ * 7) % 255;
+    return result;
+}
+
+struct output_format_param
+{
+    output_format format;
+    int pixel_width;
+    int width;
+};
+
+class output_format_fixture : public testing::TestWithParam<output_format_param>
+{
+protected:
+    static convert_function *get_converter(output_format format, int pixel_width)
+    {
+        switch (format)
+        {
+        case output_format::i422: return pixel_width == 4 ? yuvconvert::bgra_to_422 : yuvconvert::bgr_to_422;
+        case output_format::i444: return pixel_width == 4 ? yuvconvert::bgra_to_444 : yuvconvert::bgr_to_444;
+        case output_format::yuy2: return pixel_width == 4 ? yuvconvert::bgra_to_yuy2 : yuvconvert::bgr_to_yuy2;
+        case output_format::uyvy: return pixel_width == 4 ? yuvconvert::bgra_to_uyvy : yuvconvert::bgr_to_uyvy;
+        }
+        return nullptr;
+    }
+};
+
+TEST_P(output_format_fixture, ssse3_matches_c)
+{
+    const auto param = GetParam();
+    const auto width = param.width;
+    const auto height = 34;
+
+    auto rgb_buffer = create_test_pattern(width * height * param.pixel_width);
+    const unsigned char *src[3] = {rgb_buffer.data(), nullptr, nullptr};
+    const int src_stride[3] = {width * param.pixel_width, 0, 0};
+
+    output_frame frame_c(param.format, width, height);
+    output_frame frame_sse(param.format, width, height);
+
+    const auto convert = get_converter(param.format, param.pixel_width);
+    convert(frame_c.planes, frame_c.stride, src, width, height, src_stride, yuvconvert::simd_mode::plain_c);
+    convert(frame_sse.planes, frame_sse.stride, src, width, height, src_stride, yuvconvert::simd_mode::ssse3);
+    EXPECT_EQ(frame_c.buffer, frame_sse.buffer);
+}
+
+INSTANTIATE_TEST_CASE_P(output_format_sequence, output_format_fixture, ::testing::ValuesIn(std::vector<output_format_param>{
+    {output_format::i422, 4, 128}, {output_format::i422, 3, 130}, {output_format::i422, 4, 66},
+    {output_format::i444, 4, 128}, {output_format::i444, 3, 130}, {output_format::i444, 4, 67},
+    {output_format::yuy2, 4, 128}, {output_format::yuy2, 3, 130}, {output_format::yuy2, 4, 67},
+    {output_format::uyvy, 4, 128}, {output_format::uyvy, 3, 130}, {output_format::uyvy, 3, 67},
+}));
+
+TEST(test_output_formats, i444_matches_reference)
+{
+    const auto width = 48;
+    const auto height = 2;
+    auto rgb_buffer = create_test_pattern(width * height * 4);
+    const unsigned char *src[3] = {rgb_buffer.data(), nullptr, nullptr};
+    const int src_stride[3] = {width * 4, 0, 0};
+
+    output_frame frame(output_format::i444, width, height);
+    yuvconvert::bgra_to_444(frame.planes, frame.stride, src, width, height, src_stride, yuvconvert::simd_mode::ssse3);
+
+    for (int i = 0; i < width * height; ++i)
+    {
+        const auto b = rgb_buffer[i * 4 + 0];
+        const auto g = rgb_buffer[i * 4 + 1];
+        const auto r = rgb_buffer[i * 4 + 2];
+        ASSERT_EQ(frame.planes[0][i], rgb2y(r, g, b));
+        ASSERT_EQ(frame.planes[1][i], rgb2u(r, g, b));
+        ASSERT_EQ(frame.planes[2][i], rgb2v(r, g, b));
+    }
+}
+
+TEST(test_output_formats, yuy2_matches_i422)
+{
+    const auto width = 80;
+    const auto height = 4;
+    auto rgb_buffer = create_test_pattern(width * height * 4);
+    const unsigned char *src[3] = {rgb_buffer.data(), nullptr, nullptr};
+    const int src_stride[3] = {width * 4, 0, 0};
+
+    output_frame planar(output_format::i422, width, height);
+    output_frame yuy2(output_format::yuy2, width, height);
+    output_frame uyvy(output_format::uyvy, width, height);
+    yuvconvert::bgra_to_422(planar.planes, planar.stride, src, width, height, src_stride, yuvconvert::simd_mode::ssse3);
+    yuvconvert::bgra_to_yuy2(yuy2.planes, yuy2.stride, src, width, height, src_stride, yuvconvert::simd_mode::ssse3);
+    yuvconvert::bgra_to_uyvy(uyvy.planes, uyvy.stride, src, width, height, src_stride, yuvconvert::simd_mode::ssse3);
+
+    for (int line = 0; line < height; ++line)
+    {
+        const auto y = planar.planes[0] + line * planar.stride[0];
+        const auto u = planar.planes[1] + line * planar.stride[1];
+        const auto v = planar.planes[2] + line * planar.stride[2];
+        const auto packed_yuy2 = yuy2.planes[0] + line * yuy2.stride[0];
+        const auto packed_uyvy = uyvy.planes[0] + line * uyvy.stride[0];
+        for (int x = 0; x < width / 2; ++x)
+        {
+            ASSERT_EQ(packed_yuy2[x * 4 + 0], y[x * 2 + 0]);
+            ASSERT_EQ(packed_yuy2[x * 4 + 1], u[x]);
+            ASSERT_EQ(packed_yuy2[x * 4 + 2], y[x * 2 + 1]);
+            ASSERT_EQ(packed_yuy2[x * 4 + 3], v[x]);
+
+            ASSERT_EQ(packed_uyvy[x * 4 + 0], u[x]);
+            ASSERT_EQ(packed_uyvy[x * 4 + 1], y[x * 2 + 0]);
+            ASSERT_EQ(packed_uyvy[x * 4 + 2], v[x]);
+            ASSERT_EQ(packed_uyvy[x * 4 + 3], y[x * 2 + 1]);
+        }
+    }
+}
@@ -0,0 +1,167 @@
+/* Copyright(c) 2018 Steven Hoving
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <gtest/gtest.h>
+#include <yuvconvert.h>
+#include <yuvconvert/yuvconvert_converter.h>
+#include "test_frame.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+// a padded i420 frame, every plane has an extra column of slack after its border that has to stay untouched.
+struct padded_frame
+{
+    padded_frame(const int width, const int height, const yuvconvert::output_padding &padding)
+    {
+        const auto alignment = std::max(1, padding.alignment);
+        border = (padding.border + 1) & ~1;
+        padded_width = (width + alignment - 1) / alignment * alignment;
+        padded_height = (height + alignment - 1) / alignment * alignment;
+
+        for (int plane = 0; plane < 3; ++plane)
+        {
+            const auto shift = plane ? 1 : 0;
+            const auto plane_border = border >> shift;
+            stride[plane] = plane_border * 2 + ((padded_width + shift) >> shift) + 1;
+            rows[plane] = plane_border * 2 + ((padded_height + shift) >> shift);
+            data[plane].assign(stride[plane] * rows[plane], 0xee);
+            planes[plane] = data[plane].data() + plane_border * stride[plane] + plane_border;
+        }
+    }
+
+    std::vector<uint8_t> data[3];
+    unsigned char *planes[3];
+    int stride[3];
+    int rows[3];
+    int border;
+    int padded_width;
+    int padded_height;
+};
+
+// the frame padded the slow way, from an exact size conversion.
+static void expect_padded(const padded_frame &frame, const std::vector<uint8_t> &yuv, const int width, const int height)
+{
+    const auto chroma_width = (width + 1) >> 1;
+    const auto chroma_height = (height + 1) >> 1;
+    const int offset[3] = {0, width * height, width * height + chroma_width * chroma_height};
+
+    for (int plane = 0; plane < 3; ++plane)
+    {
+        const auto shift = plane ? 1 : 0;
+        const auto plane_width = (width + shift) >> shift;
+        const auto plane_height = (height + shift) >> shift;
+        const auto plane_border = frame.border >> shift;
+
+        for (int row = 0; row < frame.rows[plane]; ++row)
+        {
+            const auto line = std::min(std::max(row - plane_border, 0), plane_height - 1);
+            for (int column = 0; column < frame.stride[plane]; ++column)
+            {
+                const auto x = std::min(std::max(column - plane_border, 0), plane_width - 1);
+                const auto expected = (column + 1 == frame.stride[plane]) ? 0xee : yuv[offset[plane] + line * plane_width + x];
+                ASSERT_EQ(frame.data[plane][row * frame.stride[plane] + column], expected)
+                    << "plane " << plane << " row " << row << " column " << column;
+            }
+        }
+    }
+}
+
+static std::vector<uint8_t> convert_exact(const std::vector<uint8_t> &source, const int width, const int height)
+{
+    const auto chroma_width = (width + 1) >> 1;
+    const auto chroma_height = (height + 1) >> 1;
+    std::vector<uint8_t> yuv(width * height + chroma_width * chroma_height * 2);
+    unsigned char *planes[3] = {yuv.data(), yuv.data() + width * height, yuv.data() + width * height + chroma_width * chroma_height};
+    const int stride[3] = {width, chroma_width, chroma_width};
+    const unsigned char *src[3] = {source.data(), nullptr, nullptr};
+    const int src_stride[3] = {width * 4, 0, 0};
+    yuvconvert::bgra_to_420(planes, stride, src, width, height, src_stride, yuvconvert::simd_mode::plain_c);
+    return yuv;
+}
+
+TEST(test_padding, padded_matches_convert_and_extend)
+{
+    for (const auto mode : {yuvconvert::simd_mode::plain_c, yuvconvert::simd_mode::ssse3})
+    {
+        for (const auto padding : {yuvconvert::output_padding{16, 0}, yuvconvert::output_padding{64, 0},
+                 yuvconvert::output_padding{16, 32}, yuvconvert::output_padding{1, 3}})
+        {
+            for (const auto width : {1, 15, 16, 67})
+            {
+                for (const auto height : {1, 17, 34})
+                {
+                    const auto source = random_bytes(width * height * 4, width * height);
+                    const unsigned char *src[3] = {source.data(), nullptr, nullptr};
+                    const int src_stride[3] = {width * 4, 0, 0};
+
+                    padded_frame frame(width, height, padding);
+                    yuvconvert::bgra_to_420_padded(frame.planes, frame.stride, src, width, height, src_stride, mode, padding);
+                    expect_padded(frame, convert_exact(source, width, height), width, height);
+                }
+            }
+        }
+    }
+}
+
+TEST(test_padding, converter_pads_in_bands)
+{
+    constexpr auto width = 99;
+    constexpr auto height = 70;
+    const auto source = random_bytes(width * height * 4, 7);
+    const auto expected = convert_exact(source, width, height);
+
+    for (const auto band_height : {0, 32})
+    {
+        for (const auto interlaced : {false, true})
+        {
+            yuvconvert::converter_config config{yuvconvert::simd_mode::ssse3, band_height, 0};
+            config.padded = true;
+            config.padding = {64, 16};
+            config.interlaced = interlaced;
+            yuvconvert::converter converter(yuvconvert::pixel_format::bgra, width, height, config);
+
+            padded_frame frame(width, height, config.padding);
+            converter.convert(frame.planes, frame.stride, source.data(), width * 4);
+
+            // an interlaced frame has its own chroma, only the padding is checked against it.
+            if (!interlaced)
+            {
+                expect_padded(frame, expected, width, height);
+                continue;
+            }
+
+            std::vector<uint8_t> yuv;
+            const int rows[3] = {height, (height + 1) >> 1, (height + 1) >> 1};
+            const int widths[3] = {width, (width + 1) >> 1, (width + 1) >> 1};
+            for (int plane = 0; plane < 3; ++plane)
+            {
+                for (int line = 0; line < rows[plane]; ++line)
+                {
+                    const auto row = frame.planes[plane] + line * frame.stride[plane];
+                    yuv.insert(yuv.end(), row, row + widths[plane]);
+                }
+            }
+            expect_padded(frame, yuv, width, height);
+        }
+    }
+}
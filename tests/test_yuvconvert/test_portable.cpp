@@ -0,0 +1,107 @@
+/* Copyright(c) 2018 Steven Hoving
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <gtest/gtest.h>
+#include <yuvconvert.h>
+#include <yuvconvert/yuvconvert_converter.h>
+#include "test_frame.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+// the portable kernels are checked against plain_c on the host, they are bit exact with it. Where the
+// compiler has no vector extensions the portable mode runs the c kernels and the tests pass trivially.
+
+// the widths cross the 16 pixel blocks of the kernels and their scalar tails.
+static constexpr int widths[] = {1, 2, 15, 16, 17, 31, 32, 33, 130, 257};
+static constexpr int heights[] = {1, 2, 7};
+
+// padding of the destination strides, it has to stay untouched.
+static constexpr int padding = 5;
+
+TEST(test_portable, bgrx_to_420_matches_c)
+{
+    for (const auto pixel_width : {3, 4})
+    {
+        for (const auto width : widths)
+        {
+            for (const auto height : heights)
+            {
+                const auto src_row_stride = width * pixel_width + 9;
+                const auto source = random_bytes(src_row_stride * height, width * 31 + height);
+                const unsigned char *const src[3] = {source.data(), nullptr, nullptr};
+                const int src_stride[3] = {src_row_stride, 0, 0};
+
+                const auto convert = [&](frame_420 &frame, yuvconvert::simd_mode mode) {
+                    if (pixel_width == 4)
+                        yuvconvert::bgra_to_420(frame.planes, frame.stride, src, width, height, src_stride, mode);
+                    else
+                        yuvconvert::bgr_to_420(frame.planes, frame.stride, src, width, height, src_stride, mode);
+                };
+
+                frame_420 expected(width, height, padding, 0xee);
+                frame_420 result(width, height, padding, 0xee);
+                convert(expected, yuvconvert::simd_mode::plain_c);
+                convert(result, yuvconvert::simd_mode::portable);
+                EXPECT_EQ(result.buffer, expected.buffer)
+                    << "pixel width " << pixel_width << ", " << width << "x" << height;
+            }
+        }
+    }
+}
+
+TEST(test_portable, bgra_to_y_matches_c)
+{
+    for (const auto width : widths)
+    {
+        constexpr auto height = 3;
+        const auto source = random_bytes(width * 4 * height, width);
+
+        std::vector<uint8_t> expected(width * height);
+        std::vector<uint8_t> result(width * height);
+        yuvconvert::bgra_to_y(expected.data(), width, source.data(), width * 4, width, height,
+            yuvconvert::simd_mode::plain_c);
+        yuvconvert::bgra_to_y(result.data(), width, source.data(), width * 4, width, height,
+            yuvconvert::simd_mode::portable);
+        EXPECT_EQ(result, expected) << "width " << width;
+    }
+}
+
+TEST(test_portable, converter_matches_c)
+{
+    constexpr auto width = 1920;
+    constexpr auto height = 130;
+    const auto source = random_bytes(width * 4 * height, 7);
+
+    frame_420 expected(width, height, padding, 0xee);
+    frame_420 result(width, height, padding, 0xee);
+    const yuvconvert::converter reference(yuvconvert::pixel_format::bgra, width, height,
+        {yuvconvert::simd_mode::plain_c, 0, 0});
+    const yuvconvert::converter portable(yuvconvert::pixel_format::bgra, width, height,
+        {yuvconvert::simd_mode::portable, 64, 0});
+    reference.convert(expected.planes, expected.stride, source.data(), width * 4);
+    portable.convert(result.planes, result.stride, source.data(), width * 4);
+    EXPECT_EQ(result.buffer, expected.buffer);
+
+    // the width specialized converters are x86 kernels, the portable mode never takes them.
+    EXPECT_FALSE(portable.specialized());
+}
@@ -0,0 +1,170 @@
+/* Copyright(c) 2018 Steven Hoving
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <gtest/gtest.h>
+#include <yuvconvert.h>
+#include <yuvconvert/yuvconvert_common.h>
+#include <yuvconvert/yuvconvert_converter.h>
+#include "test_frame.h"
+
+#include <cstdint>
+#include <cstdlib>
+#include <vector>
+
+namespace
+{
+void convert(yuvconvert::pixel_format format, frame_420 &frame, const std::vector<uint8_t> &source,
+    const int width, const int height, yuvconvert::simd_mode mode, yuvconvert::conversion_precision precision)
+{
+    const auto pixel_width = (format == yuvconvert::pixel_format::bgra) ? 4 : 3;
+    const unsigned char *src[3] = {source.data(), nullptr, nullptr};
+    const int src_stride[3] = {width * pixel_width, 0, 0};
+    if (format == yuvconvert::pixel_format::bgra)
+        yuvconvert::bgra_to_420(frame.planes, frame.stride, src, width, height, src_stride, mode, precision);
+    else
+        yuvconvert::bgr_to_420(frame.planes, frame.stride, src, width, height, src_stride, mode, precision);
+}
+} // namespace
+
+TEST(test_precision, plain_c_is_the_exact_matrix)
+{
+    constexpr auto width = 37;
+    constexpr auto height = 5;
+    const auto source = random_bytes(width * height * 4, 11);
+
+    frame_420 result(width, height);
+    convert(yuvconvert::pixel_format::bgra, result, source, width, height, yuvconvert::simd_mode::plain_c,
+        yuvconvert::conversion_precision::floating_point);
+
+    for (int line = 0; line < height; ++line)
+    {
+        for (int x = 0; x < width; ++x)
+        {
+            const auto pixel = source.data() + (line * width + x) * 4;
+            EXPECT_EQ(result.planes[0][line * width + x], rgbconvert<floating_point>::to_y(pixel[2], pixel[1], pixel[0]));
+            if ((line & 1) == 0 && (x & 1) == 0)
+            {
+                const auto chroma = (line >> 1) * result.stride[1] + (x >> 1);
+                EXPECT_EQ(result.planes[1][chroma], rgbconvert<floating_point>::to_u(pixel[2], pixel[1], pixel[0]));
+                EXPECT_EQ(result.planes[2][chroma], rgbconvert<floating_point>::to_v(pixel[2], pixel[1], pixel[0]));
+            }
+        }
+    }
+}
+
+TEST(test_precision, simd_matches_plain_c)
+{
+    constexpr auto height = 7;
+
+    for (const auto format : {yuvconvert::pixel_format::bgr, yuvconvert::pixel_format::bgra})
+    {
+        for (const auto width : {1, 7, 8, 9, 33, 640})
+        {
+            const auto pixel_width = (format == yuvconvert::pixel_format::bgra) ? 4 : 3;
+            const auto source = random_bytes(width * height * pixel_width, 11);
+
+            frame_420 expected(width, height);
+            convert(format, expected, source, width, height, yuvconvert::simd_mode::plain_c,
+                yuvconvert::conversion_precision::floating_point);
+
+            for (const auto mode : {yuvconvert::simd_mode::ssse3, yuvconvert::simd_mode::avx2})
+            {
+                frame_420 result(width, height);
+                convert(format, result, source, width, height, mode, yuvconvert::conversion_precision::floating_point);
+
+                EXPECT_EQ(result.buffer, expected.buffer) << "width " << width;
+            }
+        }
+    }
+}
+
+// every rgb value, as 2x2 blocks of one color so the chroma of every value is computed as well.
+TEST(test_precision, simd_is_exact_for_every_color)
+{
+    constexpr auto width = 512;
+    constexpr auto height = 512;
+
+    std::vector<uint8_t> source(width * height * 4);
+    for (int r = 0; r < 256; ++r)
+    {
+        for (int line = 0; line < height; ++line)
+        {
+            for (int x = 0; x < width; ++x)
+            {
+                auto pixel = source.data() + (line * width + x) * 4;
+                pixel[0] = static_cast<uint8_t>(line >> 1);
+                pixel[1] = static_cast<uint8_t>(x >> 1);
+                pixel[2] = static_cast<uint8_t>(r);
+                pixel[3] = 0xff;
+            }
+        }
+
+        frame_420 expected(width, height);
+        convert(yuvconvert::pixel_format::bgra, expected, source, width, height, yuvconvert::simd_mode::plain_c,
+            yuvconvert::conversion_precision::floating_point);
+
+        for (const auto mode : {yuvconvert::simd_mode::ssse3, yuvconvert::simd_mode::avx2})
+        {
+            frame_420 result(width, height);
+            convert(yuvconvert::pixel_format::bgra, result, source, width, height, mode,
+                yuvconvert::conversion_precision::floating_point);
+            ASSERT_EQ(result.buffer, expected.buffer) << "red " << r;
+        }
+    }
+}
+
+TEST(test_precision, fixed_point_is_within_one)
+{
+    constexpr auto width = 200;
+    constexpr auto height = 50;
+    const auto source = random_bytes(width * height * 4, 11);
+
+    frame_420 fixed(width, height);
+    frame_420 floating(width, height);
+    convert(yuvconvert::pixel_format::bgra, fixed, source, width, height, yuvconvert::simd_mode::ssse3,
+        yuvconvert::conversion_precision::fixed_point);
+    convert(yuvconvert::pixel_format::bgra, floating, source, width, height, yuvconvert::simd_mode::ssse3,
+        yuvconvert::conversion_precision::floating_point);
+
+    for (std::size_t i = 0; i < fixed.buffer.size(); ++i)
+        EXPECT_LE(std::abs(fixed.buffer[i] - floating.buffer[i]), 1);
+}
+
+TEST(test_precision, converter)
+{
+    constexpr auto width = 1920;
+    constexpr auto height = 6;
+    const auto source = random_bytes(width * height * 3, 11);
+
+    frame_420 expected(width, height);
+    convert(yuvconvert::pixel_format::bgr, expected, source, width, height, yuvconvert::simd_mode::ssse3,
+        yuvconvert::conversion_precision::floating_point);
+
+    yuvconvert::converter_config config;
+    config.band_height = 2;
+    config.precision = yuvconvert::conversion_precision::floating_point;
+    const yuvconvert::converter converter(yuvconvert::pixel_format::bgr, width, height, config);
+    EXPECT_FALSE(converter.specialized());
+
+    frame_420 result(width, height);
+    converter.convert(result.planes, result.stride, source.data(), width * 3);
+    EXPECT_EQ(result.buffer, expected.buffer);
+}
@@ -0,0 +1,114 @@
+/* Copyright(c) 2018 Steven Hoving
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <gtest/gtest.h>
+#include <yuvconvert.h>
+#include <yuvconvert/yuvconvert_common.h>
+#include "test_frame.h"
+
+#include <cstdint>
+#include <cstdlib>
+#include <vector>
+
+namespace
+{
+// straight bgra pixels and the same pixels premultiplied, every 16th pixel is fully transparent.
+void create_sources(const int pixel_count, std::vector<uint8_t> &straight, std::vector<uint8_t> &premultiplied)
+{
+    straight = random_bytes(pixel_count * 4, 5);
+    premultiplied.resize(pixel_count * 4);
+    for (int i = 0; i < pixel_count; ++i)
+    {
+        const auto alpha = (i % 16 == 0) ? 0 : straight[i * 4 + 3];
+        for (int channel = 0; channel < 3; ++channel)
+        {
+            const auto value = straight[i * 4 + channel];
+            if (alpha == 0)
+                straight[i * 4 + channel] = 0;
+            premultiplied[i * 4 + channel] = static_cast<uint8_t>((value * alpha + 127) / 255);
+        }
+        straight[i * 4 + 3] = static_cast<uint8_t>(alpha);
+        premultiplied[i * 4 + 3] = static_cast<uint8_t>(alpha);
+    }
+}
+} // namespace
+
+TEST(test_premultiplied, unpremultiply)
+{
+    for (int alpha = 0; alpha < 256; ++alpha)
+    {
+        for (int value = 0; value <= alpha; ++value)
+        {
+            const auto expected = alpha ? (value * 255 + alpha / 2) / alpha : 0;
+            EXPECT_LE(std::abs(unpremultiply(static_cast<uint8_t>(value), static_cast<uint8_t>(alpha)) - expected), 1);
+        }
+    }
+
+    // invalid input, a color above alpha, saturates.
+    EXPECT_EQ(unpremultiply(200, 100), 255);
+}
+
+TEST(test_premultiplied, matches_straight_alpha)
+{
+    for (const auto width : {1, 15, 16, 17, 70})
+    {
+        constexpr auto height = 5;
+        std::vector<uint8_t> straight;
+        std::vector<uint8_t> premultiplied;
+        create_sources(width * height, straight, premultiplied);
+        const int src_stride[3] = {width * 4, 0, 0};
+
+        // the straight colors can only be recovered to within the precision of the premultiplied
+        // values, that is only exact for an alpha of 255. So compare against premultiplied pixels
+        // that are un-premultiplied up front.
+        std::vector<uint8_t> recovered(premultiplied);
+        for (int i = 0; i < width * height; ++i)
+        {
+            for (int channel = 0; channel < 3; ++channel)
+                recovered[i * 4 + channel] = unpremultiply(premultiplied[i * 4 + channel], premultiplied[i * 4 + 3]);
+        }
+
+        frame_420 expected(width, height);
+        const unsigned char *recovered_source[3] = {recovered.data(), nullptr, nullptr};
+        yuvconvert::bgra_to_420(expected.planes, expected.stride, recovered_source, width, height, src_stride,
+            yuvconvert::simd_mode::plain_c);
+
+        for (const auto mode : {yuvconvert::simd_mode::plain_c, yuvconvert::simd_mode::ssse3})
+        {
+            frame_420 result(width, height);
+            const unsigned char *source[3] = {premultiplied.data(), nullptr, nullptr};
+            yuvconvert::bgra_premultiplied_to_420(result.planes, result.stride, source, width, height, src_stride, mode);
+            EXPECT_EQ(result.buffer, expected.buffer) << "width " << width;
+        }
+
+        // an opaque frame is the same as straight bgra.
+        for (int i = 0; i < width * height; ++i)
+            straight[i * 4 + 3] = 255;
+        frame_420 opaque_expected(width, height);
+        frame_420 opaque(width, height);
+        const unsigned char *opaque_source[3] = {straight.data(), nullptr, nullptr};
+        yuvconvert::bgra_to_420(opaque_expected.planes, opaque_expected.stride, opaque_source, width, height,
+            src_stride, yuvconvert::simd_mode::ssse3);
+        yuvconvert::bgra_premultiplied_to_420(opaque.planes, opaque.stride, opaque_source, width, height,
+            src_stride, yuvconvert::simd_mode::ssse3);
+        EXPECT_EQ(opaque.buffer, opaque_expected.buffer);
+    }
+}
@@ -22,7 +22,9 @@
 #include <gtest/gtest.h>
 #include <yuvconvert.h>
 #include <yuvconvert/yuvconvert_common.h>
+#include <yuvconvert/yuvconvert_metrics.h>
 #include "test_utilities.h"
+#include "test_frame.h"
 #include <fmt/printf.h>
 #include <vector>
 #include <cstdint>
@@ -152,54 +154,6 @@ void yuv420_to_rgb(std::array<uint8_t*, 8> source, std::array<int, 3> source_str
     }
 }
 
-static uint32_t SumSquareError_C(const uint8_t* src_a,
-    const uint8_t* src_b,
-    int count) {
-    uint32_t sse = 0u;
-    for (int x = 0; x < count; ++x) {
-        int diff = src_a[x] - src_b[x];
-        sse += static_cast<uint32_t>(diff * diff);
-    }
-    return sse;
-}
-
-double ComputeSumSquareError(const uint8_t* src_a, const uint8_t* src_b, int count)
-{
-    uint32_t(*SumSquareError)(const uint8_t* src_a, const uint8_t* src_b, int count) =
-        SumSquareError_C;
-
-    const int kBlockSize = 1 << 15;
-    uint64_t sse = 0;
-
-    for (int i = 0; i < (count - (kBlockSize - 1)); i += kBlockSize) {
-        sse += SumSquareError(src_a + i, src_b + i, kBlockSize);
-    }
-    src_a += count & ~(kBlockSize - 1);
-    src_b += count & ~(kBlockSize - 1);
-    int remainder = count & (kBlockSize - 1) & ~15;
-    if (remainder) {
-        sse += SumSquareError(src_a, src_b, remainder);
-        src_a += remainder;
-        src_b += remainder;
-    }
-    remainder = count & 15;
-    if (remainder) {
-        sse += SumSquareError_C(src_a, src_b, remainder);
-    }
-    return static_cast<double>(sse);
-}
-
-static const double kMaxPSNR = 128.0;
-
-// PSNR formula: psnr = 10 * log10 (Peak Signal^2 * size / sse)
-// Returns 128.0 (kMaxPSNR) if sse is 0 (perfect match).
-double ComputePSNR(double sse, double size) {
-    const double kMINSSE = 255.0 * 255.0 * size / pow(10.0, kMaxPSNR / 10.0);
-    if (sse <= kMINSSE)
-        sse = kMINSSE;  // Produces max PSNR of 128
-    return 10.0 * log10(255.0 * 255.0 * size / sse);
-}
-
 #if 0
 TEST(test_quality, psnr)
 {
@@ -267,12 +221,94 @@ TEST(test_quality, psnr)
         *dst_b++ = pixel.r;
 
 
-    const auto sse_a = ComputeSumSquareError(source_rgba, (uint8_t*)red_a.data(), (int)red_a.size());
-    const auto psnr_a = ComputePSNR(sse_a, (int)rgb_a.size());
+    const auto sse_a = yuvconvert::plane_sse(source_rgba, 0, red_a.data(), 0, (int)red_a.size(), 1, yuvconvert::simd_mode::ssse3);
+    const auto psnr_a = yuvconvert::psnr(sse_a, rgb_a.size());
     fmt::print("psnr a: {}  sse: {}\n", psnr_a, sse_a);
 
-    const auto sse_b = ComputeSumSquareError(source_rgba, (uint8_t*)red_b.data(), (int)red_b.size());
-    const auto psnr_b = ComputePSNR(sse_b, (int)rgb_b.size());
+    const auto sse_b = yuvconvert::plane_sse(source_rgba, 0, red_b.data(), 0, (int)red_b.size(), 1, yuvconvert::simd_mode::ssse3);
+    const auto psnr_b = yuvconvert::psnr(sse_b, rgb_b.size());
     fmt::print("psnr b: {} sse: {}\n", psnr_b, sse_b);
 }
 #endif
+
+static std::vector<uint8_t> create_gradient_bgra(const int width, const int height)
+{
+    std::vector<uint8_t> result(width * height * 4);
+    for (int line = 0; line < height; ++line)
+    {
+        for (int x = 0; x < width; ++x)
+        {
+            auto pixel = &result[(line * width + x) * 4];
+            pixel[0] = static_cast<uint8_t>(x * 255 / width);
+            pixel[1] = static_cast<uint8_t>(line * 255 / height);
+            pixel[2] = static_cast<uint8_t>((x + line) * 127 / (width + height));
+            pixel[3] = 255;
+        }
+    }
+    return result;
+}
+
+TEST(test_quality, plane_sse_simd_matches_c)
+{
+    const auto width = 333;
+    const auto height = 130;
+    const auto a = random_bytes(width * height, 1);
+    const auto b = random_bytes(width * height, 2);
+
+    const auto sse_c = yuvconvert::plane_sse(a.data(), width, b.data(), width, width, height, yuvconvert::simd_mode::plain_c);
+    const auto sse_ssse3 = yuvconvert::plane_sse(a.data(), width, b.data(), width, width, height, yuvconvert::simd_mode::ssse3);
+    const auto sse_avx2 = yuvconvert::plane_sse(a.data(), width, b.data(), width, width, height, yuvconvert::simd_mode::avx2);
+    EXPECT_GT(sse_c, 0u);
+    EXPECT_EQ(sse_c, sse_ssse3);
+    EXPECT_EQ(sse_c, sse_avx2);
+}
+
+TEST(test_quality, plane_ssim_simd_matches_c)
+{
+    const auto width = 100;
+    const auto height = 70;
+    const auto a = random_bytes(width * height, 3);
+    auto b = a;
+    for (std::size_t i = 0; i < b.size(); i += 3)
+        b[i] = static_cast<uint8_t>(b[i] ^ 0x10);
+
+    const auto ssim_c = yuvconvert::plane_ssim(a.data(), width, b.data(), width, width, height, yuvconvert::simd_mode::plain_c);
+    const auto ssim_ssse3 = yuvconvert::plane_ssim(a.data(), width, b.data(), width, width, height, yuvconvert::simd_mode::ssse3);
+    EXPECT_DOUBLE_EQ(ssim_c, ssim_ssse3);
+    EXPECT_LT(ssim_c, 1.0);
+    EXPECT_GT(ssim_c, 0.5);
+
+    const auto ssim_same = yuvconvert::plane_ssim(a.data(), width, a.data(), width, width, height, yuvconvert::simd_mode::ssse3);
+    EXPECT_DOUBLE_EQ(ssim_same, 1.0);
+}
+
+TEST(test_quality, psnr_limits)
+{
+    EXPECT_DOUBLE_EQ(yuvconvert::psnr(0, 1000), yuvconvert::max_psnr);
+    // an error of 1 on every sample.
+    EXPECT_NEAR(yuvconvert::psnr(1000, 1000), 48.1308, 0.0001);
+}
+
+TEST(test_quality, compare_420)
+{
+    const auto width = 96;
+    const auto height = 64;
+    const auto source = create_gradient_bgra(width, height);
+
+    yuv420 yuv(const_cast<uint8_t *>(source.data()), width, height);
+    yuvconvert::bgra_to_420(yuv.destination().data(), yuv.destination_stride().data(), yuv.source().data(),
+        width, height, yuv.source_stride().data(), yuvconvert::simd_mode::ssse3);
+
+    const unsigned char *const planes[3] = {yuv.destination()[0], yuv.destination()[1], yuv.destination()[2]};
+    const auto same = yuvconvert::compare_420(planes, yuv.destination_stride().data(), planes,
+        yuv.destination_stride().data(), width, height, yuvconvert::simd_mode::ssse3);
+    EXPECT_EQ(same.sse[0], 0u);
+    EXPECT_DOUBLE_EQ(same.psnr_all, yuvconvert::max_psnr);
+    EXPECT_DOUBLE_EQ(same.ssim_all, 1.0);
+
+    const unsigned char *const source_planes[3] = {source.data(), nullptr, nullptr};
+    const auto round_trip = yuvconvert::compare_bgra_to_420(source_planes, yuv.source_stride().data(), planes,
+        yuv.destination_stride().data(), width, height, yuvconvert::simd_mode::ssse3);
+    EXPECT_GT(round_trip.psnr_all, 30.0);
+    EXPECT_GT(round_trip.ssim_all, 0.9);
+}
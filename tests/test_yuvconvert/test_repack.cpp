@@ -0,0 +1,162 @@
+/* Copyright(c) 2018 Steven Hoving
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <gtest/gtest.h>
+#include <yuvconvert.h>
+#include "test_frame.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+static constexpr yuvconvert::simd_mode all_modes[] = {
+    yuvconvert::simd_mode::plain_c, yuvconvert::simd_mode::ssse3, yuvconvert::simd_mode::avx2};
+
+// the sizes cross the 16 and 32 pair blocks of the kernels and the 64 row bands of the pool.
+static constexpr int widths[] = {1, 2, 31, 33, 64, 65, 130, 257};
+static constexpr int heights[] = {1, 7, 130};
+
+TEST(test_repack, copy_plane)
+{
+    for (const auto mode : all_modes)
+    {
+        for (const auto width : widths)
+        {
+            constexpr auto height = 130;
+            const auto src_stride = width + 3;
+            const auto dst_stride = width + 7;
+            const auto source = random_bytes(src_stride * height, width);
+
+            // the padding has to stay untouched.
+            std::vector<uint8_t> destination(dst_stride * height, 0xee);
+            yuvconvert::copy_plane(destination.data(), dst_stride, source.data(), src_stride, width, height, mode);
+
+            for (int line = 0; line < height; ++line)
+            {
+                const auto row = destination.begin() + line * dst_stride;
+                EXPECT_TRUE(std::equal(row, row + width, source.begin() + line * src_stride)) << "line " << line;
+                EXPECT_TRUE(std::all_of(row + width, row + dst_stride, [](auto value) { return value == 0xee; }));
+            }
+        }
+    }
+}
+
+TEST(test_repack, i420_nv12_nv21_round_trip)
+{
+    for (const auto mode : all_modes)
+    {
+        for (const auto width : widths)
+        {
+            for (const auto height : heights)
+            {
+                const auto chroma_width = (width + 1) >> 1;
+                const auto chroma_height = (height + 1) >> 1;
+                const int stride[3] = {width + 3, chroma_width + 5, chroma_width + 1};
+                const auto y = random_bytes(stride[0] * height, width);
+                const auto u = random_bytes(stride[1] * chroma_height, width + 1);
+                const auto v = random_bytes(stride[2] * chroma_height, width + 2);
+                const unsigned char *const i420[3] = {y.data(), u.data(), v.data()};
+
+                // padded semi planar frames.
+                const int nv_stride[2] = {width + 9, chroma_width * 2 + 6};
+                std::vector<uint8_t> nv12_y(nv_stride[0] * height, 0xee);
+                std::vector<uint8_t> nv12_uv(nv_stride[1] * chroma_height, 0xee);
+                std::vector<uint8_t> nv21_y(nv_stride[0] * height, 0xee);
+                std::vector<uint8_t> nv21_vu(nv_stride[1] * chroma_height, 0xee);
+                unsigned char *nv12[2] = {nv12_y.data(), nv12_uv.data()};
+                unsigned char *nv21[2] = {nv21_y.data(), nv21_vu.data()};
+                yuvconvert::i420_to_nv12(nv12, nv_stride, i420, stride, width, height, mode);
+                yuvconvert::i420_to_nv21(nv21, nv_stride, i420, stride, width, height, mode);
+
+                for (int line = 0; line < chroma_height; ++line)
+                {
+                    const auto uv = nv12_uv.begin() + line * nv_stride[1];
+                    const auto vu = nv21_vu.begin() + line * nv_stride[1];
+                    for (int x = 0; x < chroma_width; ++x)
+                    {
+                        ASSERT_EQ(uv[x * 2 + 0], u[line * stride[1] + x]);
+                        ASSERT_EQ(uv[x * 2 + 1], v[line * stride[2] + x]);
+                        ASSERT_EQ(vu[x * 2 + 0], v[line * stride[2] + x]);
+                        ASSERT_EQ(vu[x * 2 + 1], u[line * stride[1] + x]);
+                    }
+                    EXPECT_TRUE(std::all_of(uv + chroma_width * 2, uv + nv_stride[1], [](auto value) { return value == 0xee; }));
+                }
+
+                for (int line = 0; line < height; ++line)
+                {
+                    const auto row = nv12_y.begin() + line * nv_stride[0];
+                    EXPECT_TRUE(std::equal(row, row + width, y.begin() + line * stride[0]));
+                    EXPECT_TRUE(std::all_of(row + width, row + nv_stride[0], [](auto value) { return value == 0xee; }));
+                }
+
+                // swapping nv12 in place gives nv21.
+                yuvconvert::nv12_to_nv21(nv12, nv_stride, nv12, nv_stride, width, height, mode);
+                EXPECT_EQ(nv12_uv, nv21_vu);
+
+                // and both go back to the original i420 frame.
+                std::vector<uint8_t> out_y(stride[0] * height, 0xee);
+                std::vector<uint8_t> out_u(stride[1] * chroma_height, 0xee);
+                std::vector<uint8_t> out_v(stride[2] * chroma_height, 0xee);
+                unsigned char *out[3] = {out_y.data(), out_u.data(), out_v.data()};
+                const unsigned char *const nv21_source[2] = {nv21_y.data(), nv21_vu.data()};
+                yuvconvert::nv21_to_i420(out, stride, nv21_source, nv_stride, width, height, mode);
+
+                for (int line = 0; line < chroma_height; ++line)
+                {
+                    EXPECT_TRUE(std::equal(out_u.begin() + line * stride[1], out_u.begin() + line * stride[1] + chroma_width,
+                        u.begin() + line * stride[1]));
+                    EXPECT_TRUE(std::equal(out_v.begin() + line * stride[2], out_v.begin() + line * stride[2] + chroma_width,
+                        v.begin() + line * stride[2]));
+                }
+                for (int line = 0; line < height; ++line)
+                {
+                    EXPECT_TRUE(std::equal(out_y.begin() + line * stride[0], out_y.begin() + line * stride[0] + width,
+                        y.begin() + line * stride[0]));
+                }
+            }
+        }
+    }
+}
+
+TEST(test_repack, i420_to_yv12)
+{
+    for (const auto mode : all_modes)
+    {
+        constexpr auto width = 67;
+        constexpr auto height = 9;
+        constexpr auto chroma_width = (width + 1) >> 1;
+        constexpr auto chroma_height = (height + 1) >> 1;
+        const int stride[3] = {width, chroma_width, chroma_width};
+        const auto y = random_bytes(width * height, 1);
+        const auto u = random_bytes(chroma_width * chroma_height, 2);
+        const auto v = random_bytes(chroma_width * chroma_height, 3);
+        const unsigned char *const i420[3] = {y.data(), u.data(), v.data()};
+
+        std::vector<uint8_t> frame(width * height + chroma_width * chroma_height * 2);
+        unsigned char *yv12[3] = {frame.data(), frame.data() + width * height,
+            frame.data() + width * height + chroma_width * chroma_height};
+        yuvconvert::i420_to_yv12(yv12, stride, i420, stride, width, height, mode);
+
+        EXPECT_TRUE(std::equal(y.begin(), y.end(), frame.begin()));
+        EXPECT_TRUE(std::equal(v.begin(), v.end(), frame.begin() + width * height));
+        EXPECT_TRUE(std::equal(u.begin(), u.end(), frame.begin() + width * height + chroma_width * chroma_height));
+    }
+}
@@ -0,0 +1,187 @@
+/* Copyright(c) 2018 Steven Hoving
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <gtest/gtest.h>
+#include <yuvconvert.h>
+#include <yuvconvert/yuvconvert_y4m.h>
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+constexpr auto y4m_width = 37;
+constexpr auto y4m_height = 21;
+constexpr auto y4m_chroma_width = 19;
+constexpr auto y4m_chroma_height = 11;
+
+// an i420 frame with padded rows, filled with a pattern that depends on the frame index.
+struct padded_frame
+{
+    explicit padded_frame(int index)
+        : buffer(stride[0] * y4m_height + stride[1] * y4m_chroma_height * 2)
+    {
+        for (size_t i = 0; i < buffer.size(); ++i)
+            buffer[i] = static_cast<uint8_t>(i * 7 + index * 13);
+
+        planes[0] = buffer.data();
+        planes[1] = planes[0] + stride[0] * y4m_height;
+        planes[2] = planes[1] + stride[1] * y4m_chroma_height;
+    }
+
+    bool matches(const yuvconvert::y4m_frame_view &view) const
+    {
+        const int widths[3] = {y4m_width, y4m_chroma_width, y4m_chroma_width};
+        const int heights[3] = {y4m_height, y4m_chroma_height, y4m_chroma_height};
+        for (int plane = 0; plane < 3; ++plane)
+        {
+            for (int row = 0; row < heights[plane]; ++row)
+            {
+                if (std::memcmp(planes[plane] + row * stride[plane], view.planes[plane] + row * view.stride[plane],
+                    widths[plane]) != 0)
+                    return false;
+            }
+        }
+        return true;
+    }
+
+    int stride[3]{48, 32, 32};
+    std::vector<uint8_t> buffer;
+    const unsigned char *planes[3]{nullptr, nullptr, nullptr};
+};
+
+static std::string temp_path(const char *name)
+{
+    return ::testing::TempDir() + name;
+}
+
+TEST(test_y4m, round_trip)
+{
+    const auto path = temp_path("yuvconvert_round_trip.y4m");
+
+    yuvconvert::y4m_header header;
+    header.width = y4m_width;
+    header.height = y4m_height;
+    header.fps_numerator = 25;
+    header.fps_denominator = 1;
+
+    std::vector<padded_frame> frames;
+    for (int i = 0; i < 5; ++i)
+        frames.emplace_back(i);
+
+    {
+        yuvconvert::y4m_writer writer(path, header);
+        for (const auto &frame : frames)
+            writer.write(frame.planes, frame.stride);
+    }
+
+    for (const auto mode : {yuvconvert::y4m_read_mode::mmap, yuvconvert::y4m_read_mode::stream})
+    {
+        yuvconvert::y4m_reader reader(path, mode, 2);
+        EXPECT_EQ(reader.header().width, y4m_width);
+        EXPECT_EQ(reader.header().height, y4m_height);
+        EXPECT_EQ(reader.header().fps_numerator, 25);
+        EXPECT_EQ(reader.header().colorspace, "420jpeg");
+        EXPECT_EQ(reader.frame_size(), static_cast<size_t>(y4m_width * y4m_height + y4m_chroma_width * y4m_chroma_height * 2));
+
+        // with a ring of 2, the previous view is still valid after reading the next one.
+        yuvconvert::y4m_frame_view previous;
+        yuvconvert::y4m_frame_view view;
+        size_t count = 0;
+        while (reader.next(view))
+        {
+            EXPECT_EQ(view.index, count);
+            EXPECT_TRUE(frames[count].matches(view));
+            if (count > 0)
+            {
+                EXPECT_TRUE(frames[count - 1].matches(previous));
+            }
+            previous = view;
+            ++count;
+        }
+        EXPECT_EQ(count, frames.size());
+    }
+
+    std::remove(path.c_str());
+}
+
+TEST(test_y4m, parameters_and_truncation)
+{
+    const auto path = temp_path("yuvconvert_parameters.y4m");
+    const auto frame_size = 4 * 2 + 2 * 1 * 2;
+    {
+        std::ofstream file(path, std::ios::binary);
+        file << "YUV4MPEG2 W4 H2 F30000:1001 It A1:1 C420mpeg2 XYSCSS=420MPEG2\n";
+        file << "FRAME Ib XCOMMENT=1\n" << std::string(frame_size, 'a');
+        file << "FRAME\n" << std::string(frame_size, 'b');
+        file << "FRAME\n" << std::string(frame_size - 1, 'c');
+    }
+
+    for (const auto mode : {yuvconvert::y4m_read_mode::mmap, yuvconvert::y4m_read_mode::stream})
+    {
+        yuvconvert::y4m_reader reader(path, mode);
+        EXPECT_EQ(reader.header().fps_numerator, 30000);
+        EXPECT_EQ(reader.header().fps_denominator, 1001);
+        EXPECT_EQ(reader.header().interlace, 't');
+        EXPECT_EQ(reader.header().colorspace, "420mpeg2");
+
+        yuvconvert::y4m_frame_view view;
+        ASSERT_TRUE(reader.next(view));
+        EXPECT_EQ(view.planes[0][0], 'a');
+        EXPECT_EQ(view.planes[2][1], 'a');
+        ASSERT_TRUE(reader.next(view));
+        EXPECT_EQ(view.planes[1][0], 'b');
+
+        // the truncated last frame ends the stream.
+        EXPECT_FALSE(reader.next(view));
+    }
+
+    std::remove(path.c_str());
+}
+
+TEST(test_y4m, invalid_stream)
+{
+    const auto path = temp_path("yuvconvert_invalid.y4m");
+    {
+        std::ofstream file(path, std::ios::binary);
+        file << "RIFF W4 H2\n";
+    }
+
+    EXPECT_THROW(yuvconvert::y4m_reader reader(path), std::runtime_error);
+    EXPECT_THROW(yuvconvert::y4m_reader reader(temp_path("yuvconvert_missing.y4m")), std::runtime_error);
+    std::remove(path.c_str());
+}
+
+TEST(test_y4m, unsupported_colorspace)
+{
+    // 10 bit 4:2:0 starts with a supported tag, but has 16 bit samples.
+    const auto path = temp_path("yuvconvert_420p10.y4m");
+    {
+        std::ofstream file(path, std::ios::binary);
+        file << "YUV4MPEG2 W4 H2 F25:1 C420p10\nFRAME\n" << std::string(24, '\0');
+    }
+
+    EXPECT_THROW(yuvconvert::y4m_reader reader(path), std::runtime_error);
+    std::remove(path.c_str());
+}